@@ -0,0 +1,51 @@
+#!/bin/sh
+# LTEmC footprint report: compiles each LTEmC module and reports its flash and static RAM use.
+#
+# Usage: extras/footprint.sh [-c <compiler>] [-s <size tool>] [compiler options: -I<dir> -D<name>=<value> -mcpu=...]
+#   -c    compiler, default arm-none-eabi-gcc
+#   -s    size tool, default <compiler prefix>size
+#
+# The LooUQ-Common (lq-types.h, lq-diagnostics.h, lq-cBuffer.h, lq-platform.h) include path must be supplied with -I.
+# Module selection and buffer sizing macros (ltemc-config.h) may be supplied with -D to compare configurations:
+#
+#   extras/footprint.sh -I../LooUQ-Common/src -mcpu=cortex-m0plus -mthumb -DLTEMC_ENABLE_MQTT=0 -DLTEMC_ENABLE_HTTP=0
+#
+# Sizes are per object file (-Os, function/data sections), the final link discards unreferenced functions so the linked
+# size of a module is at most its reported size. Heap allocated at ltem_create() (IOP rx/tx buffers) is not included.
+
+CC=arm-none-eabi-gcc
+SIZE=
+while [ $# -gt 1 ]; do
+    case $1 in
+        -c) CC=$2; shift 2 ;;
+        -s) SIZE=$2; shift 2 ;;
+        *) break ;;
+    esac
+done
+[ -z "$SIZE" ] && SIZE=$(echo "$CC" | sed 's/gcc$/size/')
+[ "$SIZE" = "$CC" ] && SIZE=size
+
+SRCDIR=$(cd "$(dirname "$0")/../src" && pwd)
+OBJDIR=$(mktemp -d)
+trap 'rm -rf "$OBJDIR"' EXIT
+
+printf "%-22s %8s %8s %8s %8s %8s\n" "module" "text" "data" "bss" "flash" "ram"
+totalText=0; totalData=0; totalBss=0
+for src in "$SRCDIR"/*.c; do
+    module=$(basename "$src" .c)
+    obj="$OBJDIR/$module.o"
+    if ! $CC -std=gnu99 -Os -ffunction-sections -fdata-sections -I"$SRCDIR" "$@" -c "$src" -o "$obj" 2>"$OBJDIR/$module.err"; then
+        printf "%-22s %s\n" "$module" "build failed (see compiler output below)"
+        sed 's/^/    /' "$OBJDIR/$module.err" | head -5
+        continue
+    fi
+    sizes=$($SIZE "$obj" | awk 'NR == 2 { print $1, $2, $3 }')
+    text=${sizes%% *}; rest=${sizes#* }; data=${rest%% *}; bss=${rest#* }
+    if [ "$text" -eq 0 ] && [ "$data" -eq 0 ] && [ "$bss" -eq 0 ]; then
+        printf "%-22s %8s\n" "$module" "disabled"
+        continue
+    fi
+    printf "%-22s %8d %8d %8d %8d %8d\n" "$module" "$text" "$data" "$bss" $((text + data)) $((data + bss))
+    totalText=$((totalText + text)); totalData=$((totalData + data)); totalBss=$((totalBss + bss))
+done
+printf "%-22s %8d %8d %8d %8d %8d\n" "TOTAL" "$totalText" "$totalData" "$totalBss" $((totalText + totalData)) $((totalData + totalBss))
@@ -50,10 +50,67 @@ extern ltemDevice_t g_lqLTEM;
 
 
 
+/* Fixed command formats: static prefix and typed argument slots (comma separated), indexed by atcmdFmt_t
+------------------------------------------------------------------------------------------------- */
+typedef struct atcmdFmtDescr_tag
+{
+    const char *prefix;                                 /// static command text preceeding the arguments
+    uint8_t prefixLen;
+    uint8_t argTypes[atcmd__fmtArgsMax];                /// atcmdArg_t slots, atcmdArg_none terminates
+} atcmdFmtDescr_t;
+
+static const atcmdFmtDescr_t S__cmdFmts[atcmdFmt__cnt] =
+{
+    { "AT+QISEND=", 10, { atcmdArg_int, atcmdArg_int } },                                                          // atcmdFmt_qisend
+    { "AT+QIRD=", 8, { atcmdArg_int, atcmdArg_int } },                                                             // atcmdFmt_qird
+    { "AT+QSSLRECV=", 12, { atcmdArg_int, atcmdArg_int } },                                                        // atcmdFmt_qsslrecv
+    { "AT+QMTPUB=", 10, { atcmdArg_int, atcmdArg_int, atcmdArg_int, atcmdArg_int, atcmdArg_qstr, atcmdArg_int } },  // atcmdFmt_qmtpub
+    { "AT+QFWRITE=", 11, { atcmdArg_int, atcmdArg_int } },                                                         // atcmdFmt_qfwrite
+    { "AT+QFREAD=", 10, { atcmdArg_int, atcmdArg_int } },                                                          // atcmdFmt_qfread
+    { "AT+QFREAD=", 10, { atcmdArg_int } },                                                                        // atcmdFmt_qfreadAll
+    { "AT+QHTTPREAD=", 13, { atcmdArg_int } },                                                                     // atcmdFmt_qhttpread
+    { "AT+QHTTPREADFILE=", 17, { atcmdArg_qstr, atcmdArg_int } }                                                   // atcmdFmt_qhttpreadfile
+};
+
+
+/* Command result cache, opt-in per command (atcmd_configCache())
+------------------------------------------------------------------------------------------------- */
+typedef struct atcmdCacheEntry_tag
+{
+    uint32_t cmdKey;                                    /// command string hash (quick compare), 0 = empty
+    char cmdStr[atcmd__cacheCmdSz];                     /// command string, entry matches on full string
+    uint32_t cachedAt;                                  /// tick count when result was stored
+    uint32_t startedAt;                                 /// BGx start epoch (startCtrl.startedAt), entries from a prior start are stale
+    uint8_t invalidateOn;                               /// atcmdCacheInval_t events
+    uint8_t responseOffset;                             /// atcmd response (preamble removed) offset in rawResponse
+    bool preambleFound;
+    int32_t retValue;
+    char rawResponse[atcmd__respBufferSz + 1];
+} atcmdCacheEntry_t;
+
+static atcmdCacheEntry_t S__cmdCache[atcmd__cacheCnt];
+
+
 /* Static Function Declarations
 ------------------------------------------------------------------------------------------------- */
 static resultCode_t S__readResult();
 static void S__rxParseForUrc();
+static uint16_t S__emitCmdFmt(atcmdFmt_t cmdFmt, va_list ap);
+static bool S__deliverResponseLines();
+static void S__completeResult();
+static bool S__awaitLock(uint32_t timeoutMS, uint8_t priority, const char *holder, bool resume);
+static uint16_t S__resumeTicket(uint8_t priority);
+static bool S__isNextWaiter(const atcmdLockWaiter_t *self, uint8_t priority);
+static bool S__isWaiterPending(uint8_t priority);
+static void S__grantLock(uint8_t priority, const char *holder, uint32_t waited);
+static void S__releaseLock();
+static bool S__cacheTryHit();
+static void S__cacheStore();
+static bool S__isUrcAt(uint16_t urcAt, const char *urcPrefix);
+static inline bool S__isLineEnd(char chr);
+static const char *S__parseIntField(const char *pSrc, char *pDest, uint16_t destSz);
+static const char *S__parseFloatField(const char *pSrc, char *pDest, uint16_t destSz);
+static const char *S__parseStrField(const char *pSrc, char *pDest, uint16_t destSz, bool quoted);
 
 
 #pragma region Public Functions
@@ -70,9 +127,9 @@ void atcmd_reset(bool releaseLock)
  
     // request side of action
     if (releaseLock)
-        g_lqLTEM.atcmd->isOpenLocked = false;                       // reset current lock
+        S__releaseLock();                                           // reset current lock
 
-    memset(g_lqLTEM.atcmd->cmdStr, 0, atcmd__cmdBufferSz);
+    g_lqLTEM.atcmd->cmdStr[0] = '\0';                                 // invoke (vsnprintf or fmt emitter) always terminates command
     memset(g_lqLTEM.atcmd->rawResponse, 0, atcmd__respBufferSz);
     memset(g_lqLTEM.atcmd->errorDetail, 0, ltem__errorDetailSz);
     g_lqLTEM.atcmd->resultCode = 0;
@@ -119,32 +176,108 @@ void atcmd_configDataModeEot(uint8_t eotChar)
 }
 
 
+/**
+ *	@brief Configure line mode response delivery for the next command.
+ */
+void atcmd_configLineMode(atcmdLineRecv_func lineRecvCB, void *lineCntxt)
+{
+    ASSERT(lineRecvCB != NULL);
+
+    g_lqLTEM.atcmd->lineRecvCB = lineRecvCB;
+    g_lqLTEM.atcmd->lineRecvCntxt = lineCntxt;
+    g_lqLTEM.atcmd->lineContinued = false;
+}
+
+
+/**
+ *	@brief Opt the next command into the command result cache.
+ */
+void atcmd_configCache(uint32_t ttlMS, uint8_t invalidateOn)
+{
+    g_lqLTEM.atcmd->cacheTtl = ttlMS;
+    g_lqLTEM.atcmd->cacheInvalOn = invalidateOn;
+}
+
+
+/**
+ *	@brief Invalidate cached command results.
+ */
+void atcmd_invalidateCache(uint8_t events)
+{
+    for (size_t i = 0; i < atcmd__cacheCnt; i++)
+    {
+        if (events == atcmdCacheInval_all || (S__cmdCache[i].invalidateOn & events))
+            S__cmdCache[i].cmdKey = 0;
+    }
+}
+
+
+/**
+ *	@brief Get command result cache counters.
+ */
+void atcmd_getCacheStats(uint32_t *hits, uint32_t *misses)
+{
+    *hits = g_lqLTEM.metrics.cmdCacheHits;
+    *misses = g_lqLTEM.metrics.cmdCacheMisses;
+}
+
+
+/**
+ *	@brief Set the AT channel lock hold budget.
+ */
+void atcmd_setLockHoldBudget(uint32_t budgetMS)
+{
+    g_lqLTEM.atcmd->lockArb.holdBudget = budgetMS;
+}
+
+
+/**
+ *	@brief Get AT channel lock contention metrics.
+ */
+const atcmdLockStats_t *atcmd_getLockStats()
+{
+    return &g_lqLTEM.atcmd->lockArb.stats;
+}
+
+
+/**
+ *	@brief Reset AT channel lock contention metrics.
+ */
+void atcmd_resetLockStats()
+{
+    memset(&g_lqLTEM.atcmd->lockArb.stats, 0, sizeof(atcmdLockStats_t));
+}
+
+
 /**
  *	@brief Invokes a BGx AT command using default option values (automatic locking).
  */
 bool atcmd_tryInvoke(const char *cmdTemplate, ...)
 {
-    if (g_lqLTEM.atcmd->isOpenLocked)
+    if (g_lqLTEM.atcmd->isOpenLocked ||
+        !ATCMD_awaitLockPriority(atcmd__defaultTimeout, atcmdPriority_normal, cmdTemplate))    // acquire lock before touching atCmd control,
+    {                                                                                               // background work may invoke while queued
+        g_lqLTEM.atcmd->cacheTtl = 0;                                   // cache option applies only to this invoke
         return false;
+    }
 
-    atcmd_reset(true);                                                  // clear atCmd control
+    atcmd_reset(false);                                                 // clear atCmd control (lock retained)
     g_lqLTEM.atcmd->autoLock = atcmd__setLockModeAuto;                  // set automatic lock control mode
 
-    //char *cmdStr = g_lqLTEM.atcmd->cmdStr;
     va_list ap;
 
     va_start(ap, cmdTemplate);
     vsnprintf(g_lqLTEM.atcmd->cmdStr, sizeof(g_lqLTEM.atcmd->cmdStr), cmdTemplate, ap);
     strcat(g_lqLTEM.atcmd->cmdStr, "\r");
 
-    if (!ATCMD_awaitLock(g_lqLTEM.atcmd->timeout))          // attempt to acquire new atCmd lock for this instance
-        return false;
-
     g_lqLTEM.atcmd->invokedAt = pMillis();
 
     // TEMPORARY
     memcpy(g_lqLTEM.atcmd->CMDMIRROR, g_lqLTEM.atcmd->cmdStr, strlen(g_lqLTEM.atcmd->cmdStr));
 
+    if (S__cacheTryHit())                                   // opted-in and cached, result served by atcmd_awaitResult()
+        return true;
+
     IOP_startTx(g_lqLTEM.atcmd->cmdStr, strlen(g_lqLTEM.atcmd->cmdStr));
     return true;
 }
@@ -172,16 +305,76 @@ void atcmd_invokeReuseLock(const char *cmdTemplate, ...)
     // TEMPORARY
     memcpy(g_lqLTEM.atcmd->CMDMIRROR, g_lqLTEM.atcmd->cmdStr, atcmd__cmdBufferSz);
 
+    if (S__cacheTryHit())                                   // opted-in and cached, result served by atcmd_awaitResult()
+        return;
+
     IOP_startTx(g_lqLTEM.atcmd->cmdStr, strlen(g_lqLTEM.atcmd->cmdStr));
 }
 
 
+/**
+ *	@brief Invokes a fixed format BGx AT command using default option values (automatic locking).
+ */
+bool atcmd_tryInvokeFmt(atcmdFmt_t cmdFmt, ...)
+{
+    ASSERT(cmdFmt < atcmdFmt__cnt);
+
+    if (g_lqLTEM.atcmd->isOpenLocked ||
+        !ATCMD_awaitLockPriority(atcmd__defaultTimeout, atcmdPriority_normal, S__cmdFmts[cmdFmt].prefix))   // acquire lock before touching atCmd control
+    {
+        g_lqLTEM.atcmd->cacheTtl = 0;                                   // cache option applies only to this invoke
+        return false;
+    }
+
+    atcmd_reset(false);                                                 // clear atCmd control (lock retained)
+    g_lqLTEM.atcmd->autoLock = atcmd__setLockModeAuto;                  // set automatic lock control mode
+
+    va_list ap;
+    va_start(ap, cmdFmt);
+    uint16_t cmdLen = S__emitCmdFmt(cmdFmt, ap);
+    va_end(ap);
+
+    g_lqLTEM.atcmd->invokedAt = pMillis();
+
+    // TEMPORARY
+    memcpy(g_lqLTEM.atcmd->CMDMIRROR, g_lqLTEM.atcmd->cmdStr, cmdLen + 1);
+
+    IOP_startTx(g_lqLTEM.atcmd->cmdStr, cmdLen);
+    return true;
+}
+
+
+/**
+ *	@brief Invokes a fixed format BGx AT command without acquiring a lock, using previously set setOptions() values.
+ */
+void atcmd_invokeFmtReuseLock(atcmdFmt_t cmdFmt, ...)
+{
+    ASSERT(cmdFmt < atcmdFmt__cnt);
+    ASSERT(g_lqLTEM.atcmd->isOpenLocked);                               // function assumes re-use of existing lock
+
+    atcmd_reset(false);                                                 // clear out properties WITHOUT lock release
+    g_lqLTEM.atcmd->autoLock = atcmd__setLockModeManual;
+
+    va_list ap;
+    va_start(ap, cmdFmt);
+    uint16_t cmdLen = S__emitCmdFmt(cmdFmt, ap);
+    va_end(ap);
+
+    g_lqLTEM.atcmd->invokedAt = pMillis();
+
+    // TEMPORARY
+    memcpy(g_lqLTEM.atcmd->CMDMIRROR, g_lqLTEM.atcmd->cmdStr, cmdLen + 1);
+
+    IOP_startTx(g_lqLTEM.atcmd->cmdStr, cmdLen);
+}
+
+
 /**
  *	@brief Closes (completes) a BGx AT command structure and frees action resource (release action lock).
  */
 void atcmd_close()
 {
-    g_lqLTEM.atcmd->isOpenLocked = false;
+    S__releaseLock();
     g_lqLTEM.atcmd->execDuration = pMillis() - g_lqLTEM.atcmd->invokedAt;
 }
 
@@ -212,6 +405,18 @@ void atcmd_close()
  */
 resultCode_t atcmd_awaitResult()
 {
+    if (g_lqLTEM.atcmd->cacheHit)                                                   // result restored from cache at invoke, no BGx round-trip
+    {
+        if (g_lqLTEM.atcmd->autoLock)
+            S__releaseLock();                                                       // equivalent to atcmd_close()
+        g_lqLTEM.atcmd->cacheHit = false;
+        g_lqLTEM.atcmd->cacheTtl = 0;
+        g_lqLTEM.atcmd->timeout = atcmd__defaultTimeout;
+        g_lqLTEM.atcmd->responseParserFunc = ATCMD_okResponseParser;
+        g_lqLTEM.atcmd->lineRecvCB = NULL;
+        return g_lqLTEM.atcmd->resultCode;
+    }
+
     resultCode_t rslt = resultCode__unknown;                                        // resultCode_t result;
     do
     {
@@ -224,20 +429,7 @@ resultCode_t atcmd_awaitResult()
         pYield();                                                                   // give back control momentarily before next loop pass
     } while (rslt == resultCode__unknown);
 
-    #if _DEBUG == 0                                                                 // debug for debris in rxBffr
-    ASSERT_W(cbffr_getOccupied(g_lqLTEM.iop->rxBffr) == 0, "RxBffr Dirty");
-    #else
-    if (cbffr_getOccupied(g_lqLTEM.iop->rxBffr) > 0)
-    {
-        char dbg[81] = {0};
-        cbffr_pop(g_lqLTEM.iop->rxBffr, dbg, 80);
-        PRINTF(dbgColor__yellow, "*!* %s", dbg);
-    }
-    #endif
-
-    g_lqLTEM.atcmd->timeout = atcmd__defaultTimeout;
-    g_lqLTEM.atcmd->responseParserFunc = ATCMD_okResponseParser;
-
+    S__completeResult();
     return g_lqLTEM.atcmd->resultCode;
 }
 
@@ -393,28 +585,267 @@ void atcmd_exitTransparentMode()
 */
 bool ATCMD_awaitLock(uint16_t timeoutMS)
 {
-    uint32_t waitStart = pMillis();
-                                                                    
-    while (pMillis() - waitStart < timeoutMS)           // cannot set lock while... 
-    {                                                       // can set new lock if...
-        if (!g_lqLTEM.atcmd->isOpenLocked)                  // !not existing lock
+    return ATCMD_awaitLockPriority(timeoutMS, atcmdPriority_normal, NULL);
+}
+
+
+/**
+ *	@brief Awaits exclusive access to QBG module command interface, granted by priority class and FIFO within class.
+ */
+bool ATCMD_awaitLockPriority(uint32_t timeoutMS, uint8_t priority, const char *holder)
+{
+    return S__awaitLock(timeoutMS, priority, holder, false);
+}
+
+
+/**
+ *	@brief Yield point for multi-step lock holders, releases and re-requests the lock if over hold budget and a higher priority caller is waiting.
+ */
+bool ATCMD_yieldLock(uint32_t timeoutMS)
+{
+    atcmdLockArb_t *arb = &g_lqLTEM.atcmd->lockArb;
+    ASSERT(g_lqLTEM.atcmd->isOpenLocked);                   // function assumes holder of existing lock
+
+    uint32_t holdBudget = arb->holdBudget ? arb->holdBudget : atcmd__lockHoldBudget;
+    if (!pElapsed(arb->heldAt, holdBudget) || !S__isWaiterPending(arb->holderPriority + 1))
+        return true;                                        // within budget or no higher priority waiter, continue holding
+
+    char holder[atcmd__lockHolderSz];
+    strcpy(holder, arb->holder);
+    uint8_t priority = arb->holderPriority;
+
+    arb->stats.yields++;
+    S__releaseLock();
+    return S__awaitLock(timeoutMS, priority, holder, true);     // resume ahead of peers in class
+}
+
+
+/**
+ *	@brief Returns the current atCmd lock state
+ */
+bool ATCMD_isLockActive()
+{
+    return g_lqLTEM.atcmd->isOpenLocked;
+}
+
+
+/**
+ *	@brief Returns true if a lock request is queued (requester waiting, servicing ltem_eventMgr)
+ */
+bool ATCMD_isLockPending()
+{
+    for (size_t i = 0; i < atcmd__lockWaitersMax; i++)
+    {
+        if (g_lqLTEM.atcmd->lockArb.waiters[i].active)
+            return true;
+    }
+    return false;
+}
+
+
+/**
+ *	@brief Invokes a BGx AT command only if the lock is available now (automatic locking), result is collected with ATCMD_pollResult().
+ */
+bool ATCMD_tryInvokeNoWait(uint32_t timeoutMS, const char *cmdTemplate, ...)
+{
+    if (g_lqLTEM.atcmd->isOpenLocked ||
+        !ATCMD_awaitLockPriority(0, atcmdPriority_normal, cmdTemplate))    // single attempt, caller retries on a later pass
+    {
+        return false;
+    }
+
+    atcmd_reset(false);                                                 // clear atCmd control (lock retained)
+    g_lqLTEM.atcmd->autoLock = atcmd__setLockModeAuto;
+    g_lqLTEM.atcmd->timeout = timeoutMS;
+
+    va_list ap;
+    va_start(ap, cmdTemplate);
+    vsnprintf(g_lqLTEM.atcmd->cmdStr, sizeof(g_lqLTEM.atcmd->cmdStr), cmdTemplate, ap);
+    va_end(ap);
+    strcat(g_lqLTEM.atcmd->cmdStr, "\r");
+
+    g_lqLTEM.atcmd->invokedAt = pMillis();
+
+    // TEMPORARY
+    memcpy(g_lqLTEM.atcmd->CMDMIRROR, g_lqLTEM.atcmd->cmdStr, strlen(g_lqLTEM.atcmd->cmdStr));
+
+    IOP_startTx(g_lqLTEM.atcmd->cmdStr, strlen(g_lqLTEM.atcmd->cmdStr));
+    return true;
+}
+
+
+/**
+ *	@brief Checks once (no wait) for the result of the command underway, resultCode__unknown while the result is pending.
+ */
+resultCode_t ATCMD_pollResult()
+{
+    if (g_lqLTEM.atcmd->cacheHit)                                       // served from cache at invoke, completes without waiting
+        return atcmd_awaitResult();
+
+    if (S__readResult() == resultCode__unknown)
+        return resultCode__unknown;
+
+    S__completeResult();
+    return g_lqLTEM.atcmd->resultCode;
+}
+
+
+/**
+ *	@brief Observes (does not consume) a URC at the head of dispatch, invalidating cached command results it affects.
+ */
+void ATCMD_observeUrc(uint16_t urcAt)
+{
+    if (S__isUrcAt(urcAt, "+CREG: ") || S__isUrcAt(urcAt, "+CGREG: ") || S__isUrcAt(urcAt, "+CEREG: "))
+        atcmd_invalidateCache(atcmdCacheInval_registration);
+    else if (S__isUrcAt(urcAt, "+QIURC: \"pdpdeact\""))
+        atcmd_invalidateCache(atcmdCacheInval_pdpDeact);
+}
+
+
+/**
+ *	@brief Hash (FNV-1a) of the current command string, cache key.
+ */
+static uint32_t S__cmdKey(const char *cmdStr)
+{
+    uint32_t hash = 2166136261U;
+    while (*cmdStr)
+    {
+        hash ^= (uint8_t)*cmdStr++;
+        hash *= 16777619U;
+    }
+    return hash ? hash : 1;                                                                         // 0 marks empty entry
+}
+
+
+/**
+ *	@brief If the command is opted-in to the result cache and a fresh result is cached, restore it as the command's result.
+ *  @return True if served from cache (command is not sent).
+ */
+static bool S__cacheTryHit()
+{
+    if (g_lqLTEM.atcmd->cacheTtl == 0)
+        return false;
+    if (strlen(g_lqLTEM.atcmd->cmdStr) >= atcmd__cacheCmdSz)
+    {
+        g_lqLTEM.atcmd->cacheTtl = 0;                                                               // too long to cache, sent and not stored
+        return false;
+    }
+
+    g_lqLTEM.atcmd->cacheKey = S__cmdKey(g_lqLTEM.atcmd->cmdStr);
+    for (size_t i = 0; i < atcmd__cacheCnt; i++)
+    {
+        atcmdCacheEntry_t *entry = &S__cmdCache[i];
+        if (entry->cmdKey == g_lqLTEM.atcmd->cacheKey && 
+            strcmp(entry->cmdStr, g_lqLTEM.atcmd->cmdStr) == 0 &&                                   // hash collision is not a hit
+            entry->startedAt == g_lqLTEM.startCtrl.startedAt && 
+            !pElapsed(entry->cachedAt, g_lqLTEM.atcmd->cacheTtl))
         {
-            g_lqLTEM.atcmd->isOpenLocked = true;            // acquired new lock
+            memcpy(g_lqLTEM.atcmd->rawResponse, entry->rawResponse, sizeof(entry->rawResponse));
+            g_lqLTEM.atcmd->response = g_lqLTEM.atcmd->rawResponse + entry->responseOffset;
+            g_lqLTEM.atcmd->preambleFound = entry->preambleFound;
+            g_lqLTEM.atcmd->retValue = entry->retValue;
+            g_lqLTEM.atcmd->parserResult = cmdParseRslt_success;
+            g_lqLTEM.atcmd->resultCode = resultCode__success;
+            g_lqLTEM.atcmd->execDuration = 0;
+            g_lqLTEM.atcmd->cacheHit = true;
+            g_lqLTEM.metrics.cmdCacheHits++;
             return true;
         }
-        pYield();                                           // call back to platform yield() in case there is work there that can be done
-        ltem_eventMgr();                                    // process any new receives prior to starting cmd invoke
     }
-    return false;                                           // timed out waiting for lock
+    g_lqLTEM.metrics.cmdCacheMisses++;
+    return false;
 }
 
 
 /**
- *	@brief Returns the current atCmd lock state
+ *	@brief Store the successful result of an opted-in command, replacing a prior result for the command, an empty/stale entry or the oldest.
  */
-bool ATCMD_isLockActive()
+static void S__cacheStore()
 {
-    return g_lqLTEM.atcmd->isOpenLocked;
+    if (strlen(g_lqLTEM.atcmd->cmdStr) >= atcmd__cacheCmdSz)
+        return;
+
+    g_lqLTEM.atcmd->cacheKey = S__cmdKey(g_lqLTEM.atcmd->cmdStr);
+    atcmdCacheEntry_t *entry = NULL;
+    for (size_t i = 0; i < atcmd__cacheCnt; i++)
+    {
+        atcmdCacheEntry_t *candidate = &S__cmdCache[i];
+        if (candidate->cmdKey == g_lqLTEM.atcmd->cacheKey && strcmp(candidate->cmdStr, g_lqLTEM.atcmd->cmdStr) == 0)    // replace prior result
+        {
+            entry = candidate;
+            break;
+        }
+        if (candidate->cmdKey == 0 || candidate->startedAt != g_lqLTEM.startCtrl.startedAt)         // empty or stale
+            entry = candidate;
+        else if (entry == NULL || (entry->cmdKey != 0 && candidate->cachedAt < entry->cachedAt))  // oldest
+            entry = candidate;
+    }
+
+    entry->cmdKey = g_lqLTEM.atcmd->cacheKey;
+    strcpy(entry->cmdStr, g_lqLTEM.atcmd->cmdStr);
+    entry->cachedAt = pMillis();
+    entry->startedAt = g_lqLTEM.startCtrl.startedAt;
+    entry->invalidateOn = g_lqLTEM.atcmd->cacheInvalOn;
+    entry->responseOffset = g_lqLTEM.atcmd->response - g_lqLTEM.atcmd->rawResponse;
+    entry->preambleFound = g_lqLTEM.atcmd->preambleFound;
+    entry->retValue = g_lqLTEM.atcmd->retValue;
+    memcpy(entry->rawResponse, g_lqLTEM.atcmd->rawResponse, sizeof(entry->rawResponse));
+}
+
+
+/**
+ *	@brief Tests for URC prefix at the URC start offset in RX buffer.
+ */
+static bool S__isUrcAt(uint16_t urcAt, const char *urcPrefix)
+{
+    return cbffr_find(g_lqLTEM.iop->rxBffr, urcPrefix, urcAt, strlen(urcPrefix), false) == urcAt;
+}
+
+
+/**
+ *	@brief Line mode: pops completed response lines from RX buffer and delivers them to the line receiver.
+ *  @return True if the final result line (OK/ERROR/+CME/+CMS) was received, it is placed in rawResponse for the completion parser.
+ */
+static bool S__deliverResponseLines()
+{
+    char lineBffr[atcmd__lineBufferSz + 1];
+
+    while (cbffr_getOccupied(g_lqLTEM.iop->rxBffr) > 0)
+    {
+        int16_t eolAt = cbffr_find(g_lqLTEM.iop->rxBffr, "\r\n", 0, atcmd__lineBufferSz + 2, false);
+        bool isComplete = CBFFR_FOUND(eolAt) && eolAt <= atcmd__lineBufferSz;
+        uint16_t lineSz;
+
+        if (isComplete)
+            lineSz = eolAt;
+        else if (cbffr_getOccupied(g_lqLTEM.iop->rxBffr) >= atcmd__lineBufferSz)                     // long line, deliver segment
+            lineSz = atcmd__lineBufferSz;
+        else
+            return false;                                                                           // wait for line to complete
+
+        cbffr_pop(g_lqLTEM.iop->rxBffr, lineBffr, lineSz);
+        lineBffr[lineSz] = '\0';
+        if (isComplete)
+            cbffr_skipTail(g_lqLTEM.iop->rxBffr, 2);                                                // discard line end
+
+        bool isContinuation = g_lqLTEM.atcmd->lineContinued;
+        g_lqLTEM.atcmd->lineContinued = !isComplete;
+        if (!isContinuation)
+        {
+            if (lineSz == 0)                                                                        // skip blank lines between response lines
+                continue;
+            if (strcmp(lineBffr, "OK") == 0 || strcmp(lineBffr, "ERROR") == 0 || 
+                strncmp(lineBffr, "+CME ERROR", 10) == 0 || strncmp(lineBffr, "+CMS ERROR", 10) == 0)
+            {
+                lineSz = MIN(lineSz, atcmd__respBufferSz - 2);
+                memcpy(g_lqLTEM.atcmd->rawResponse, lineBffr, lineSz);
+                memcpy(g_lqLTEM.atcmd->rawResponse + lineSz, "\r\n", 3);
+                return true;
+            }
+        }
+        (*g_lqLTEM.atcmd->lineRecvCB)(g_lqLTEM.atcmd->lineRecvCntxt, lineBffr, lineSz, isComplete);
+    }
+    return false;
 }
 
 
@@ -457,12 +888,20 @@ static resultCode_t S__readResult()
             }
         }
 
-        uint8_t respLen = strlen(g_lqLTEM.atcmd->rawResponse);                                          // response so far
-        uint8_t popSz = MIN(atcmd__respBufferSz - respLen, cbffr_getOccupied(g_lqLTEM.iop->rxBffr));    
-        ASSERT((respLen + popSz) < atcmd__respBufferSz);                                                // ensure don't overflow 
-
-        if (g_lqLTEM.atcmd->parserResult == cmdParseRslt_pending)
+        if (g_lqLTEM.atcmd->lineRecvCB != NULL)                                                         // line mode: deliver lines, parse only final result
         {
+            if (g_lqLTEM.atcmd->parserResult == cmdParseRslt_pending && S__deliverResponseLines())
+            {
+                g_lqLTEM.atcmd->parserResult = (*g_lqLTEM.atcmd->responseParserFunc)();
+                PRINTF(dbgColor__gray, "prsr=%d \r", g_lqLTEM.atcmd->parserResult);
+            }
+        }
+        else if (g_lqLTEM.atcmd->parserResult == cmdParseRslt_pending)
+        {
+            uint8_t respLen = strlen(g_lqLTEM.atcmd->rawResponse);                                      // response so far
+            uint8_t popSz = MIN(atcmd__respBufferSz - respLen, cbffr_getOccupied(g_lqLTEM.iop->rxBffr));    
+            ASSERT((respLen + popSz) < atcmd__respBufferSz);                                            // ensure don't overflow 
+
             cbffr_pop(g_lqLTEM.iop->rxBffr, g_lqLTEM.atcmd->rawResponse + respLen,  popSz);             // pop new into response buffer for parsing
             /* - */
             g_lqLTEM.atcmd->parserResult = (*g_lqLTEM.atcmd->responseParserFunc)();                     /* *** parse for command response *** */
@@ -490,7 +929,7 @@ static resultCode_t S__readResult()
         if (pElapsed(g_lqLTEM.atcmd->invokedAt, g_lqLTEM.atcmd->timeout))
         {
             g_lqLTEM.atcmd->resultCode = resultCode__timeout;
-            g_lqLTEM.atcmd->isOpenLocked = false;                                               // close action to release action lock
+            S__releaseLock();                                                                   // close action to release action lock
             g_lqLTEM.atcmd->execDuration = pMillis() - g_lqLTEM.atcmd->invokedAt;
 
             if (ltem_getDeviceState() != deviceState_appReady)                                  // if action timed-out, verify not a device wide failure
@@ -506,7 +945,7 @@ static resultCode_t S__readResult()
     if (g_lqLTEM.atcmd->parserResult & cmdParseRslt_success)                                // success bit: parser completed with success (may have excessRecv warning)
     {
         if (g_lqLTEM.atcmd->autoLock)                                                       // if the individual cmd is controlling lock state
-            g_lqLTEM.atcmd->isOpenLocked = false;                                           // equivalent to atcmd_close()
+            S__releaseLock();                                                               // equivalent to atcmd_close()
         g_lqLTEM.atcmd->execDuration = pMillis() - g_lqLTEM.atcmd->invokedAt;
         g_lqLTEM.atcmd->resultCode = resultCode__success;
         g_lqLTEM.metrics.cmdInvokes++;
@@ -515,6 +954,32 @@ static resultCode_t S__readResult()
 }
 
 
+/**
+ *	@brief Completes a command result (awaited or polled), storing an opted-in result to cache and restoring per command options.
+ */
+static void S__completeResult()
+{
+    #if _DEBUG == 0                                                                 // debug for debris in rxBffr
+    ASSERT_W(cbffr_getOccupied(g_lqLTEM.iop->rxBffr) == 0, "RxBffr Dirty");
+    #else
+    if (cbffr_getOccupied(g_lqLTEM.iop->rxBffr) > 0)
+    {
+        char dbg[81] = {0};
+        cbffr_pop(g_lqLTEM.iop->rxBffr, dbg, 80);
+        PRINTF(dbgColor__yellow, "*!* %s", dbg);
+    }
+    #endif
+
+    if (g_lqLTEM.atcmd->cacheTtl > 0 && g_lqLTEM.atcmd->resultCode == resultCode__success && g_lqLTEM.atcmd->lineRecvCB == NULL)
+        S__cacheStore();                                                            // opted-in, keep result for subsequent invokes
+
+    g_lqLTEM.atcmd->timeout = atcmd__defaultTimeout;
+    g_lqLTEM.atcmd->responseParserFunc = ATCMD_okResponseParser;
+    g_lqLTEM.atcmd->lineRecvCB = NULL;                                              // line mode and cache options are per command
+    g_lqLTEM.atcmd->cacheTtl = 0;
+}
+
+
 #pragma endregion // LTEmC Internal Functions 
 
 
@@ -699,12 +1164,419 @@ cmdParseRslt_t atcmd_stdResponseParser(const char *pPreamble, bool preambleReqd,
 }
 
 
+/**
+ *	@brief Extracts a single line of comma delimited response fields into a caller struct, as described by schema.
+ */
+bool atcmd_parseFields(const char *source, const atcmdSchema_t *schema, void *dest, const char **continueAt)
+{
+    ASSERT(source != NULL && schema != NULL && dest != NULL);
+
+    const char *pSrc = source;
+    uint8_t fieldsParsed = 0;
+    bool preambleFound = true;
+
+    if (schema->preamble && !STREMPTY(schema->preamble))
+    {
+        const char *pPreambleLoctn = strstr(source, schema->preamble);
+        if (pPreambleLoctn)
+            pSrc = pPreambleLoctn + strlen(schema->preamble);
+        else
+            preambleFound = false;
+    }
+
+    if (preambleFound)
+    {
+        while (*pSrc == ' ')
+            pSrc++;
+
+        for (uint8_t i = 0; i < schema->fieldCnt; i++)
+        {
+            if (S__isLineEnd(*pSrc))                                                        // no more fields on line
+                break;
+
+            const atcmdField_t *field = &schema->fields[i];
+            char *pDest = (char*)dest + field->offset;
+
+            switch (field->type)
+            {
+                case atcmdField_int:
+                    pSrc = S__parseIntField(pSrc, pDest, field->size);
+                    break;
+
+                case atcmdField_float:
+                    pSrc = S__parseFloatField(pSrc, pDest, field->size);
+                    break;
+
+                case atcmdField_str:
+                case atcmdField_qstr:
+                    pSrc = S__parseStrField(pSrc, pDest, field->size, field->type == atcmdField_qstr);
+                    break;
+
+                default:
+                    pSrc = S__parseStrField(pSrc, NULL, 0, true);
+                    break;
+            }
+            fieldsParsed++;
+
+            while (*pSrc != ',' && !S__isLineEnd(*pSrc))                                    // discard any unparsed remainder of token
+                pSrc++;
+            if (*pSrc == ',')
+                pSrc++;
+        }
+    }
+
+    if (continueAt)
+    {
+        while (*pSrc != '\0' && *pSrc != '\r' && *pSrc != '\n')
+            pSrc++;
+        while (*pSrc == '\r' || *pSrc == '\n')
+            pSrc++;
+        *continueAt = pSrc;
+    }
+    return preambleFound && fieldsParsed >= schema->fieldsReqd;
+}
+
+
+/**
+ *	@brief Extracts fields from the last command response into a caller struct, as described by schema.
+ */
+bool atcmd_getResponseFields(const atcmdSchema_t *schema, void *dest)
+{
+    return atcmd_parseFields(g_lqLTEM.atcmd->response, schema, dest, NULL);
+}
+
+
 #pragma endregion  // completionParsers
 
 
 #pragma region Static Function Definitions
 /*-----------------------------------------------------------------------------------------------*/
 
+/**
+ *	@brief Queue a lock request and wait for grant. A resumed request (holder yielded) is queued ahead of its priority class peers.
+ */
+static bool S__awaitLock(uint32_t timeoutMS, uint8_t priority, const char *holder, bool resume)
+{
+    atcmdLockArb_t *arb = &g_lqLTEM.atcmd->lockArb;
+    uint32_t waitStart = pMillis();
+    priority = MIN(priority, atcmdPriority__cnt - 1);
+
+    atcmdLockWaiter_t *waiter = NULL;                       // queue request, if queue is full request waits unqueued (behind all live waiters)
+    for (size_t i = 0; i < atcmd__lockWaitersMax; i++)
+    {
+        if (!arb->waiters[i].active)
+        {
+            waiter = &arb->waiters[i];
+            waiter->priority = priority;
+            waiter->ticket = resume ? S__resumeTicket(priority) : arb->nextTicket++;
+            waiter->active = true;
+            break;
+        }
+    }
+
+    while (true)
+    {
+        if (waiter)
+            waiter->polledAt = pMillis();
+
+        if (!g_lqLTEM.atcmd->isOpenLocked && S__isNextWaiter(waiter, priority))
+        {
+            if (waiter)
+                waiter->active = false;
+            S__grantLock(priority, holder, pMillis() - waitStart);
+            return true;
+        }
+        if (pElapsed(waitStart, timeoutMS))                 // timeoutMS = 0: single attempt, no eventMgr re-entry (safe from doWorkers)
+            break;
+        pYield();                                           // call back to platform yield() in case there is work there that can be done
+        ltem_eventMgr();                                    // process any new receives prior to starting cmd invoke
+    }
+
+    if (waiter)
+        waiter->active = false;
+    arb->stats.timeouts[priority]++;
+    return false;                                           // timed out waiting for lock
+}
+
+
+/**
+ *	@brief Ticket ahead of all queued waiters in the priority class.
+ */
+static uint16_t S__resumeTicket(uint8_t priority)
+{
+    atcmdLockArb_t *arb = &g_lqLTEM.atcmd->lockArb;
+    uint16_t ticket = arb->nextTicket;
+
+    for (size_t i = 0; i < atcmd__lockWaitersMax; i++)
+    {
+        if (arb->waiters[i].active && arb->waiters[i].priority == priority && (int16_t)(arb->waiters[i].ticket - ticket) < 0)
+            ticket = arb->waiters[i].ticket;
+    }
+    return ticket - 1;
+}
+
+
+/**
+ *	@brief True if no live waiter is ahead of the request (higher priority class, or same class with an earlier ticket).
+ *  @details A waiter that has not polled recently is suspended beneath the current caller (cooperative nesting via pYield/eventMgr)
+ *  and cannot take the lock, it is not waited on.
+ */
+static bool S__isNextWaiter(const atcmdLockWaiter_t *self, uint8_t priority)
+{
+    atcmdLockArb_t *arb = &g_lqLTEM.atcmd->lockArb;
+
+    for (size_t i = 0; i < atcmd__lockWaitersMax; i++)
+    {
+        const atcmdLockWaiter_t *waiter = &arb->waiters[i];
+        if (!waiter->active || waiter == self || pElapsed(waiter->polledAt, atcmd__lockWaiterStale))
+            continue;
+        if (waiter->priority > priority)
+            return false;
+        if (waiter->priority == priority && (self == NULL || (int16_t)(waiter->ticket - self->ticket) < 0))
+            return false;
+    }
+    return true;
+}
+
+
+/**
+ *	@brief True if a live waiter of the priority class or higher is queued.
+ */
+static bool S__isWaiterPending(uint8_t priority)
+{
+    atcmdLockArb_t *arb = &g_lqLTEM.atcmd->lockArb;
+
+    for (size_t i = 0; i < atcmd__lockWaitersMax; i++)
+    {
+        const atcmdLockWaiter_t *waiter = &arb->waiters[i];
+        if (waiter->active && waiter->priority >= priority && !pElapsed(waiter->polledAt, atcmd__lockWaiterStale))
+            return true;
+    }
+    return false;
+}
+
+
+/**
+ *	@brief Grant the lock, record holder and wait metrics.
+ */
+static void S__grantLock(uint8_t priority, const char *holder, uint32_t waited)
+{
+    atcmdLockArb_t *arb = &g_lqLTEM.atcmd->lockArb;
+
+    g_lqLTEM.atcmd->isOpenLocked = true;
+    arb->holderPriority = priority;
+    arb->heldAt = pMillis();
+
+    holder = holder ? holder : "lock";
+    size_t i = 0;
+    for (; i < atcmd__lockHolderSz - 1 && holder[i] && holder[i] != '=' && holder[i] != '?' && holder[i] != '\r'; i++)
+        arb->holder[i] = holder[i];                                                                 // commands recorded by name only
+    arb->holder[i] = '\0';
+
+    arb->stats.acquired[priority]++;
+    arb->stats.waitTotal[priority] += waited;
+    arb->stats.waitMax[priority] = MAX(arb->stats.waitMax[priority], waited);
+}
+
+
+/**
+ *	@brief Release the lock (if held), record hold metrics.
+ */
+static void S__releaseLock()
+{
+    atcmdLockArb_t *arb = &g_lqLTEM.atcmd->lockArb;
+
+    if (!g_lqLTEM.atcmd->isOpenLocked)
+        return;
+    g_lqLTEM.atcmd->isOpenLocked = false;
+
+    uint32_t held = pMillis() - arb->heldAt;
+    if (held > arb->stats.holdMax)
+    {
+        arb->stats.holdMax = held;
+        strcpy(arb->stats.holdMaxHolder, arb->holder);
+    }
+    if (held > (arb->holdBudget ? arb->holdBudget : atcmd__lockHoldBudget))
+        arb->stats.budgetOverruns++;
+}
+
+
+static inline bool S__isLineEnd(char chr)
+{
+    return chr == '\0' || chr == '\r' || chr == '\n';
+}
+
+
+/**
+ *	@brief Parses a signed decimal integer field, stores to dest as int8/16/32 (destSz). Returns position following the digits.
+ */
+static const char *S__parseIntField(const char *pSrc, char *pDest, uint16_t destSz)
+{
+    bool negative = false;
+    uint32_t value = 0;
+
+    if (*pSrc == '-' || *pSrc == '+')
+        negative = *pSrc++ == '-';
+    while (*pSrc >= '0' && *pSrc <= '9')
+        value = value * 10 + (*pSrc++ - '0');
+    if (negative)
+        value = 0 - value;
+
+    if (destSz == sizeof(int8_t))
+        *(int8_t*)pDest = (int8_t)value;
+    else if (destSz == sizeof(int16_t))
+        *(int16_t*)pDest = (int16_t)value;
+    else if (destSz == sizeof(int32_t))
+        *(int32_t*)pDest = (int32_t)value;
+    return pSrc;
+}
+
+
+/**
+ *	@brief Parses a decimal number field, stores to dest as float or double (destSz). Returns position following the number.
+ */
+static const char *S__parseFloatField(const char *pSrc, char *pDest, uint16_t destSz)
+{
+    bool negative = false;
+    uint32_t intPart = 0;
+    uint32_t fracPart = 0;
+    uint32_t fracScale = 1;
+
+    if (*pSrc == '-' || *pSrc == '+')
+        negative = *pSrc++ == '-';
+    while (*pSrc >= '0' && *pSrc <= '9')
+        intPart = intPart * 10 + (*pSrc++ - '0');
+    if (*pSrc == '.')
+    {
+        pSrc++;
+        while (*pSrc >= '0' && *pSrc <= '9')
+        {
+            if (fracScale < 100000000)                                          // digits beyond 8 decimal places are discarded
+            {
+                fracPart = fracPart * 10 + (*pSrc - '0');
+                fracScale *= 10;
+            }
+            pSrc++;
+        }
+    }
+    double value = (double)intPart + (double)fracPart / fracScale;
+    if (negative)
+        value = -value;
+
+    if (destSz == sizeof(float))
+        *(float*)pDest = (float)value;
+    else if (destSz == sizeof(double))
+        *(double*)pDest = value;
+    return pSrc;
+}
+
+
+/**
+ *	@brief Copies a string field to dest (NULL to skip), truncated to destSz - 1 and terminated. Returns position following the field.
+ */
+static const char *S__parseStrField(const char *pSrc, char *pDest, uint16_t destSz, bool quoted)
+{
+    uint16_t destLen = 0;
+    bool inQuotes = quoted && *pSrc == '"';
+
+    if (inQuotes)
+        pSrc++;
+    while (!S__isLineEnd(*pSrc))
+    {
+        if (inQuotes ? *pSrc == '"' : *pSrc == ',')
+            break;
+        if (pDest && destLen < destSz - 1)
+            pDest[destLen++] = *pSrc;
+        pSrc++;
+    }
+    if (inQuotes && *pSrc == '"')
+        pSrc++;
+    if (pDest && destSz > 0)
+        pDest[destLen] = '\0';
+    return pSrc;
+}
+
+
+/**
+ *	@brief Writes a signed decimal integer at dest, returns position following the last char written.
+ */
+static inline char *S__emitInt(char *dest, int32_t value)
+{
+    char digits[10];
+    uint8_t digitCnt = 0;
+    uint32_t uValue = (uint32_t)value;
+
+    if (value < 0)
+    {
+        *dest++ = '-';
+        uValue = 0 - uValue;
+    }
+    do
+    {
+        digits[digitCnt++] = '0' + (uValue % 10);
+        uValue /= 10;
+    } while (uValue);
+
+    while (digitCnt)
+        *dest++ = digits[--digitCnt];
+    return dest;
+}
+
+
+/**
+ *	@brief Copies a string to dest (truncating at limit), returns position following the last char written.
+ */
+static inline char *S__emitStr(char *dest, const char *src, const char *limit)
+{
+    while (*src && dest < limit)
+        *dest++ = *src++;
+    return dest;
+}
+
+
+/**
+ *	@brief Emits fixed format command with arguments into atcmd cmdStr, terminated with "\r\0".
+ *  @return Length of command (excluding '\0')
+ */
+static uint16_t S__emitCmdFmt(atcmdFmt_t cmdFmt, va_list ap)
+{
+    const atcmdFmtDescr_t *descr = &S__cmdFmts[cmdFmt];
+    char *dest = g_lqLTEM.atcmd->cmdStr;
+    const char *bffrEnd = g_lqLTEM.atcmd->cmdStr + atcmd__cmdBufferSz;
+    const char *limit = bffrEnd - 16;                                       // strings truncate here, reserves for trailing int/delimiters and "\r\0"
+
+    memcpy(dest, descr->prefix, descr->prefixLen);
+    dest += descr->prefixLen;
+
+    for (uint8_t i = 0; i < atcmd__fmtArgsMax && descr->argTypes[i] != atcmdArg_none; i++)
+    {
+        if (i > 0)
+            *dest++ = ',';
+
+        switch (descr->argTypes[i])
+        {
+            case atcmdArg_int:
+                ASSERT(bffrEnd - dest > 13);                                    // sign + 10 digits + "\r\0"
+                dest = S__emitInt(dest, va_arg(ap, int));
+                break;
+
+            case atcmdArg_str:
+                dest = S__emitStr(dest, va_arg(ap, const char *), limit);
+                break;
+
+            case atcmdArg_qstr:
+                *dest++ = '"';
+                dest = S__emitStr(dest, va_arg(ap, const char *), limit);
+                *dest++ = '"';
+                break;
+        }
+    }
+    *dest++ = '\r';
+    *dest = '\0';
+    return dest - g_lqLTEM.atcmd->cmdStr;
+}
+
+
 
 // /**
 //  *	@brief register a stream peer with IOP to control communications. Typically performed by protocol open.
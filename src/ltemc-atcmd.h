@@ -69,6 +69,71 @@ void atcmd_configDataMode(uint16_t contextKey, const char* trigger, dataRxHndlr_
 void atcmd_configDataModeEot(uint8_t eotChar);
 
 
+/**
+ * @brief Configure line mode response delivery for the next command, for responses larger than the response buffer.
+ * @details Response lines are passed to lineRecvCB as they are received (not accumulated), blank lines are skipped. Lines longer
+ *          than atcmd__lineBufferSz are delivered in segments, isComplete is set on the final segment. The final result line 
+ *          (OK, ERROR, +CME/+CMS ERROR) is not delivered, it is evaluated by the completion parser (use default OK parser).
+ *          Configure after acquiring the lock (ATCMD_awaitLock) and invoke with atcmd_invokeReuseLock(), cleared on command completion.
+ * 
+ * @param lineRecvCB Callback to receive response lines, invoked from atcmd_awaitResult().
+ * @param lineCntxt Caller context passed to lineRecvCB.
+ */
+void atcmd_configLineMode(atcmdLineRecv_func lineRecvCB, void *lineCntxt);
+
+
+/**
+ * @brief Opt the next command into the command result cache, for idempotent (read-only) queries.
+ * @details A successful result for the same command string no older than ttlMS is returned by atcmd_awaitResult() without a BGx
+ *          round-trip (response, value and preamble state are restored). Otherwise the command is sent and a successful result is
+ *          cached. Cached results are discarded on BGx restart and on the invalidateOn URC events. Cleared on command completion.
+ *          Results are matched on the full command string, commands of atcmd__cacheCmdSz or longer are not cached. Registration
+ *          URCs are reported only when enabled, without them the TTL alone bounds the age of a result.
+ * 
+ * @param ttlMS Maximum age of a cached result acceptable to the caller.
+ * @param invalidateOn atcmdCacheInval_t event bitmap that invalidates the result stored by this command.
+ */
+void atcmd_configCache(uint32_t ttlMS, uint8_t invalidateOn);
+
+
+/**
+ * @brief Invalidate cached command results.
+ * @param events atcmdCacheInval_t event bitmap, entries registered for any of the events are discarded (atcmdCacheInval_all = all entries).
+ */
+void atcmd_invalidateCache(uint8_t events);
+
+
+/**
+ * @brief Get command result cache counters.
+ * @param [out] hits Count of opted-in commands served from cache.
+ * @param [out] misses Count of opted-in commands sent to the BGx.
+ */
+void atcmd_getCacheStats(uint32_t *hits, uint32_t *misses);
+
+
+/**
+ * @brief Set the AT channel lock hold budget.
+ * @details Multi-step sequences (HTTP request, chunked reads) holding the lock longer than the budget release it at their next
+ *          yield point when another caller is waiting, bounding the wait of control-plane commands.
+ * 
+ * @param budgetMS Hold budget in milliseconds, 0 restores default (LTEMC_ATCMD_LOCK_BUDGET).
+ */
+void atcmd_setLockHoldBudget(uint32_t budgetMS);
+
+
+/**
+ * @brief Get AT channel lock contention metrics (wait times by priority class, longest holder).
+ * @return Pointer to lock statistics.
+ */
+const atcmdLockStats_t *atcmd_getLockStats();
+
+
+/**
+ * @brief Reset AT channel lock contention metrics.
+ */
+void atcmd_resetLockStats();
+
+
 /**
  *	@brief Invokes a BGx AT command using default option values (automatic locking).
  *	@param [in] cmdStrTemplate The command string to send to the BG96 module.
@@ -86,6 +151,24 @@ bool atcmd_tryInvoke(const char *cmdTemplate, ...);
 void atcmd_invokeReuseLock(const char *cmdTemplate, ...);
 
 
+/**
+ *	@brief Invokes a fixed format BGx AT command using default option values (automatic locking).
+ *  @details Command is emitted directly into the TX buffer by typed argument writers (no vsnprintf), see atcmdFmt_t for argument order.
+ *	@param [in] cmdFmt The fixed command format.
+ *  @param [in] variadic "..." arguments for the command format slots: int for numeric, const char* for strings.
+ *  @return True if action was invoked, false if not
+ */
+bool atcmd_tryInvokeFmt(atcmdFmt_t cmdFmt, ...);
+
+
+/**
+ *	@brief Invokes a fixed format BGx AT command without acquiring a lock, using previously set setOptions() values.
+ *	@param [in] cmdFmt The fixed command format.
+ *  @param [in] variadic "..." arguments for the command format slots: int for numeric, const char* for strings.
+ */
+void atcmd_invokeFmtReuseLock(atcmdFmt_t cmdFmt, ...);
+
+
 /**
  *	@brief Closes (completes) a BGx AT command structure and frees action resource (release action lock).
  */
@@ -226,6 +309,26 @@ void atcmd_exitTransparentMode();
 cmdParseRslt_t atcmd_stdResponseParser(const char *preamble, bool preambleReqd, const char *delimiters, uint8_t tokensReqd, uint8_t valueIndx, const char *finale, uint16_t lengthReqd);
 
 
+/**
+ *	@brief Extracts a single line of comma delimited response fields into a caller struct, as described by schema.
+ *  @details Fields are parsed in a single pass, string fields are bounds checked to their member size and always terminated. Parsing
+ *           stops at the line end; members for fields not present in the line are left unchanged.
+ *  @param [in] source - C-string containing response text, parsing begins after schema preamble (if found) or at source.
+ *  @param [in] schema - Response schema, see ATCMD_SCHEMA() and ATCMD_FIELD().
+ *  @param [out] dest - Caller struct to receive field values.
+ *  @param [out] continueAt - (optional: NULL=N/A) Set to start of the following line, for multi-line responses.
+ *  @return True if the preamble (if specified) was found and at least schema fieldsReqd fields were parsed.
+ */
+bool atcmd_parseFields(const char *source, const atcmdSchema_t *schema, void *dest, const char **continueAt);
+
+
+/**
+ *	@brief Extracts fields from the last command response (see atcmd_getResponse()) into a caller struct, as described by schema.
+ *  @return True if the preamble (if specified) was found and at least schema fieldsReqd fields were parsed.
+ */
+bool atcmd_getResponseFields(const atcmdSchema_t *schema, void *dest);
+
+
 // /**
 //  *	@brief LTEmC internal testing parser to capture incoming response until timeout. This is generally not used by end-user applications.
 //  *  @return Parse status result (always pending for this test parser)
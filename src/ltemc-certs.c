@@ -0,0 +1,529 @@
+/** ****************************************************************************
+  \file 
+  \brief Certificate store: content-hashed certificate files on BGx UFS, bound to TLS profiles
+  \author Greg Terrell, LooUQ Incorporated
+
+  \loouq
+
+--------------------------------------------------------------------------------
+
+    This project is released under the GPL-3.0 License.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ 
+***************************************************************************** */
+
+
+#define _DEBUG 0                                // set to non-zero value for PRINTF debugging output, 
+// debugging output options                     // LTEm1c will satisfy PRINTF references with empty definition if not already resolved
+#if _DEBUG > 0
+    asm(".global _printf_float");               // forces build to link in float support for printf
+    #if _DEBUG == 1
+    #define SERIAL_DBG 1                        // enable serial port output using devl host platform serial, 1=wait for port
+    #elif _DEBUG == 2
+    #include <jlinkRtt.h>                       // output debug PRINTF macros to J-Link RTT channel
+    #define PRINTF(c_,f_,__VA_ARGS__...) do { rtt_printf(c_, (f_), ## __VA_ARGS__); } while(0)
+    #endif
+#else
+#define PRINTF(c_, f_, ...) 
+#endif
+
+#define SRCFILE "CRT"                           // create SRCFILE (3 char) MACRO for lq-diagnostics ASSERT
+#include "ltemc-internal.h"
+#include "ltemc-certs.h"
+#include "ltemc-files.h"
+
+#if LTEMC_ENABLE_CERTS                          // module selection, see ltemc-config.h
+
+#define MIN(x, y) (((x) < (y)) ? (x) : (y))
+
+#define SHA256_ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+
+typedef struct sha256Ctx_tag
+{
+    uint32_t state[8];
+    uint64_t length;                            // message bytes processed
+    uint8_t block[64];
+    uint8_t blockLen;
+} sha256Ctx_t;
+
+
+static const uint32_t sha256K[64] = 
+{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+
+static struct                                   // certificate store state, manifest mirrors UFS manifest file
+{
+    certEntry_t manifest[certs__manifestCnt];
+    uint8_t entryCnt;
+    char chunk[certs__chunkSz];                 // stream/upload work buffer
+    const char *blob;                           // certs_store() in memory content
+    uint32_t blobSz;
+    char line[certs__manifestLineSz];           // manifest file load
+    uint16_t lineLen;
+    uint16_t rcvdSz;
+} certStore;
+
+
+// private local declarations
+static resultCode_t S__hashSource(certSource_func source, void *srcCntxt, uint8_t *sha256, uint32_t *size);
+static resultCode_t S__uploadSource(const char *name, certSource_func source, void *srcCntxt);
+static uint16_t S__blobSource(void *srcCntxt, uint32_t offset, char *buffer, uint16_t bufferSz);
+static int16_t S__findEntry(const char *name);
+static resultCode_t S__verifyFile(const char *name, uint32_t size);
+static void S__qflstLineRecv(void *lineCntxt, const char *line, uint16_t lineSz, bool isComplete);
+static void S__removeEntry(int16_t entryIndx);
+static resultCode_t S__writeManifest();
+static void S__manifestRcvr(uint16_t fileHandle, const char *fileData, uint16_t dataSz);
+static void S__parseManifestLine(char *line);
+static void S__sha256Init(sha256Ctx_t *ctx);
+static void S__sha256Update(sha256Ctx_t *ctx, const uint8_t *data, uint32_t dataSz);
+static void S__sha256Final(sha256Ctx_t *ctx, uint8_t *digest);
+static void S__sha256Block(sha256Ctx_t *ctx);
+
+
+#pragma region public functions
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ *	@brief Load the certificate manifest from UFS.
+ */
+resultCode_t certs_init()
+{
+    memset(&certStore, 0, sizeof(certStore));
+
+    uint16_t fileHandle;
+    resultCode_t rslt = file_open(CERTS_MANIFEST_FILENAME, fileOpenMode_rdOnly, &fileHandle);
+    if (rslt == fileErr__result_fileNotFound)
+        return resultCode__success;                                                 // no manifest, empty store
+    if (rslt != resultCode__success)
+        return rslt;
+
+    appRcvProto_func priorRcvr = g_lqLTEM.fileCtrl->appRecvDataCB;                 // loan file receiver, restored after load
+    file_setAppReceiver(S__manifestRcvr);
+    do
+    {
+        certStore.rcvdSz = 0;
+        file_read(fileHandle, certs__chunkSz);
+    } while (certStore.rcvdSz == certs__chunkSz);                                   // short read is end of file
+
+    if (certStore.lineLen > 0)                                                      // last line without line ending
+        S__parseManifestLine(certStore.line);
+
+    file_close(fileHandle);
+    g_lqLTEM.fileCtrl->appRecvDataCB = priorRcvr;
+    PRINTF(dbgColor__info, "certs: manifest %d entries\r", certStore.entryCnt);
+    return resultCode__success;
+}
+
+
+/**
+ *	@brief Store a certificate held in memory.
+ */
+resultCode_t certs_store(const char *name, const char *content, uint32_t contentSz, bool *uploaded)
+{
+    certStore.blob = content;
+    certStore.blobSz = contentSz;
+    return certs_storeStream(name, S__blobSource, NULL, uploaded);
+}
+
+
+/**
+ *	@brief Store a certificate streamed from an application source.
+ */
+resultCode_t certs_storeStream(const char *name, certSource_func source, void *srcCntxt, bool *uploaded)
+{
+    ASSERT(strlen(name) > 0 && strlen(name) < certs__nameSz && source != NULL);
+
+    if (uploaded != NULL)
+        *uploaded = false;
+
+    uint8_t sha256[certs__hashSz];
+    uint32_t size;
+    resultCode_t rslt = S__hashSource(source, srcCntxt, sha256, &size);
+    if (rslt != resultCode__success)
+        return rslt;
+
+    int16_t entryIndx = S__findEntry(name);
+    if (entryIndx >= 0 && certStore.manifest[entryIndx].size == size && memcmp(certStore.manifest[entryIndx].sha256, sha256, certs__hashSz) == 0)
+    {
+        if (!certStore.manifest[entryIndx].verified)                                // manifest entry not yet confirmed against UFS
+        {
+            rslt = S__verifyFile(name, size);
+            if (rslt == resultCode__conflict)
+                return rslt;
+            certStore.manifest[entryIndx].verified = (rslt == resultCode__success);
+        }
+        if (certStore.manifest[entryIndx].verified)
+        {
+            PRINTF(dbgColor__info, "certs: %s current\r", name);
+            return resultCode__success;                                             // content already on BGx
+        }
+        PRINTF(dbgColor__warn, "certs: %s missing or size differs, uploading\r", name);
+    }
+
+    if (entryIndx >= 0)                                                             // drop entry before upload, an interrupted upload is never trusted
+    {
+        S__removeEntry(entryIndx);
+        if ((rslt = S__writeManifest()) != resultCode__success)
+            return rslt;
+    }
+    else if (certStore.entryCnt == certs__manifestCnt)
+        return resultCode__tooManyRequests;                                        // manifest full
+
+    if ((rslt = S__uploadSource(name, source, srcCntxt)) != resultCode__success)
+        return rslt;
+
+    certEntry_t *entry = &certStore.manifest[certStore.entryCnt++];
+    strncpy(entry->name, name, certs__nameSz - 1);
+    entry->size = size;
+    memcpy(entry->sha256, sha256, certs__hashSz);
+    entry->verified = true;                                                         // upload confirmed size
+
+    if (uploaded != NULL)
+        *uploaded = true;
+    PRINTF(dbgColor__info, "certs: %s uploaded (%lu)\r", name, size);
+    return S__writeManifest();
+}
+
+
+/**
+ *	@brief Delete a certificate file and its manifest entry.
+ */
+resultCode_t certs_remove(const char *name)
+{
+    int16_t entryIndx = S__findEntry(name);
+    if (entryIndx < 0)
+        return resultCode__notFound;
+
+    S__removeEntry(entryIndx);
+    resultCode_t rslt = S__writeManifest();
+    if (rslt != resultCode__success)
+        return rslt;
+    return file_delete(name);
+}
+
+
+/**
+ *	@brief Get the manifest entry for a certificate file.
+ */
+const certEntry_t *certs_getEntry(const char *name)
+{
+    int16_t entryIndx = S__findEntry(name);
+    return entryIndx < 0 ? NULL : &certStore.manifest[entryIndx];
+}
+
+
+/**
+ *	@brief Bind a stored certificate to a TLS profile role.
+ */
+resultCode_t certs_bind(tlsProfile_t *profile, certRole_t role, const char *name)
+{
+    if (S__findEntry(name) < 0)
+        return resultCode__notFound;
+
+    char *path = (role == certRole_caCert) ? profile->caCertPath : 
+                 (role == certRole_clientCert) ? profile->clientCertPath : profile->clientKeyPath;
+    strncpy(path, name, tls__certPathSz - 1);
+    path[tls__certPathSz - 1] = '\0';
+    return resultCode__success;
+}
+
+#pragma endregion
+
+
+#pragma region private functions
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ *	@brief Hash pass over source content.
+ */
+static resultCode_t S__hashSource(certSource_func source, void *srcCntxt, uint8_t *sha256, uint32_t *size)
+{
+    sha256Ctx_t ctx;
+    S__sha256Init(&ctx);
+
+    uint32_t offset = 0;
+    uint16_t readSz;
+    while ((readSz = source(srcCntxt, offset, certStore.chunk, certs__chunkSz)) > 0)
+    {
+        S__sha256Update(&ctx, (const uint8_t *)certStore.chunk, readSz);
+        offset += readSz;
+    }
+    S__sha256Final(&ctx, sha256);
+    *size = offset;
+    return offset > 0 ? resultCode__success : resultCode__badRequest;              // empty certificate
+}
+
+
+/**
+ *	@brief Upload pass, source content is streamed to UFS in chunks.
+ */
+static resultCode_t S__uploadSource(const char *name, certSource_func source, void *srcCntxt)
+{
+    uint16_t fileHandle;
+    resultCode_t rslt = file_open(name, fileOpenMode_ovrRdWr, &fileHandle);
+    if (rslt != resultCode__success)
+        return rslt;
+
+    fileWriteResult_t writeResult;
+    uint32_t offset = 0;
+    uint16_t readSz;
+    while ((readSz = source(srcCntxt, offset, certStore.chunk, certs__chunkSz)) > 0)
+    {
+        rslt = file_write(fileHandle, certStore.chunk, readSz, &writeResult);
+        if (rslt != resultCode__success || writeResult.writtenSz != readSz)
+        {
+            rslt = (rslt == resultCode__success) ? resultCode__internalError : rslt;
+            break;
+        }
+        offset += readSz;
+    }
+    file_close(fileHandle);
+    return rslt;
+}
+
+
+/**
+ *	@brief Content source for certs_store() memory content.
+ */
+static uint16_t S__blobSource(void *srcCntxt, uint32_t offset, char *buffer, uint16_t bufferSz)
+{
+    if (offset >= certStore.blobSz)
+        return 0;
+    uint16_t copySz = MIN(bufferSz, certStore.blobSz - offset);
+    memcpy(buffer, certStore.blob + offset, copySz);
+    return copySz;
+}
+
+
+static int16_t S__findEntry(const char *name)
+{
+    for (int16_t i = 0; i < certStore.entryCnt; i++)
+    {
+        if (strcmp(certStore.manifest[i].name, name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+
+/**
+ *	@brief Confirm a certificate file is on UFS with the expected size (AT+QFLST="<name>").
+ *  @return 200 = present with size, 404 = missing or size differs, 409 = lock not available.
+ */
+static resultCode_t S__verifyFile(const char *name, uint32_t size)
+{
+    fileListItem_t fileItem = {0};
+    if (!ATCMD_awaitLock(atcmd__defaultTimeout))
+        return resultCode__conflict;
+
+    atcmd_configLineMode(S__qflstLineRecv, &fileItem);
+    atcmd_invokeReuseLock("AT+QFLST=\"%s\"", name);
+    resultCode_t rslt = atcmd_awaitResult();                                        // CME error if file not found
+    atcmd_close();
+
+    if (rslt == resultCode__success && strcmp(fileItem.filename, name) == 0 && fileItem.fileSz == size)
+        return resultCode__success;
+    return resultCode__notFound;
+}
+
+
+/**
+ *	@brief Line mode receiver for AT+QFLST="<name>": +QFLST: "<filename>",<file_size>
+ */
+static void S__qflstLineRecv(void *lineCntxt, const char *line, uint16_t lineSz, bool isComplete)
+{
+    static const atcmdField_t qflstFields[] = 
+    {
+        ATCMD_FIELD(atcmdField_qstr, fileListItem_t, filename),
+        ATCMD_FIELD(atcmdField_int, fileListItem_t, fileSz)
+    };
+    static const atcmdSchema_t qflstSchema = ATCMD_SCHEMA("+QFLST: ", qflstFields, 2);
+
+    if (isComplete)
+        atcmd_parseFields(line, &qflstSchema, (fileListItem_t*)lineCntxt, NULL);
+}
+
+
+static void S__removeEntry(int16_t entryIndx)
+{
+    certStore.entryCnt--;
+    for (int16_t i = entryIndx; i < certStore.entryCnt; i++)
+        certStore.manifest[i] = certStore.manifest[i + 1];
+    memset(&certStore.manifest[certStore.entryCnt], 0, sizeof(certEntry_t));
+}
+
+
+/**
+ *	@brief Rewrite the UFS manifest file: one "<name>,<size>,<sha256 hex>" line per certificate.
+ */
+static resultCode_t S__writeManifest()
+{
+    uint16_t fileHandle;
+    resultCode_t rslt = file_open(CERTS_MANIFEST_FILENAME, fileOpenMode_ovrRdWr, &fileHandle);
+    if (rslt != resultCode__success)
+        return rslt;
+
+    fileWriteResult_t writeResult;
+    for (size_t i = 0; i < certStore.entryCnt && rslt == resultCode__success; i++)
+    {
+        certEntry_t *entry = &certStore.manifest[i];
+        char *linePtr = certStore.chunk;
+        linePtr += snprintf(linePtr, certs__manifestLineSz, "%s,%lu,", entry->name, (unsigned long)entry->size);
+        for (size_t j = 0; j < certs__hashSz; j++)
+            linePtr += snprintf(linePtr, 3, "%02x", entry->sha256[j]);
+        *linePtr++ = '\n';
+        rslt = file_write(fileHandle, certStore.chunk, linePtr - certStore.chunk, &writeResult);
+    }
+    file_close(fileHandle);
+    return rslt;
+}
+
+
+static void S__manifestRcvr(uint16_t fileHandle, const char *fileData, uint16_t dataSz)
+{
+    certStore.rcvdSz += dataSz;
+    for (uint16_t i = 0; i < dataSz; i++)
+    {
+        if (fileData[i] == '\r' || fileData[i] == '\n')
+        {
+            if (certStore.lineLen > 0)
+                S__parseManifestLine(certStore.line);
+            certStore.lineLen = 0;
+        }
+        else if (certStore.lineLen < certs__manifestLineSz - 1)
+        {
+            certStore.line[certStore.lineLen++] = fileData[i];
+            certStore.line[certStore.lineLen] = '\0';
+        }
+    }
+}
+
+
+/**
+ *	@brief Parse a manifest line: "<name>,<size>,<sha256 hex>", malformed lines are dropped (certificate re-uploaded).
+ */
+static void S__parseManifestLine(char *line)
+{
+    char *sizePtr = strchr(line, ',');
+    if (sizePtr == NULL || sizePtr - line >= certs__nameSz || certStore.entryCnt == certs__manifestCnt)
+        return;
+
+    char *hashPtr;
+    uint32_t size = strtoul(sizePtr + 1, &hashPtr, 10);
+    if (*hashPtr != ',' || strlen(++hashPtr) != 2 * certs__hashSz)
+        return;
+
+    certEntry_t *entry = &certStore.manifest[certStore.entryCnt];
+    memset(entry, 0, sizeof(certEntry_t));
+    memcpy(entry->name, line, sizePtr - line);
+    entry->size = size;
+    for (size_t i = 0; i < certs__hashSz; i++)
+    {
+        char hexByte[3] = { hashPtr[2 * i], hashPtr[2 * i + 1], '\0' };
+        entry->sha256[i] = strtoul(hexByte, NULL, 16);
+    }
+    certStore.entryCnt++;
+}
+
+
+/* SHA-256 (FIPS 180-4), incremental
+ * --------------------------------------------------------------------------------------------- */
+
+static void S__sha256Init(sha256Ctx_t *ctx)
+{
+    static const uint32_t initState[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+    memcpy(ctx->state, initState, sizeof(initState));
+    ctx->length = 0;
+    ctx->blockLen = 0;
+}
+
+
+static void S__sha256Update(sha256Ctx_t *ctx, const uint8_t *data, uint32_t dataSz)
+{
+    for (uint32_t i = 0; i < dataSz; i++)
+    {
+        ctx->block[ctx->blockLen++] = data[i];
+        if (ctx->blockLen == 64)
+        {
+            S__sha256Block(ctx);
+            ctx->blockLen = 0;
+        }
+    }
+    ctx->length += dataSz;
+}
+
+
+static void S__sha256Final(sha256Ctx_t *ctx, uint8_t *digest)
+{
+    uint64_t bitLength = ctx->length * 8;
+    uint8_t pad = 0x80;
+    S__sha256Update(ctx, &pad, 1);
+    pad = 0;
+    while (ctx->blockLen != 56)
+        S__sha256Update(ctx, &pad, 1);
+    for (int i = 7; i >= 0; i--)
+    {
+        uint8_t lengthByte = bitLength >> (i * 8);
+        S__sha256Update(ctx, &lengthByte, 1);
+    }
+    for (size_t i = 0; i < 8; i++)
+    {
+        digest[i * 4] = ctx->state[i] >> 24;
+        digest[i * 4 + 1] = ctx->state[i] >> 16;
+        digest[i * 4 + 2] = ctx->state[i] >> 8;
+        digest[i * 4 + 3] = ctx->state[i];
+    }
+}
+
+
+static void S__sha256Block(sha256Ctx_t *ctx)
+{
+    uint32_t w[64];
+    for (size_t i = 0; i < 16; i++)
+        w[i] = (uint32_t)ctx->block[i * 4] << 24 | (uint32_t)ctx->block[i * 4 + 1] << 16 | (uint32_t)ctx->block[i * 4 + 2] << 8 | ctx->block[i * 4 + 3];
+    for (size_t i = 16; i < 64; i++)
+    {
+        uint32_t s0 = SHA256_ROTR(w[i - 15], 7) ^ SHA256_ROTR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = SHA256_ROTR(w[i - 2], 17) ^ SHA256_ROTR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = ctx->state[0], b = ctx->state[1], c = ctx->state[2], d = ctx->state[3];
+    uint32_t e = ctx->state[4], f = ctx->state[5], g = ctx->state[6], h = ctx->state[7];
+    for (size_t i = 0; i < 64; i++)
+    {
+        uint32_t t1 = h + (SHA256_ROTR(e, 6) ^ SHA256_ROTR(e, 11) ^ SHA256_ROTR(e, 25)) + ((e & f) ^ (~e & g)) + sha256K[i] + w[i];
+        uint32_t t2 = (SHA256_ROTR(a, 2) ^ SHA256_ROTR(a, 13) ^ SHA256_ROTR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+    ctx->state[0] += a; ctx->state[1] += b; ctx->state[2] += c; ctx->state[3] += d;
+    ctx->state[4] += e; ctx->state[5] += f; ctx->state[6] += g; ctx->state[7] += h;
+}
+
+#pragma endregion
+
+#endif  // LTEMC_ENABLE_CERTS
@@ -0,0 +1,134 @@
+/** ****************************************************************************
+  \file 
+  \brief Public API certificate store: content-hashed certificate files on BGx UFS, bound to TLS profiles
+  \author Greg Terrell, LooUQ Incorporated
+
+  \loouq
+
+--------------------------------------------------------------------------------
+
+    This project is released under the GPL-3.0 License.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ 
+***************************************************************************** */
+
+
+#ifndef __LTEMC_CERTS_H__
+#define __LTEMC_CERTS_H__
+
+#include "ltemc-tls.h"
+
+
+enum certs__constants
+{
+    certs__manifestCnt = 8,                         ///< max certificate files tracked by the manifest
+    certs__nameSz = 32,                             ///< max chars (with \0) in a certificate filename
+    certs__hashSz = 32,                             ///< SHA-256 digest size
+    certs__chunkSz = 512,                           ///< stream read and UFS write chunk size
+    certs__manifestLineSz = 112                     ///< "<name>,<size>,<sha256 hex>"
+};
+
+#define CERTS_MANIFEST_FILENAME "certs.mft"
+
+
+/** 
+ *  @brief Role of a certificate file in a TLS context
+*/
+typedef enum certRole_tag
+{
+    certRole_caCert = 0,            ///< trusted CA certificate (QSSLCFG "cacert")
+    certRole_clientCert = 1,        ///< client certificate (QSSLCFG "clientcert")
+    certRole_clientKey = 2          ///< client private key (QSSLCFG "clientkey")
+} certRole_t;
+
+
+/** 
+ *  @brief Manifest entry for a certificate file stored on UFS
+*/
+typedef struct certEntry_tag
+{
+    char name[certs__nameSz];
+    uint32_t size;
+    uint8_t sha256[certs__hashSz];
+    bool verified;                  ///< UFS file confirmed present with manifest size (not persisted, since certs_init())
+} certEntry_t;
+
+
+/** 
+ *  @brief Source of certificate content for a streamed store, invoked twice (hash pass, then upload pass).
+ *  @param srcCntxt [in] Application context passed to certs_storeStream()
+ *  @param offset [in] Offset into the certificate content
+ *  @param buffer [out] Destination for content
+ *  @param bufferSz [in] Max chars to copy
+ *  @return Chars copied, 0 at end of content
+*/
+typedef uint16_t (*certSource_func)(void *srcCntxt, uint32_t offset, char *buffer, uint16_t bufferSz);
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *	@brief Load the certificate manifest from UFS, the single read required at boot.
+ *  @return Result code, 200 = loaded (an absent manifest is an empty store).
+ */
+resultCode_t certs_init();
+
+/**
+ *	@brief Store a certificate (PEM or DER) held in memory, the upload is skipped if the stored content hash matches.
+ *  @param name [in] UFS filename.
+ *  @param content [in] Certificate content.
+ *  @param contentSz [in] Size of content.
+ *  @param uploaded [out] Optional, set true if the file was uploaded.
+ *  @return Result code, 200 = stored (or already current).
+ */
+resultCode_t certs_store(const char *name, const char *content, uint32_t contentSz, bool *uploaded);
+
+/**
+ *	@brief Store a certificate streamed from an application source, the upload is skipped if the stored content hash matches.
+ *  @details A matching manifest entry is trusted after its UFS file is confirmed present with the same size (one AT+QFLST per entry).
+ *  @param name [in] UFS filename.
+ *  @param source [in] Application content source, read once to hash and again if upload is required.
+ *  @param srcCntxt [in] Application context passed to source.
+ *  @param uploaded [out] Optional, set true if the file was uploaded.
+ *  @return Result code, 200 = stored (or already current).
+ */
+resultCode_t certs_storeStream(const char *name, certSource_func source, void *srcCntxt, bool *uploaded);
+
+/**
+ *	@brief Delete a certificate file and its manifest entry.
+ *  @return Result code, 200 = removed, 404 = not in manifest.
+ */
+resultCode_t certs_remove(const char *name);
+
+/**
+ *	@brief Get the manifest entry for a certificate file.
+ *  @return Pointer to entry, NULL if not stored.
+ */
+const certEntry_t *certs_getEntry(const char *name);
+
+/**
+ *	@brief Bind a stored certificate to a TLS profile role, applied to a context by tls_applyProfile() (QSSLCFG "cacert"/"clientcert"/"clientkey").
+ *  @return Result code, 200 = bound, 404 = certificate not stored.
+ */
+resultCode_t certs_bind(tlsProfile_t *profile, certRole_t role, const char *name);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // !__LTEMC_CERTS_H__
@@ -0,0 +1,171 @@
+/** ****************************************************************************
+  \file 
+  \brief LTEmC build configuration: optional module selection and buffer sizing.
+  \author Greg Terrell, LooUQ Incorporated
+
+  \loouq
+
+--------------------------------------------------------------------------------
+
+    This project is released under the GPL-3.0 License.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ 
+***************************************************************************** */
+
+
+#ifndef __LTEMC_CONFIG_H__
+#define __LTEMC_CONFIG_H__
+
+/* Every setting may be overridden from the build (ex: -DLTEMC_ENABLE_MQTT=0 in platformio.ini build_flags) or by editing the 
+ * defaults here. Disabled modules compile to empty translation units, their handlers are not registered with ltem_eventMgr().
+ * Use extras/footprint.sh to report the flash/RAM cost of each module for a configuration.
+ */
+
+
+/* Optional module selection (1=enabled, 0=disabled)
+ * ------------------------------------------------------------------------------------------------------------------------------*/
+#ifndef LTEMC_ENABLE_HEALTH
+#define LTEMC_ENABLE_HEALTH 1                   /// liveness probes and escalating recovery
+#endif
+#ifndef LTEMC_ENABLE_TIME
+#define LTEMC_ENABLE_TIME 1                     /// network time service
+#endif
+#ifndef LTEMC_ENABLE_SCKT
+#define LTEMC_ENABLE_SCKT 1                     /// TCP/UDP/SSL client sockets
+#endif
+#ifndef LTEMC_ENABLE_TLS
+#define LTEMC_ENABLE_TLS 1                      /// SSL/TLS context configuration (required by sockets and MQTT)
+#endif
+#ifndef LTEMC_ENABLE_HTTP
+#define LTEMC_ENABLE_HTTP 1                     /// HTTP(S) GET/POST
+#endif
+#ifndef LTEMC_ENABLE_MQTT
+#define LTEMC_ENABLE_MQTT 1                     /// MQTT(S)
+#endif
+#ifndef LTEMC_ENABLE_FILES
+#define LTEMC_ENABLE_FILES 1                    /// BGx file system
+#endif
+#ifndef LTEMC_ENABLE_CERTS
+#define LTEMC_ENABLE_CERTS 1                    /// certificate store (requires TLS, FILES)
+#endif
+#ifndef LTEMC_ENABLE_GNSS
+#define LTEMC_ENABLE_GNSS 1                     /// GNSS location and NMEA streaming
+#endif
+#ifndef LTEMC_ENABLE_GNSS_ASSIST
+#define LTEMC_ENABLE_GNSS_ASSIST 1              /// GNSS XTRA assistance (requires GNSS, HTTP, FILES, TIME)
+#endif
+#ifndef LTEMC_ENABLE_GNSS_SHARE
+#define LTEMC_ENABLE_GNSS_SHARE 1               /// GNSS/LTE time-sharing (requires GNSS)
+#endif
+#ifndef LTEMC_ENABLE_TRACK
+#define LTEMC_ENABLE_TRACK 1                    /// location track buffer (requires GNSS, TIME)
+#endif
+#ifndef LTEMC_ENABLE_GEOFENCE
+#define LTEMC_ENABLE_GEOFENCE 1                 /// host geofence engine (requires GNSS, FILES)
+#endif
+#ifndef LTEMC_ENABLE_GEO
+#define LTEMC_ENABLE_GEO 1                      /// BGx module geo-fencing
+#endif
+#ifndef LTEMC_ENABLE_GPIO
+#define LTEMC_ENABLE_GPIO 1                     /// BGx GPIO and ADC
+#endif
+
+
+/* Buffer sizing
+ * ------------------------------------------------------------------------------------------------------------------------------*/
+#ifndef LTEMC_RX_BUFFER_SZ
+#define LTEMC_RX_BUFFER_SZ 2000                 /// IOP receive buffer (heap)
+#endif
+#ifndef LTEMC_RX_LEASE_CNT
+#define LTEMC_RX_LEASE_CNT 4                    /// receive regions an application may hold (lease) beyond its receive callback
+#endif
+#ifndef LTEMC_TX_BUFFER_SZ
+#define LTEMC_TX_BUFFER_SZ 1000                 /// IOP transmit buffer (heap)
+#endif
+#ifndef LTEMC_CMD_BUFFER_SZ
+#define LTEMC_CMD_BUFFER_SZ 448                 /// AT command, MQTT(Azure) connect is ~384
+#endif
+#ifndef LTEMC_RESP_BUFFER_SZ
+#define LTEMC_RESP_BUFFER_SZ 120                /// AT command response
+#endif
+#ifndef LTEMC_ATCMD_CACHE_CNT
+#define LTEMC_ATCMD_CACHE_CNT 6                 /// command result cache entries (each ~180 bytes RAM)
+#endif
+#ifndef LTEMC_ATCMD_LOCK_WAITERS
+#define LTEMC_ATCMD_LOCK_WAITERS 4              /// AT channel lock queue depth (concurrent waiting tasks)
+#endif
+#ifndef LTEMC_ATCMD_LOCK_BUDGET
+#define LTEMC_ATCMD_LOCK_BUDGET 2000            /// AT channel lock hold budget (mS), multi-step holders yield to waiters after
+#endif
+#ifndef LTEMC_STREAM_CNT
+#define LTEMC_STREAM_CNT 4                      /// concurrent streams (sockets, MQTT, HTTP), max 6
+#endif
+#ifndef LTEMC_DOWORKER_CNT
+#define LTEMC_DOWORKER_CNT 6                    /// optional module background worker slots
+#endif
+#ifndef LTEMC_URCHANDLER_CNT
+#define LTEMC_URCHANDLER_CNT 4                  /// optional module (non-stream) URC handler slots
+#endif
+#ifndef LTEMC_HOST_URL_SZ
+#define LTEMC_HOST_URL_SZ 100                   /// MQTT/HTTP host URL
+#endif
+#ifndef LTEMC_SCKT_URL_SZ
+#define LTEMC_SCKT_URL_SZ 128                   /// socket host URL/IP address
+#endif
+#ifndef LTEMC_MQTT_TOPICS_CNT
+#define LTEMC_MQTT_TOPICS_CNT 4                 /// subscribed topics per MQTT connection
+#endif
+#ifndef LTEMC_MQTT_TOPIC_NAME_SZ
+#define LTEMC_MQTT_TOPIC_NAME_SZ 90             /// Azure IoTHub typically 50-70 chars
+#endif
+#ifndef LTEMC_MQTT_TOPIC_PROPS_SZ
+#define LTEMC_MQTT_TOPIC_PROPS_SZ 320           /// Azure IoTHub typically 250-300 chars
+#endif
+#ifndef LTEMC_MQTT_CLIENTID_SZ
+#define LTEMC_MQTT_CLIENTID_SZ 20
+#endif
+#ifndef LTEMC_MQTT_USERNAME_SZ
+#define LTEMC_MQTT_USERNAME_SZ 100
+#endif
+#ifndef LTEMC_MQTT_PASSWORD_SZ
+#define LTEMC_MQTT_PASSWORD_SZ 200              /// Azure SAS token ~150-200 chars
+#endif
+
+
+/* Configuration checks
+ * ------------------------------------------------------------------------------------------------------------------------------*/
+#if (LTEMC_ENABLE_SCKT || LTEMC_ENABLE_MQTT) && !LTEMC_ENABLE_TLS
+#error LTEMC_ENABLE_TLS is required by sockets and MQTT
+#endif
+#if LTEMC_ENABLE_CERTS && !(LTEMC_ENABLE_TLS && LTEMC_ENABLE_FILES)
+#error LTEMC_ENABLE_CERTS requires TLS and FILES
+#endif
+#if LTEMC_ENABLE_GNSS_ASSIST && !(LTEMC_ENABLE_GNSS && LTEMC_ENABLE_HTTP && LTEMC_ENABLE_FILES && LTEMC_ENABLE_TIME)
+#error LTEMC_ENABLE_GNSS_ASSIST requires GNSS, HTTP, FILES and TIME
+#endif
+#if (LTEMC_ENABLE_GNSS_SHARE || LTEMC_ENABLE_GEOFENCE) && !LTEMC_ENABLE_GNSS
+#error LTEMC_ENABLE_GNSS is required by GNSS share and geofence
+#endif
+#if LTEMC_ENABLE_TRACK && !(LTEMC_ENABLE_GNSS && LTEMC_ENABLE_TIME)
+#error LTEMC_ENABLE_TRACK requires GNSS and TIME
+#endif
+#if LTEMC_ENABLE_GEOFENCE && !LTEMC_ENABLE_FILES
+#error LTEMC_ENABLE_GEOFENCE requires FILES
+#endif
+#if LTEMC_STREAM_CNT < 1 || LTEMC_STREAM_CNT > 6 || LTEMC_DOWORKER_CNT < 1 || LTEMC_URCHANDLER_CNT < 1 || LTEMC_ATCMD_CACHE_CNT < 1 || LTEMC_ATCMD_LOCK_WAITERS < 1 || LTEMC_RX_LEASE_CNT < 1
+#error LTEmC stream (1-6), worker, URC handler, command cache, lock waiter and RX lease (>0) counts out of range
+#endif
+
+#endif  /* !__LTEMC_CONFIG_H__ */
@@ -46,6 +46,8 @@
 
 extern ltemDevice_t g_lqLTEM;
 
+#if LTEMC_ENABLE_FILES                          // module selection, see ltemc-config.h
+
 
 #define MIN(x, y) (((x) < (y)) ? (x) : (y))
 #define MAX(X, Y) (((X) > (Y)) ? (X) : (Y))
@@ -54,6 +56,15 @@ extern ltemDevice_t g_lqLTEM;
 ------------------------------------------------------------------------------------------------------------------------- */
 static cmdParseRslt_t S__writeStatusParser();
 static resultCode_t S__filesRxHndlr();
+static void S__fileReadDoWork();
+static void S__fileListLineRecv(void *lineCntxt, const char *line, uint16_t lineSz, bool isComplete);
+static void S__openFilesLineRecv(void *lineCntxt, const char *line, uint16_t lineSz, bool isComplete);
+
+typedef struct openFilesCntxt_tag
+{
+    char *fileInfo;                                                     // next write position
+    uint16_t remaining;                                                 // space remaining, excluding '\0'
+} openFilesCntxt_t;
 
 
 
@@ -75,8 +86,19 @@ void file_setAppReceiver(fileReceiver_func fileReceiver)
  */
 resultCode_t file_getFSInfo(filesysInfo_t * fsInfo)
 {
+    static const atcmdField_t ufsFields[] = 
+    {
+        ATCMD_FIELD(atcmdField_int, filesysInfo_t, freeSz),
+        ATCMD_FIELD(atcmdField_int, filesysInfo_t, totalSz)
+    };
+    static const atcmdField_t filesFields[] = 
+    {
+        ATCMD_FIELD(atcmdField_int, filesysInfo_t, filesSz),
+        ATCMD_FIELD(atcmdField_int, filesysInfo_t, filesCnt)
+    };
+    static const atcmdSchema_t ufsSchema = ATCMD_SCHEMA("+QFLDS: ", ufsFields, 2);
+    static const atcmdSchema_t filesSchema = ATCMD_SCHEMA("+QFLDS: ", filesFields, 2);
     resultCode_t rslt;
-    char *workPtr;
 
     if (!ATCMD_awaitLock(atcmd__defaultTimeout))
         return resultCode__conflict;                                    // failed to get lock
@@ -91,9 +113,11 @@ resultCode_t file_getFSInfo(filesysInfo_t * fsInfo)
             break;
         }
         // parse response >>  +QFLDS: <freesize>,<total_size>
-        workPtr = atcmd_getResponse() + file__dataOffset_info;    // skip past +QFLDS: 
-        fsInfo->freeSz = strtol(workPtr, &workPtr, 10);  
-        fsInfo->totalSz = strtol(++workPtr, &workPtr, 10);      // incr past comma, then grab total fileSystem size
+        if (!atcmd_getResponseFields(&ufsSchema, fsInfo))
+        {
+            rslt = resultCode__internalError;
+            break;
+        }
 
         // now get file collection info
         atcmd_invokeReuseLock("AT+QFLDS");
@@ -102,11 +126,9 @@ resultCode_t file_getFSInfo(filesysInfo_t * fsInfo)
         {
             break;
         }
-        // parse response
-        // +QFLDS: <freesize>,<total_size>
-        workPtr = atcmd_getResponse() + file__dataOffset_info;    // skip past +QFLDS: 
-        fsInfo->filesSz = strtol(workPtr, &workPtr, 10);  
-        fsInfo->filesCnt = strtol(++workPtr, &workPtr, 10);     // incr past comma, then grab total fileSystem size
+        // parse response >>  +QFLDS: <files_size>,<files_count>
+        if (!atcmd_getResponseFields(&filesSchema, fsInfo))
+            rslt = resultCode__internalError;
     } while (0);
     
     atcmd_close();
@@ -126,6 +148,8 @@ resultCode_t file_getFilelist(fileListResult_t *fileList, const char* filename)
             break;
         }
 
+        fileList->fileCnt = 0;
+        atcmd_configLineMode(S__fileListLineRecv, fileList);               // +QFLST: <filename>,<file_size> line per file, not limited by response buffer
         if (strlen(filename) == 0)
         {
             fileList->namePattern[0] = '*';
@@ -138,28 +162,6 @@ resultCode_t file_getFilelist(fileListResult_t *fileList, const char* filename)
             atcmd_invokeReuseLock("AT+QFLST=\"%s\"", fileList->namePattern);
         }
         rslt = atcmd_awaitResult();
-        if (rslt != RESULT_CODE_SUCCESS)
-            break;
-
-        // parse response >>  +QFLST: <filename>,<file_size>
-        uint8_t lineNm = 0;
-        char *workPtr = atcmd_getResponse();
-
-        for (size_t i = 0; i < file__fileListMaxCnt; i++)
-        {
-            workPtr += 9;
-            uint8_t len = strchr(workPtr, '"') - workPtr;
-            strncpy(fileList->files[i].filename, workPtr, len);
-            workPtr += len + 2;
-            fileList->files[i].fileSz = strtol(workPtr, &workPtr, 10);
-
-            workPtr += 2;
-            if (*workPtr != '+')
-            {
-                fileList->fileCnt = ++i;
-                break;
-            }
-        }
     } while (0);
 
     atcmd_close();
@@ -188,8 +190,8 @@ resultCode_t file_open(const char* filename, fileOpenMode_t openMode, uint16_t*
                 uint16_t errDetail = atcmd_getErrorDetailCode();
                 if (errDetail == fileErr__detail_fileAlreadyOpen)
                     rslt = fileErr__result_fileAlreadyOpen;
-                else if (errDetail == fileErr__detail_fileAlreadyOpen)
-                    rslt = fileErr__result_fileAlreadyOpen;
+                else if (errDetail == fileErr__detail_fileNotFound)
+                    rslt = fileErr__result_fileNotFound;
             }
             break;
         }
@@ -209,29 +211,17 @@ resultCode_t file_open(const char* filename, fileOpenMode_t openMode, uint16_t*
  */
 resultCode_t file_getOpenFiles(char *fileInfo, uint16_t fileInfoSz)
 {
-    if (atcmd_tryInvoke("AT+QFOPEN?"))
-    {
-        char* workPtr;
-        char* eolPtr;
-        memset(fileInfo, 0, fileInfoSz);                            // init for c-str behavior
+    if (!ATCMD_awaitLock(atcmd__defaultTimeout))
+        return resultCode__conflict;
 
-        if (atcmd_awaitResult() == resultCode__success)
-        {
-            workPtr = atcmd_getResponse();                          // ptr to response
-            while (memcmp(workPtr, "+QFOPEN: ", file__dataOffset_open) == 0)
-            {
-                workPtr += file__dataOffset_open;
-                eolPtr = strchr(workPtr, '\r');
-                memcpy(fileInfo, workPtr, eolPtr - workPtr);
-                fileInfo += eolPtr - workPtr;
-                *fileInfo = '\r';
-                fileInfo++;
-                workPtr = eolPtr + 2;
-            }
-            return resultCode__success;
-        }
-    }
-    return resultCode__conflict;
+    memset(fileInfo, 0, fileInfoSz);                                        // init for c-str behavior
+    openFilesCntxt_t openFilesCntxt = { fileInfo, fileInfoSz - 1 };
+
+    atcmd_configLineMode(S__openFilesLineRecv, &openFilesCntxt);           // +QFOPEN: <filename>,<handle>,<mode> line per open file
+    atcmd_invokeReuseLock("AT+QFOPEN?");
+    resultCode_t rslt = atcmd_awaitResult();
+    atcmd_close();
+    return rslt;
 }
 
 
@@ -282,9 +272,9 @@ resultCode_t file_read(uint16_t fileHandle, uint16_t readSz)
     ASSERT(g_lqLTEM.fileCtrl->appRecvDataCB);                                   // assert that there is a app func registered to receive read data
 
     if (readSz > 0)
-        rslt = atcmd_tryInvoke("AT+QFREAD=%d,%d", fileHandle, readSz);
+        rslt = atcmd_tryInvokeFmt(atcmdFmt_qfread, fileHandle, readSz);
     else
-        rslt = atcmd_tryInvoke("AT+QFREAD=%d", fileHandle);
+        rslt = atcmd_tryInvokeFmt(atcmdFmt_qfreadAll, fileHandle);
 
     if (rslt)
     {
@@ -297,6 +287,54 @@ resultCode_t file_read(uint16_t fileHandle, uint16_t readSz)
 }
 
 
+/**
+ *	@brief Read a file in the background, in chunks delivered to the app receiver.
+ */
+resultCode_t file_readBackground(uint16_t fileHandle, uint32_t readSz, uint16_t chunkSz)
+{
+    ASSERT(g_lqLTEM.fileCtrl->appRecvDataCB);                                   // assert that there is a app func registered to receive read data
+
+    if (g_lqLTEM.fileCtrl->jobActive)
+        return resultCode__conflict;
+
+    g_lqLTEM.fileCtrl->jobHandle = fileHandle;
+    g_lqLTEM.fileCtrl->jobChunkSz = (chunkSz == 0) ? file__readChunkSz : chunkSz;
+    g_lqLTEM.fileCtrl->jobRemaining = (readSz == 0) ? UINT32_MAX : readSz;
+    g_lqLTEM.fileCtrl->jobDelivered = 0;
+    g_lqLTEM.fileCtrl->jobResult = resultCode__unknown;
+    g_lqLTEM.fileCtrl->jobActive = true;
+
+    LTEM_registerDoWorker(S__fileReadDoWork);                                   // chunks are read from ltem_eventMgr()
+    return resultCode__success;
+}
+
+
+/**
+ *	@brief Get the state of the background read.
+ */
+bool file_backgroundReadPending(uint32_t *delivered, resultCode_t *jobResult)
+{
+    if (delivered)
+        *delivered = g_lqLTEM.fileCtrl->jobDelivered;
+    if (jobResult)
+        *jobResult = g_lqLTEM.fileCtrl->jobResult;
+    return g_lqLTEM.fileCtrl->jobActive;
+}
+
+
+/**
+ *	@brief Cancel the background read.
+ */
+void file_cancelBackgroundRead()
+{
+    if (g_lqLTEM.fileCtrl->jobActive)
+    {
+        g_lqLTEM.fileCtrl->jobActive = false;
+        g_lqLTEM.fileCtrl->jobResult = resultCode__cancelled;
+    }
+}
+
+
 resultCode_t file_write(uint16_t fileHandle, const char* writeData, uint16_t writeSz, fileWriteResult_t *writeResult)
 {
     resultCode_t rslt;
@@ -308,7 +346,7 @@ resultCode_t file_write(uint16_t fileHandle, const char* writeData, uint16_t wri
     do
     {
         atcmd_configDataMode(0, "CONNECT", atcmd_stdTxDataHndlr, writeData, writeSz, NULL, false);
-        atcmd_invokeReuseLock("AT+QFWRITE=%d,%d", fileHandle, writeSz);
+        atcmd_invokeFmtReuseLock(atcmdFmt_qfwrite, fileHandle, writeSz);
         rslt = atcmd_awaitResult();
         if (rslt == resultCode__success)                                                        // "CONNECT" prompt result
         {
@@ -398,6 +436,51 @@ resultCode_t file_delete(const char* filename)
  * --------------------------------------------------------------------------------------------- */
 
 
+/**
+ *	@brief Line mode receiver for AT+QFLST, parses a file list entry per line.
+ */
+static void S__fileListLineRecv(void *lineCntxt, const char *line, uint16_t lineSz, bool isComplete)
+{
+    // +QFLST: "<filename>",<file_size>
+    static const atcmdField_t qflstFields[] = 
+    {
+        ATCMD_FIELD(atcmdField_qstr, fileListItem_t, filename),
+        ATCMD_FIELD(atcmdField_int, fileListItem_t, fileSz)
+    };
+    static const atcmdSchema_t qflstSchema = ATCMD_SCHEMA("+QFLST: ", qflstFields, 2);
+
+    fileListResult_t *fileList = (fileListResult_t*)lineCntxt;
+    if (isComplete && 
+        fileList->fileCnt < file__fileListMaxCnt && 
+        atcmd_parseFields(line, &qflstSchema, &fileList->files[fileList->fileCnt], NULL))
+    {
+        fileList->fileCnt++;
+    }
+}
+
+
+/**
+ *	@brief Line mode receiver for AT+QFOPEN?, appends each open file entry (w/o prefix) terminated by '\r'.
+ */
+static void S__openFilesLineRecv(void *lineCntxt, const char *line, uint16_t lineSz, bool isComplete)
+{
+    openFilesCntxt_t *openFiles = (openFilesCntxt_t*)lineCntxt;
+
+    if (isComplete && memcmp(line, "+QFOPEN: ", file__dataOffset_open) == 0)
+    {
+        uint16_t entrySz = MIN(lineSz - file__dataOffset_open, openFiles->remaining);
+        memcpy(openFiles->fileInfo, line + file__dataOffset_open, entrySz);
+        openFiles->fileInfo += entrySz;
+        openFiles->remaining -= entrySz;
+        if (openFiles->remaining > 0)
+        {
+            *openFiles->fileInfo++ = '\r';
+            openFiles->remaining--;
+        }
+    }
+}
+
+
 static cmdParseRslt_t S__writeStatusParser() 
 {
     // +QFWRITE: <written_length>,<total_length>
@@ -405,6 +488,49 @@ static cmdParseRslt_t S__writeStatusParser()
 }
 
 
+/**
+ * @brief Background read worker, reads one chunk per pass (bulk priority) and releases the AT channel.
+ */
+static void S__fileReadDoWork()
+{
+    fileCtrl_t *fileCtrl = g_lqLTEM.fileCtrl;
+
+    if (!fileCtrl->jobActive)
+        return;
+    uint16_t rxVacant = IOP_getRxVacant();                                                              // RX buffer space net of app held (leased) regions
+    if (rxVacant < IOP__rxLeaseHeadroom)                                                                // backpressure: leases outstanding, resume after release
+        return;
+    if (!ATCMD_awaitLockPriority(0, atcmdPriority_bulk, "file-rd"))                                    // channel busy or higher priority waiting, resume next pass
+        return;
+
+    uint16_t rqstSz = MIN(MIN(fileCtrl->jobChunkSz, fileCtrl->jobRemaining), rxVacant / 2);
+    atcmd_configDataMode(0, "CONNECT", S__filesRxHndlr, NULL, 0, fileCtrl->appRecvDataCB, true);
+    atcmd_invokeFmtReuseLock(atcmdFmt_qfread, fileCtrl->jobHandle, rqstSz);
+    fileCtrl->handle = fileCtrl->jobHandle;
+
+    resultCode_t rslt = atcmd_awaitResult();
+    uint16_t readSz = (rslt == resultCode__success) ? atcmd_getValue() : 0;
+    atcmd_close();
+
+    if (!fileCtrl->jobActive)                                                                           // cancelled while chunk underway
+        return;
+    fileCtrl->jobDelivered += readSz;
+    if (fileCtrl->jobRemaining != UINT32_MAX)
+        fileCtrl->jobRemaining -= readSz;
+
+    if (rslt != resultCode__success)
+    {
+        fileCtrl->jobResult = rslt;
+        fileCtrl->jobActive = false;
+    }
+    else if (readSz < rqstSz || fileCtrl->jobRemaining == 0)                                            // short read is EOF
+    {
+        fileCtrl->jobResult = resultCode__success;
+        fileCtrl->jobActive = false;
+    }
+}
+
+
 /**
  * @brief File stream RX data handler, marshalls incoming data from RX buffer to app (application).
  * 
@@ -422,6 +548,7 @@ static resultCode_t S__filesRxHndlr()
     
     cbffr_pop(g_lqLTEM.iop->rxBffr, wrkBffr, popCnt + 2);                                               // pop CONNECT phrase for parsing data length
     uint16_t readSz = strtol(wrkBffr + 8, NULL, 10);
+    g_lqLTEM.atcmd->retValue = readSz;                                                                  // bytes read (short read = EOF)
     uint16_t streamSz = readSz + file__readTrailerSz;
 
     PRINTF(dbgColor__cyan, "filesDataRcvr() fHandle=%d sz=%d\r", g_lqLTEM.fileCtrl->handle, streamSz);
@@ -458,4 +585,6 @@ static resultCode_t S__filesRxHndlr()
 }
 
 
-#pragma endregion
\ No newline at end of file
+#pragma endregion
+
+#endif  // LTEMC_ENABLE_FILES
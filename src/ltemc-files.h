@@ -46,7 +46,8 @@ enum file
     file__handleSearchMax = 20,
     file__dataOffset_pos = 13,          /// +QFPOSITION: 
     file__readTrailerSz = 6,
-    file__readTimeoutMs = 100
+    file__readTimeoutMs = 100,
+    file__readChunkSz = 512             /// background read default chunk size
 };
 
 
@@ -201,6 +202,33 @@ resultCode_t file_closeAll();
 resultCode_t file_read(uint16_t fileHandle, uint16_t readSz);
 
 
+/**
+ *	@brief Read a file in the background, in chunks delivered to the app receiver (file_setAppReceiver()).
+ *  @details Each chunk is a separate AT+QFREAD issued from ltem_eventMgr(), the AT channel is released between chunks so other
+ *  commands interleave with the transfer. Progress is kept in the file control, poll with file_backgroundReadPending().
+ *	@param [in] fileHandle - Numeric handle for the file to read.
+ *	@param [in] readSz - Number of bytes to read, 0 = read to end of file.
+ *	@param [in] chunkSz - Bytes per chunk, 0 = default (file__readChunkSz).
+ *  @return ResultCode=200 if job started, 409 (conflict) if a background read is already underway.
+ */
+resultCode_t file_readBackground(uint16_t fileHandle, uint32_t readSz, uint16_t chunkSz);
+
+
+/**
+ *	@brief Get the state of the background read.
+ *	@param [out] delivered - Bytes delivered to the app receiver so far (optional, NULL).
+ *	@param [out] jobResult - Result of the completed read (optional, NULL): 200 on success or error code.
+ *  @return True while the background read is underway.
+ */
+bool file_backgroundReadPending(uint32_t *delivered, resultCode_t *jobResult);
+
+
+/**
+ *	@brief Cancel the background read, the chunk underway (if any) is completed.
+ */
+void file_cancelBackgroundRead();
+
+
 /**
  *	@brief Closes the file. 
  *	@param [in] fileHandle - Numeric handle for the file to close.
@@ -44,9 +44,22 @@
 #include "ltemc-internal.h"
 #include "ltemc-geo.h"
 
+#if LTEMC_ENABLE_GEO                            // module selection, see ltemc-config.h
+
+#define MIN(x, y) (((x) < (y)) ? (x) : (y))
+
+#define GEO_URC_PREFIX "+QIND: \"GEOFENCE\","         // BG95/BG77 boundary crossing URC: +QIND: "GEOFENCE",<geoId>,<position>
+
+enum geo__constants
+{
+    geo__urcBufferSz = 40,                      /// max chars in a geo-fence URC line
+};
+
+static geoEvent_func S__geoEventCB = NULL;      /// application callback for geo-fence boundary crossings
 
 // private local declarations
-static resultCode_t geoQueryResponseParser(const char *response);
+static cmdParseRslt_t S__geoQueryParser();
+static resultCode_t S__geoUrcHndlr();
 
 
 /* public functions
@@ -64,11 +77,14 @@ resultCode_t geo_add(uint8_t geoId, geoMode_t mode, geoShape_t shape, double lat
 
     char cmdStr[CMDSZ] = {0};
 
-    if (mode != geoMode_noUrc)                                 // currently only supporting mode 0 (no event reporting)
+    if (!QBG_hasFeature(moduleFeature_geofence))
+        return resultCode__methodNotAllowed;                                        // module has no geo-fencing (BG96)
+    if (mode > geoMode_bothUrc)
         return resultCode__badRequest;
+    ASSERT_W(mode == geoMode_noUrc || S__geoEventCB != NULL, "No geo event CB");   // URC modes without a callback are discarded
 
     //void floatToString(float fVal, char *buf, uint8_t bufSz, uint8_t precision)
-    snprintf(cmdStr, CMDSZ, "AT+QCFGEXT=\"addgeo\",%d,0,%d,%4.6f,%4.6f,%4.6f", geoId, shape, lat1, lon1, lat2);
+    snprintf(cmdStr, CMDSZ, "AT+QCFGEXT=\"addgeo\",%d,%d,%d,%4.6f,%4.6f,%4.6f", geoId, mode, shape, lat1, lon1, lat2);
 
     if (shape == geoShape_circlerad && (lon2 != 0 || lat3 != 0 || lon3 != 0 || lat4 != 0 || lon4 != 0) ||
         shape == geoShape_circlept &&  (lat3 != 0 || lon3 != 0 || lat4 != 0 || lon4 != 0) ||
@@ -96,7 +112,7 @@ resultCode_t geo_add(uint8_t geoId, geoMode_t mode, geoShape_t shape, double lat
         strcat(cmdStr, cmdChunk);
     }
 
-    if (atcmd_tryInvokeDefaults(cmdStr))
+    if (atcmd_tryInvoke("%s", cmdStr))
     {
         return atcmd_awaitResult();
     }
@@ -110,9 +126,7 @@ resultCode_t geo_add(uint8_t geoId, geoMode_t mode, geoShape_t shape, double lat
  */
 resultCode_t geo_delete(uint8_t geoId)
 {
-    char cmdStr[28] = {0};
-    snprintf(cmdStr, 80, "AT+QCFGEXT=\"deletegeo\",%d", geoId);
-    if (atcmd_tryInvokeDefaults(cmdStr))
+    if (atcmd_tryInvoke("AT+QCFGEXT=\"deletegeo\",%d", geoId))
     {
         return atcmd_awaitResult();
     }
@@ -126,14 +140,30 @@ resultCode_t geo_delete(uint8_t geoId)
  */
 geoPosition_t geo_query(uint8_t geoId)
 {
+    geoPosition_t position = geoPosition_unknown;
+
     if (atcmd_tryInvoke("AT+QCFGEXT=\"querygeo\",%d", geoId))
     {
-        if (atcmd_awaitResult() != resultCode__success)
-            return geoPosition_unknown;
-        return resultCode__success;
+        if (atcmd_awaitResultWithOptions(atcmd__defaultTimeout, S__geoQueryParser) == resultCode__success)
+        {
+            int32_t posCheck = atcmd_getValue();
+            if (posCheck == geoPosition_inside || posCheck == geoPosition_outside)
+                position = (geoPosition_t)posCheck;
+        }
+        atcmd_close();
     }
-    return resultCode__conflict;
-};
+    return position;
+}
+
+
+/**
+ *	@brief Register the application callback for geo-fence boundary crossing events (geoMode_enterUrc/exitUrc/bothUrc).
+ */
+void geo_setEventCallback(geoEvent_func eventCB)
+{
+    S__geoEventCB = eventCB;
+    LTEM_registerUrcHandler(S__geoUrcHndlr);                    // boundary URCs are serviced by ltem_eventMgr(), no polling
+}
 
 
 
@@ -144,12 +174,50 @@ geoPosition_t geo_query(uint8_t geoId)
 #pragma region private functions
 
 /**
- *	\brief Action response parser for a geo-fence query.
+ *	\brief Action response parser for a geo-fence query: +QCFGEXT: "querygeo",<geoId>,<posCheck>
  */
-static resultCode_t geoQueryResponseParser(const char *response)
+static cmdParseRslt_t S__geoQueryParser()
 {
-    return serviceResponseParser(response, "+QCFGEXT: \"querygeo\",");
+    return atcmd_stdResponseParser("+QCFGEXT: \"querygeo\",", true, ",", 2, 2, "OK\r\n", 0);
+}
+
+
+/**
+ *	\brief URC handler for geo-fence boundary crossings, offered URCs by ltem_eventMgr().
+ *  \return resultCode__cancelled if the URC is not a geo-fence event, otherwise the service result.
+ */
+static resultCode_t S__geoUrcHndlr()
+{
+    cBuffer_t* rxBffr = g_lqLTEM.iop->rxBffr;                                       // for convenience
+
+    if (cbffr_find(rxBffr, GEO_URC_PREFIX, 0, 0, false) != 0)                       // not a geo-fence URC at tail, leading data belongs to other handlers
+        return resultCode__cancelled;
+
+    int16_t eolIndx = cbffr_find(rxBffr, "\r\n", 0, 0, false);
+    if (CBFFR_NOTFOUND(eolIndx))
+        return resultCode__cancelled;                                               // URC incomplete, serviced when line is received
+
+    char urcBffr[geo__urcBufferSz] = {0};
+    uint16_t popSz = MIN((uint16_t)eolIndx, geo__urcBufferSz - 1);
+    cbffr_pop(rxBffr, urcBffr, popSz);
+    cbffr_skipTail(rxBffr, eolIndx - popSz + 2);                                    // discard any overlong remainder and line end
+
+    char *workPtr = urcBffr + strlen(GEO_URC_PREFIX);
+    geoResult_t result = { .geoId = strtol(workPtr, &workPtr, 10), .position = geoPosition_unknown };
+    if (*workPtr == ',')
+    {
+        int32_t posCheck = strtol(workPtr + 1, NULL, 10);
+        if (posCheck == geoPosition_inside || posCheck == geoPosition_outside)
+            result.position = (geoPosition_t)posCheck;
+    }
+    PRINTF(dbgColor__cyan, "geoURC: id=%d, pos=%d\r", result.geoId, result.position);
+
+    if (S__geoEventCB != NULL)
+        S__geoEventCB(&result);
+    return resultCode__success;
 }
 
 
 #pragma endregion
+
+#endif  // LTEMC_ENABLE_GEO
@@ -72,6 +72,12 @@ typedef enum geoShape_tag
 } geoShape_t;
 
 
+/** 
+ *  \brief Callback for geo-fence boundary crossing events, registered with geo_setEventCallback().
+*/
+typedef void (*geoEvent_func)(geoResult_t *result);
+
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -79,6 +85,7 @@ extern "C" {
 
 /**
  *	@brief Create a geo-fence for future position evaluations.
+ *  @return Result code, 200 = created, 400 = bad mode or shape coordinates, 405 = module has no geo-fencing.
  */
 resultCode_t geo_add(uint8_t geoId, geoMode_t mode, geoShape_t shape, double lat1, double lon1, double lat2, double lon2, double lat3, double lon3, double lat4, double lon4);
 
@@ -95,6 +102,14 @@ resultCode_t geo_delete(uint8_t geoId);
 geoPosition_t geo_query(uint8_t geoId);
 
 
+/**
+ *	@brief Register the application callback for geo-fence boundary crossing events.
+ *  @details Fences added with geoMode_enterUrc/exitUrc/bothUrc report crossings as URCs serviced by ltem_eventMgr(), no geo_query() polling required.
+ *  @param eventCB [in] - Application callback invoked with the fence ID and new position.
+ */
+void geo_setEventCallback(geoEvent_func eventCB);
+
+
 #ifdef __cplusplus
 }
 #endif
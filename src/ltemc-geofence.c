@@ -0,0 +1,575 @@
+/** ****************************************************************************
+  \file 
+  \brief Public API host geofence engine: circle/polygon fences with grid index, hysteresis and events
+  \author Greg Terrell, LooUQ Incorporated
+
+  \loouq
+
+--------------------------------------------------------------------------------
+
+    This project is released under the GPL-3.0 License.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ 
+***************************************************************************** */
+
+
+#define _DEBUG 0                                // set to non-zero value for PRINTF debugging output, 
+// debugging output options                     // LTEm1c will satisfy PRINTF references with empty definition if not already resolved
+#if _DEBUG > 0
+    asm(".global _printf_float");               // forces build to link in float support for printf
+    #if _DEBUG == 1
+    #define SERIAL_DBG 1                        // enable serial port output using devl host platform serial, 1=wait for port
+    #elif _DEBUG == 2
+    #include <jlinkRtt.h>                       // output debug PRINTF macros to J-Link RTT channel
+    #define PRINTF(c_,f_,__VA_ARGS__...) do { rtt_printf(c_, (f_), ## __VA_ARGS__); } while(0)
+    #endif
+#else
+#define PRINTF(c_, f_, ...) 
+#endif
+
+#define SRCFILE "GFN"                           // create SRCFILE (3 char) MACRO for lq-diagnostics ASSERT
+#include "ltemc-internal.h"
+#include "ltemc-geofence.h"
+#include "ltemc-files.h"
+
+#if LTEMC_ENABLE_GEOFENCE                       // module selection, see ltemc-config.h
+
+#define GEOFENCE_CELLKEY_UNINDEXED 0xFFFFFFFF   // large fences, evaluated on every fix
+
+#define MIN(x, y) (((x) < (y)) ? (x) : (y))
+#define MAX(x, y) (((x) > (y)) ? (x) : (y))
+
+
+// private local declarations
+static resultCode_t S__addFence(geofenceSet_t *set, geofence_t *fence);
+static void S__buildIndex(geofenceSet_t *set);
+static uint32_t S__cellKey(geofenceSet_t *set, int32_t latitude, int32_t longitude);
+static uint16_t S__indexEntries(geofenceSet_t *set, const geofence_t *fence);
+static int S__cellCompare(const void *cellA, const void *cellB);
+static uint16_t S__lowerBound(geofenceSet_t *set, uint32_t cellKey);
+static void S__evalFence(geofenceSet_t *set, uint16_t fenceIndx, const gnssFix_t *fix);
+static bool S__isInside(geofence_t *fence, int32_t latitude, int32_t longitude, uint16_t margin);
+static void S__setActive(geofenceSet_t *set, uint16_t fenceIndx, bool active);
+static void S__fileRcvr(uint16_t fileHandle, const char *fileData, uint16_t dataSz);
+static void S__parseFileLine(char *line);
+static int32_t S__parseMicroDeg(const char *src, char **endPtr);
+
+static struct                                   // geofence_loadFile() receive state
+{
+    geofenceSet_t *set;
+    char line[geofence__fileLineSz];
+    uint16_t lineLen;
+    uint16_t rcvdSz;
+    resultCode_t rslt;
+} fileLoad;
+
+
+#pragma region public functions
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ *	@brief Initialize a geofence set.
+ */
+void geofence_init(geofenceSet_t *set, geofence_t *fences, uint16_t capacity, geofenceCell_t *cells, uint16_t cellCapacity, geofenceEvent_func eventCB)
+{
+    ASSERT(fences != NULL && cells != NULL && capacity > 0 && cellCapacity >= capacity);
+
+    memset(set, 0, sizeof(geofenceSet_t));
+    set->fences = fences;
+    set->capacity = capacity;
+    set->cells = cells;
+    set->cellCapacity = cellCapacity;
+    set->eventCB = eventCB;
+    set->cellSize = geofence__defaultCellSize;
+    set->confirmCnt = geofence__defaultConfirmCnt;
+    set->margin = geofence__defaultMargin;
+}
+
+
+/**
+ *	@brief Set grid cell size and hysteresis.
+ */
+void geofence_configure(geofenceSet_t *set, int32_t cellSizeMicroDeg, uint8_t confirmCnt, uint16_t marginM, uint16_t dwellSecs)
+{
+    ASSERT(cellSizeMicroDeg >= geofence__minCellSize);
+
+    set->cellSize = cellSizeMicroDeg;
+    set->confirmCnt = MAX(confirmCnt, 1);
+    set->margin = marginM;
+    set->dwellTime = PERIOD_FROM_SECONDS(dwellSecs);
+    set->indexValid = false;
+}
+
+
+/**
+ *	@brief Add a circular fence.
+ */
+resultCode_t geofence_addCircle(geofenceSet_t *set, uint16_t fenceId, int32_t latitude, int32_t longitude, uint16_t radiusM)
+{
+    geofence_t fence = {0};
+    fence.fenceId = fenceId;
+    fence.type = geofenceType_circle;
+    fence.vertexCnt = 1;
+    fence.radius = radiusM;
+    fence.vertices[0].latitude = latitude;
+    fence.vertices[0].longitude = longitude;
+
+    int32_t latSpan = (int32_t)radiusM * 1000 / gnss__mmPerMicroDeg + 1;            // microdegrees
+    uint16_t cosLat = GNSS_cosLatitude(latitude);                                   // same longitude scale as GNSS_distance()
+    int32_t lonSpan = (cosLat > 0) ? (int64_t)latSpan * 1000 / cosLat + 1 : 180000000;
+    fence.bboxMin.latitude = latitude - latSpan;
+    fence.bboxMax.latitude = latitude + latSpan;
+    fence.bboxMin.longitude = MAX(longitude - lonSpan, -180000000);
+    fence.bboxMax.longitude = MIN(longitude + lonSpan, 179999999);
+    return S__addFence(set, &fence);
+}
+
+
+/**
+ *	@brief Add a polygon fence.
+ */
+resultCode_t geofence_addPolygon(geofenceSet_t *set, uint16_t fenceId, const geofenceVertex_t *vertices, uint8_t vertexCnt)
+{
+    if (vertexCnt < 3 || vertexCnt > geofence__polyMaxVertices)
+        return resultCode__badRequest;
+
+    geofence_t fence = {0};
+    fence.fenceId = fenceId;
+    fence.type = geofenceType_polygon;
+    fence.vertexCnt = vertexCnt;
+    memcpy(fence.vertices, vertices, vertexCnt * sizeof(geofenceVertex_t));
+
+    fence.bboxMin = fence.bboxMax = vertices[0];
+    for (uint8_t i = 1; i < vertexCnt; i++)
+    {
+        fence.bboxMin.latitude = MIN(fence.bboxMin.latitude, vertices[i].latitude);
+        fence.bboxMin.longitude = MIN(fence.bboxMin.longitude, vertices[i].longitude);
+        fence.bboxMax.latitude = MAX(fence.bboxMax.latitude, vertices[i].latitude);
+        fence.bboxMax.longitude = MAX(fence.bboxMax.longitude, vertices[i].longitude);
+    }
+    return S__addFence(set, &fence);
+}
+
+
+/**
+ *	@brief Remove a fence.
+ */
+resultCode_t geofence_remove(geofenceSet_t *set, uint16_t fenceId)
+{
+    for (uint16_t i = 0; i < set->count; i++)
+    {
+        if (set->fences[i].fenceId == fenceId)
+        {
+            set->count--;
+            memmove(&set->fences[i], &set->fences[i + 1], (set->count - i) * sizeof(geofence_t));
+            set->activeCnt = 0;                                                     // fence indexes shifted, rebuild active list
+            set->activeOverflow = false;
+            for (uint16_t j = 0; j < set->count; j++)
+            {
+                if (set->fences[j].state >= geofenceState_inside || set->fences[j].contraryCnt > 0)
+                    S__setActive(set, j, true);
+            }
+            set->indexValid = false;
+            return resultCode__success;
+        }
+    }
+    return resultCode__notFound;
+}
+
+
+/**
+ *	@brief Load fences from a BGx file (UFS), appended to the set.
+ */
+resultCode_t geofence_loadFile(geofenceSet_t *set, const char *filename)
+{
+    uint16_t fileHandle;
+    resultCode_t rslt = file_open(filename, fileOpenMode_rdOnly, &fileHandle);
+    if (rslt != resultCode__success)
+        return rslt;
+
+    appRcvProto_func priorRcvr = g_lqLTEM.fileCtrl->appRecvDataCB;                 // loan file receiver, restored after load
+    file_setAppReceiver(S__fileRcvr);
+
+    memset(&fileLoad, 0, sizeof(fileLoad));
+    fileLoad.set = set;
+    fileLoad.rslt = resultCode__success;
+    do
+    {
+        fileLoad.rcvdSz = 0;
+        file_read(fileHandle, geofence__fileReadSz);
+    } while (fileLoad.rcvdSz == geofence__fileReadSz);                              // short read is end of file
+
+    if (fileLoad.lineLen > 0)                                                       // last line without line ending
+        S__parseFileLine(fileLoad.line);
+
+    file_close(fileHandle);
+    g_lqLTEM.fileCtrl->appRecvDataCB = priorRcvr;
+    return fileLoad.rslt;
+}
+
+
+/**
+ *	@brief Evaluate a fix against the set.
+ */
+void geofence_evaluate(geofenceSet_t *set, const gnssFix_t *fix)
+{
+    if (!fix->valid)
+        return;
+    if (!set->indexValid)
+        S__buildIndex(set);
+
+    if (++set->evalSeq == 0)                                                        // 0 is never evaluated (new fence)
+        set->evalSeq = 1;
+    uint32_t cellKeys[2] = { S__cellKey(set, fix->latitude, fix->longitude), GEOFENCE_CELLKEY_UNINDEXED };
+
+    for (uint8_t k = 0; k < 2; k++)                                                 // fix cell, then large (unindexed) fences
+    {
+        for (uint16_t c = S__lowerBound(set, cellKeys[k]); c < set->cellCnt && set->cells[c].cellKey == cellKeys[k]; c++)
+        {
+            S__evalFence(set, set->cells[c].fenceIndx, fix);
+        }
+    }
+
+    for (uint8_t a = 0; a < set->activeCnt; a++)                                   // active fences not in the fix cell (exits)
+    {
+        uint16_t fenceIndx = set->active[a];
+        if (set->fences[fenceIndx].evalSeq != set->evalSeq)
+        {
+            uint8_t activeCnt = set->activeCnt;
+            S__evalFence(set, fenceIndx, fix);
+            if (set->activeCnt < activeCnt)                                         // removed from active, list shifted
+                a--;
+        }
+    }
+
+    if (set->activeOverflow)                                                        // active fences beyond the list, found by scan until list has room
+    {
+        set->activeOverflow = false;                                                // re-set by S__setActive() if still full
+        for (uint16_t f = 0; f < set->count; f++)
+        {
+            geofence_t *fence = &set->fences[f];
+            if (fence->state < geofenceState_inside && fence->contraryCnt == 0)
+                continue;
+            if (fence->evalSeq != set->evalSeq)
+                S__evalFence(set, f, fix);
+            else
+                S__setActive(set, f, true);                                         // evaluated this fix, listed now if room (or still overflowed)
+        }
+    }
+}
+
+
+/**
+ *	@brief Get the current state for a fence.
+ */
+geofenceState_t geofence_getState(geofenceSet_t *set, uint16_t fenceId)
+{
+    for (uint16_t i = 0; i < set->count; i++)
+    {
+        if (set->fences[i].fenceId == fenceId)
+            return set->fences[i].state;
+    }
+    return geofenceState_unknown;
+}
+
+#pragma endregion
+
+
+#pragma region Static Function Definitions
+/* --------------------------------------------------------------------------------------------- */
+
+static resultCode_t S__addFence(geofenceSet_t *set, geofence_t *fence)
+{
+    for (uint16_t i = 0; i < set->count; i++)
+    {
+        if (set->fences[i].fenceId == fence->fenceId)
+            return resultCode__conflict;
+    }
+    if (set->count == set->capacity)
+        return resultCode__tooManyRequests;
+
+    uint32_t indexEntries = S__indexEntries(set, fence);
+    for (uint16_t i = 0; i < set->count; i++)
+    {
+        indexEntries += S__indexEntries(set, &set->fences[i]);
+    }
+    if (indexEntries > set->cellCapacity)                                           // index storage undersized for fence set
+        return resultCode__tooManyRequests;
+
+    memcpy(&set->fences[set->count++], fence, sizeof(geofence_t));
+    set->indexValid = false;
+    return resultCode__success;
+}
+
+
+/**
+ *	@brief Rebuild the grid index: an entry per fence per cell covered by its bounding box, sorted by cell key.
+ */
+static void S__buildIndex(geofenceSet_t *set)
+{
+    set->cellCnt = 0;
+    for (uint16_t f = 0; f < set->count; f++)
+    {
+        geofence_t *fence = &set->fences[f];
+        uint32_t keyMin = S__cellKey(set, fence->bboxMin.latitude, fence->bboxMin.longitude);
+        uint32_t keyMax = S__cellKey(set, fence->bboxMax.latitude, fence->bboxMax.longitude);
+        uint16_t latCells = (keyMax >> 16) - (keyMin >> 16) + 1;
+        uint16_t lonCells = (keyMax & 0xFFFF) - (keyMin & 0xFFFF) + 1;
+        uint16_t reserved = set->count - f - 1;                                     // at least one entry for each remaining fence
+
+        if ((uint32_t)latCells * lonCells > geofence__cellsPerFenceMax ||
+            set->cellCnt + (uint32_t)latCells * lonCells + reserved > set->cellCapacity)   // storage exhausted (cell size reduced after add)
+        {
+            set->cells[set->cellCnt].cellKey = GEOFENCE_CELLKEY_UNINDEXED;
+            set->cells[set->cellCnt++].fenceIndx = f;
+            continue;
+        }
+        for (uint16_t latCell = 0; latCell < latCells; latCell++)
+        {
+            for (uint16_t lonCell = 0; lonCell < lonCells; lonCell++)
+            {
+                set->cells[set->cellCnt].cellKey = keyMin + ((uint32_t)latCell << 16) + lonCell;
+                set->cells[set->cellCnt++].fenceIndx = f;
+            }
+        }
+    }
+    qsort(set->cells, set->cellCnt, sizeof(geofenceCell_t), S__cellCompare);
+    set->indexValid = true;
+}
+
+
+static uint32_t S__cellKey(geofenceSet_t *set, int32_t latitude, int32_t longitude)
+{
+    uint32_t latCell = (uint32_t)(latitude + 90000000) / set->cellSize;
+    uint32_t lonCell = (uint32_t)(longitude + 180000000) / set->cellSize;
+    return (latCell << 16) | (lonCell & 0xFFFF);
+}
+
+
+/**
+ *	@brief Index entries for a fence at the current cell size, 1 if the fence is unindexed.
+ */
+static uint16_t S__indexEntries(geofenceSet_t *set, const geofence_t *fence)
+{
+    uint32_t keyMin = S__cellKey(set, fence->bboxMin.latitude, fence->bboxMin.longitude);
+    uint32_t keyMax = S__cellKey(set, fence->bboxMax.latitude, fence->bboxMax.longitude);
+    uint32_t cells = ((keyMax >> 16) - (keyMin >> 16) + 1) * ((keyMax & 0xFFFF) - (keyMin & 0xFFFF) + 1);
+    return (cells > geofence__cellsPerFenceMax) ? 1 : cells;
+}
+
+
+static int S__cellCompare(const void *cellA, const void *cellB)
+{
+    uint32_t keyA = ((const geofenceCell_t *)cellA)->cellKey;
+    uint32_t keyB = ((const geofenceCell_t *)cellB)->cellKey;
+    return (keyA > keyB) - (keyA < keyB);
+}
+
+
+/**
+ *	@brief Binary search for the first index entry with cellKey.
+ */
+static uint16_t S__lowerBound(geofenceSet_t *set, uint32_t cellKey)
+{
+    uint16_t lo = 0;
+    uint16_t hi = set->cellCnt;
+    while (lo < hi)
+    {
+        uint16_t mid = lo + (hi - lo) / 2;
+        if (set->cells[mid].cellKey < cellKey)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+
+/**
+ *	@brief Evaluate one fence with hysteresis: a crossing is confirmed after confirmCnt consecutive contrary fixes.
+ */
+static void S__evalFence(geofenceSet_t *set, uint16_t fenceIndx, const gnssFix_t *fix)
+{
+    geofence_t *fence = &set->fences[fenceIndx];
+    if (fence->evalSeq == set->evalSeq)                                             // already evaluated for this fix
+        return;
+    fence->evalSeq = set->evalSeq;
+
+    bool wasInside = fence->state >= geofenceState_inside;
+    bool inside = S__isInside(fence, fix->latitude, fix->longitude, wasInside ? set->margin : 0);
+
+    if (fence->state == geofenceState_unknown)                                      // first evaluation, no confirmation
+    {
+        fence->state = inside ? geofenceState_inside : geofenceState_outside;
+        fence->contraryCnt = inside ? set->confirmCnt : 0;                          // forces enter event below
+        wasInside = !inside;
+        if (!inside)
+            return;
+    }
+
+    if (inside != wasInside)
+    {
+        if (++fence->contraryCnt >= set->confirmCnt)
+        {
+            fence->contraryCnt = 0;
+            fence->state = inside ? geofenceState_inside : geofenceState_outside;
+            fence->enteredAt = pMillis();
+            if (set->eventCB != NULL)
+                (set->eventCB)(fence, inside ? geofenceEvent_enter : geofenceEvent_exit, fix);
+        }
+    }
+    else
+    {
+        fence->contraryCnt = 0;
+        if (fence->state == geofenceState_inside && set->dwellTime > 0 && pMillis() - fence->enteredAt >= set->dwellTime)
+        {
+            fence->state = geofenceState_dwelling;
+            if (set->eventCB != NULL)
+                (set->eventCB)(fence, geofenceEvent_dwell, fix);
+        }
+    }
+    S__setActive(set, fenceIndx, fence->state >= geofenceState_inside || fence->contraryCnt > 0);
+}
+
+
+static bool S__isInside(geofence_t *fence, int32_t latitude, int32_t longitude, uint16_t margin)
+{
+    if (fence->type == geofenceType_circle)
+        return GNSS_distance(fence->vertices[0].latitude, fence->vertices[0].longitude, latitude, longitude) <= (uint32_t)fence->radius + margin;
+
+    if (latitude < fence->bboxMin.latitude || latitude > fence->bboxMax.latitude || 
+        longitude < fence->bboxMin.longitude || longitude > fence->bboxMax.longitude)
+        return false;
+
+    bool inside = false;                                                            // ray casting (even-odd)
+    for (uint8_t i = 0, j = fence->vertexCnt - 1; i < fence->vertexCnt; j = i++)
+    {
+        const geofenceVertex_t *vi = &fence->vertices[i];
+        const geofenceVertex_t *vj = &fence->vertices[j];
+        if ((vi->latitude > latitude) != (vj->latitude > latitude))
+        {
+            int64_t crossLon = (int64_t)(vj->longitude - vi->longitude) * (latitude - vi->latitude) / (vj->latitude - vi->latitude) + vi->longitude;
+            if (longitude < crossLon)
+                inside = !inside;
+        }
+    }
+    return inside;
+}
+
+
+static void S__setActive(geofenceSet_t *set, uint16_t fenceIndx, bool active)
+{
+    for (uint8_t a = 0; a < set->activeCnt; a++)
+    {
+        if (set->active[a] == fenceIndx)
+        {
+            if (!active)
+            {
+                set->activeCnt--;
+                memmove(&set->active[a], &set->active[a + 1], (set->activeCnt - a) * sizeof(uint16_t));
+            }
+            return;
+        }
+    }
+    if (active)
+    {
+        if (set->activeCnt < geofence__activeMax)
+            set->active[set->activeCnt++] = fenceIndx;
+        else
+            set->activeOverflow = true;                                             // tracked by full scan in geofence_evaluate()
+    }
+}
+
+
+/**
+ *	@brief File receiver for geofence_loadFile(), assembles lines across read blocks.
+ */
+static void S__fileRcvr(uint16_t fileHandle, const char *fileData, uint16_t dataSz)
+{
+    fileLoad.rcvdSz += dataSz;
+    for (uint16_t i = 0; i < dataSz; i++)
+    {
+        if (fileData[i] == '\r' || fileData[i] == '\n')
+        {
+            if (fileLoad.lineLen > 0)
+                S__parseFileLine(fileLoad.line);
+            fileLoad.lineLen = 0;
+        }
+        else if (fileLoad.lineLen < geofence__fileLineSz - 1)
+        {
+            fileLoad.line[fileLoad.lineLen++] = fileData[i];
+            fileLoad.line[fileLoad.lineLen] = '\0';
+        }
+    }
+}
+
+
+/**
+ *	@brief Parse a fence definition: "C,<id>,<lat>,<lon>,<radiusM>" or "P,<id>,<lat>,<lon>,<lat>,<lon>,..."
+ */
+static void S__parseFileLine(char *line)
+{
+    if (line[0] != 'C' && line[0] != 'P')                                           // comment or blank
+        return;
+
+    char *parsePtr = line + 1;
+    uint16_t fenceId = strtol(parsePtr + 1, &parsePtr, 10);
+    resultCode_t rslt;
+
+    if (line[0] == 'C')
+    {
+        int32_t latitude = S__parseMicroDeg(parsePtr + 1, &parsePtr);
+        int32_t longitude = S__parseMicroDeg(parsePtr + 1, &parsePtr);
+        uint16_t radius = strtol(parsePtr + 1, &parsePtr, 10);
+        rslt = geofence_addCircle(fileLoad.set, fenceId, latitude, longitude, radius);
+    }
+    else
+    {
+        geofenceVertex_t vertices[geofence__polyMaxVertices];
+        uint8_t vertexCnt = 0;
+        while (*parsePtr == ',' && vertexCnt < geofence__polyMaxVertices)
+        {
+            vertices[vertexCnt].latitude = S__parseMicroDeg(parsePtr + 1, &parsePtr);
+            vertices[vertexCnt++].longitude = S__parseMicroDeg(parsePtr + 1, &parsePtr);
+        }
+        rslt = geofence_addPolygon(fileLoad.set, fenceId, vertices, vertexCnt);
+    }
+    if (rslt != resultCode__success)
+        fileLoad.rslt = rslt;                                                       // report last error, continue loading
+}
+
+
+/**
+ *	@brief Parse decimal degrees to microdegrees without floating point.
+ */
+static int32_t S__parseMicroDeg(const char *src, char **endPtr)
+{
+    bool negative = (*src == '-');
+    int32_t microDeg = labs(strtol(src, endPtr, 10)) * 1000000;
+    if (**endPtr == '.')
+    {
+        int32_t scale = 100000;
+        for ((*endPtr)++; **endPtr >= '0' && **endPtr <= '9'; (*endPtr)++)
+        {
+            microDeg += (**endPtr - '0') * scale;
+            scale /= 10;
+        }
+    }
+    return negative ? -microDeg : microDeg;
+}
+
+#pragma endregion
+
+#endif  // LTEMC_ENABLE_GEOFENCE
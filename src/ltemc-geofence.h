@@ -0,0 +1,203 @@
+/** ****************************************************************************
+  \file 
+  \brief Public API host geofence engine: circle/polygon fences with grid index, hysteresis and events
+  \author Greg Terrell, LooUQ Incorporated
+
+  \loouq
+
+--------------------------------------------------------------------------------
+
+    This project is released under the GPL-3.0 License.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ 
+***************************************************************************** */
+
+
+#ifndef __LTEMC_GEOFENCE_H__
+#define __LTEMC_GEOFENCE_H__
+
+#include "ltemc-gnss.h"
+
+
+enum geofence__constants
+{
+    geofence__polyMaxVertices = 8,
+    geofence__activeMax = 16,                       ///< fences tracked while inside (or transition pending), beyond this fences are found by scan
+    geofence__cellsPerFenceMax = 64,                ///< fences spanning more cells are checked on every fix (no index)
+    geofence__defaultCellSize = 10000,              ///< grid cell size in microdegrees (~1.1km latitude)
+    geofence__minCellSize = 5500,                   ///< grid cell coordinates are 16 bits
+    geofence__defaultConfirmCnt = 2,                ///< consecutive fixes required to confirm a crossing
+    geofence__defaultMargin = 20,                   ///< circle exit margin (metres)
+    geofence__fileLineSz = 160,
+    geofence__fileReadSz = 256
+};
+
+
+typedef enum geofenceType_tag
+{
+    geofenceType_circle = 0,        ///< center vertex and radius
+    geofenceType_polygon = 1        ///< 3 to geofence__polyMaxVertices vertices, closed implicitly
+} geofenceType_t;
+
+
+typedef enum geofenceState_tag
+{
+    geofenceState_unknown = 0,      ///< not yet evaluated
+    geofenceState_outside,
+    geofenceState_inside,
+    geofenceState_dwelling          ///< inside for at least the dwell time
+} geofenceState_t;
+
+
+typedef enum geofenceEvent_tag
+{
+    geofenceEvent_enter = 1,
+    geofenceEvent_exit = 2,
+    geofenceEvent_dwell = 3
+} geofenceEvent_t;
+
+
+typedef struct geofenceVertex_tag
+{
+    int32_t latitude;               ///< microdegrees
+    int32_t longitude;              ///< microdegrees
+} geofenceVertex_t;
+
+
+/** 
+ *  \brief Geofence definition and its evaluation state.
+*/
+typedef struct geofence_tag
+{
+    uint16_t fenceId;                                       ///< application ID for the fence
+    geofenceType_t type;
+    uint8_t vertexCnt;
+    uint16_t radius;                                        ///< circle radius (metres)
+    geofenceVertex_t vertices[geofence__polyMaxVertices];   ///< polygon vertices, circle center is vertices[0]
+    geofenceVertex_t bboxMin;                               ///< bounding box (index and quick reject)
+    geofenceVertex_t bboxMax;
+    geofenceState_t state;                                  ///< current (confirmed) state
+    uint8_t contraryCnt;                                    ///< consecutive fixes contrary to the state (hysteresis)
+    uint32_t enteredAt;                                     ///< tick count when entry was confirmed (dwell)
+    uint16_t evalSeq;                                       ///< set evaluation this fence was last evaluated in
+} geofence_t;
+
+
+/** 
+ *  \brief Grid index entry, the index is sorted by cell key.
+*/
+typedef struct geofenceCell_tag
+{
+    uint32_t cellKey;
+    uint16_t fenceIndx;
+} geofenceCell_t;
+
+
+/** 
+ *  \brief Callback for geofence events.
+*/
+typedef void (*geofenceEvent_func)(const geofence_t *fence, geofenceEvent_t event, const gnssFix_t *fix);
+
+
+/** 
+ *  \brief Geofence set: fences, grid index and hysteresis settings. Storage is provided by the application.
+*/
+typedef struct geofenceSet_tag
+{
+    geofence_t *fences;
+    uint16_t capacity;
+    uint16_t count;
+    geofenceCell_t *cells;                                  ///< grid index storage
+    uint16_t cellCapacity;
+    uint16_t cellCnt;
+    bool indexValid;                                        ///< index rebuilt at next evaluate after add/remove
+    int32_t cellSize;                                       ///< grid cell size (microdegrees)
+    uint8_t confirmCnt;                                     ///< consecutive fixes to confirm a crossing
+    uint16_t margin;                                        ///< circle exit margin (metres)
+    uint32_t dwellTime;                                     ///< dwell event after inside this long (mS), 0 = no dwell events
+    geofenceEvent_func eventCB;
+    uint16_t active[geofence__activeMax];                   ///< fences inside or with a pending transition
+    uint8_t activeCnt;
+    bool activeOverflow;                                    ///< fences active beyond the list, evaluate scans the set for them
+    uint16_t evalSeq;                                       ///< evaluation (fix) sequence, a fence is evaluated once per fix
+} geofenceSet_t;
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *	@brief Initialize a geofence set.
+ *  @param [in] set Geofence set control, allocated by application.
+ *  @param [in] fences Fence storage.
+ *  @param [in] capacity Number of fences in storage.
+ *  @param [in] cells Grid index storage, size for fences x cells spanned (typically 1-4 per fence).
+ *  @param [in] cellCapacity Number of index entries in storage.
+ *  @param [in] eventCB Callback for enter/exit/dwell events.
+ */
+void geofence_init(geofenceSet_t *set, geofence_t *fences, uint16_t capacity, geofenceCell_t *cells, uint16_t cellCapacity, geofenceEvent_func eventCB);
+
+/**
+ *	@brief Set grid cell size and hysteresis.
+ *  @param [in] cellSizeMicroDeg Grid cell size, size near the typical fence size.
+ *  @param [in] confirmCnt Consecutive fixes required to confirm a crossing.
+ *  @param [in] marginM Circle exit margin (metres).
+ *  @param [in] dwellSecs Seconds inside before a dwell event, 0 = no dwell events.
+ */
+void geofence_configure(geofenceSet_t *set, int32_t cellSizeMicroDeg, uint8_t confirmCnt, uint16_t marginM, uint16_t dwellSecs);
+
+/**
+ *	@brief Add a circular fence.
+ *  @return Result code, 200 = added, 409 = fence ID exists, 429 = set (or index) is full.
+ */
+resultCode_t geofence_addCircle(geofenceSet_t *set, uint16_t fenceId, int32_t latitude, int32_t longitude, uint16_t radiusM);
+
+/**
+ *	@brief Add a polygon fence.
+ *  @return Result code, 200 = added, 400 = vertex count, 409 = fence ID exists, 429 = set (or index) is full.
+ */
+resultCode_t geofence_addPolygon(geofenceSet_t *set, uint16_t fenceId, const geofenceVertex_t *vertices, uint8_t vertexCnt);
+
+/**
+ *	@brief Remove a fence.
+ *  @return Result code, 200 = removed, 404 = not found.
+ */
+resultCode_t geofence_remove(geofenceSet_t *set, uint16_t fenceId);
+
+/**
+ *	@brief Load fences from a BGx file (UFS), appended to the set.
+ *  @details Text, one fence per line, decimal degrees: "C,<id>,<lat>,<lon>,<radiusM>" or "P,<id>,<lat>,<lon>,<lat>,<lon>,..."
+ *  @return Result code, 200 = loaded, otherwise file or fence error.
+ */
+resultCode_t geofence_loadFile(geofenceSet_t *set, const char *filename);
+
+/**
+ *	@brief Evaluate a fix against the set, events are delivered to the set callback.
+ *  @details Only fences in the fix's grid cell and fences the device is currently inside are evaluated.
+ */
+void geofence_evaluate(geofenceSet_t *set, const gnssFix_t *fix);
+
+/**
+ *	@brief Get the current state for a fence.
+ */
+geofenceState_t geofence_getState(geofenceSet_t *set, uint16_t fenceId);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // !__LTEMC_GEOFENCE_H__
@@ -0,0 +1,276 @@
+/** ****************************************************************************
+  \file 
+  \brief Public API GNSS assistance: XTRA download/injection and time-to-first-fix reporting
+  \author Greg Terrell, LooUQ Incorporated
+
+  \loouq
+
+--------------------------------------------------------------------------------
+
+    This project is released under the GPL-3.0 License.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ 
+***************************************************************************** */
+
+
+#define _DEBUG 0                                // set to non-zero value for PRINTF debugging output, 
+// debugging output options                     // LTEm1c will satisfy PRINTF references with empty definition if not already resolved
+#if _DEBUG > 0
+    asm(".global _printf_float");               // forces build to link in float support for printf
+    #if _DEBUG == 1
+    #define SERIAL_DBG 1                        // enable serial port output using devl host platform serial, 1=wait for port
+    #elif _DEBUG == 2
+    #include <jlinkRtt.h>                       // output debug PRINTF macros to J-Link RTT channel
+    #define PRINTF(c_,f_,__VA_ARGS__...) do { rtt_printf(c_, (f_), ## __VA_ARGS__); } while(0)
+    #endif
+#else
+#define PRINTF(c_, f_, ...) 
+#endif
+
+#define SRCFILE "GNA"                           // create SRCFILE (3 char) MACRO for lq-diagnostics ASSERT
+#include "ltemc-internal.h"
+#include "ltemc-gnss-assist.h"
+#include "ltemc-files.h"
+
+extern ltemDevice_t g_lqLTEM;
+
+#if LTEMC_ENABLE_GNSS_ASSIST                    // module selection, see ltemc-config.h
+
+static gnssAssistCtrl_t gnssAssist;             // assistance controls and status
+
+
+// private local declarations
+static resultCode_t S__injectTime();
+static resultCode_t S__readXtraValidity();
+static void S__gnssAssistDoWork();
+static cmdParseRslt_t S__xtraDataParser();
+
+
+/*
+ *  AT+QGPSXTRATIME=0,"2019/11/17,02:00:00",1,1,3500    (UTC, force, utc, uncertainty mS)
+ *  AT+QGPSXTRADATA="UFS:xtra2.bin"
+ *  AT+QGPSXTRADATA?
+ *  +QGPSXTRADATA: 10080,"2019/11/17,01:59:45"          (valid duration minutes, XTRA start time)
+ * --------------------------------------------------------------------------------------------- */
+
+
+#pragma region public functions
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ *	@brief Initialize GNSS assistance and enable XTRA in BGx.
+ */
+resultCode_t gnssAssist_init(httpCtrl_t *httpCtrl, const char *xtraPath, uint16_t refreshHours)
+{
+    ASSERT(httpCtrl != NULL && !STREMPTY(xtraPath));
+
+    memset(&gnssAssist, 0, sizeof(gnssAssistCtrl_t));
+    gnssAssist.httpCtrl = httpCtrl;
+    strncpy(gnssAssist.xtraPath, xtraPath, gnssAssist__xtraPathSz - 1);
+    gnssAssist.refreshPeriod = PERIOD_FROM_SECONDS((uint32_t)refreshHours * 3600);
+
+    resultCode_t rslt = resultCode__conflict;
+    if (atcmd_tryInvoke("AT+QGPSXTRA=1"))                                          // persistent, effective after BGx restart
+    {
+        rslt = atcmd_awaitResult();
+        gnssAssist.status.xtraEnabled = (rslt == resultCode__success);
+    }
+    if (gnssAssist.status.xtraEnabled)
+    {
+        S__readXtraValidity();                                                      // XTRA injected before a host restart may still be valid
+        bool xtraCurrent = gnssAssist.status.xtraValidUntil > 0 && (!time_isSynced() || gnssAssist.status.xtraValid);
+        gnssAssist.refreshedAt = pMillis();                                         // current data: next refresh is a period out
+        if (!xtraCurrent)
+            gnssAssist.refreshedAt -= PERIOD_FROM_SECONDS(gnssAssist__retrySecs);   // none or expired: due at first opportunity
+        LTEM_registerDoWorker(S__gnssAssistDoWork);
+    }
+    return rslt;
+}
+
+
+/**
+ *	@brief Download XTRA data to BGx file system and inject it.
+ */
+resultCode_t gnssAssist_refresh()
+{
+    ASSERT(gnssAssist.httpCtrl != NULL);
+
+    if (gnssAssist.gnssOn)
+        return resultCode__conflict;                                                // data link unavailable during GNSS session (BG95/BG77)
+    if (!time_isSynced())
+        return resultCode__preConditionFailed;                                      // XTRATIME must be injected before XTRADATA
+
+    gnssAssist.refreshedAt = pMillis();
+
+    resultCode_t rslt = http_get(gnssAssist.httpCtrl, gnssAssist.xtraPath, false);
+    if (rslt != resultCode__success)
+        return rslt;
+
+    rslt = http_readPageToFile(gnssAssist.httpCtrl, GNSSASSIST_XTRA_FILENAME);
+    if (rslt != resultCode__success)
+        return rslt;
+
+    rslt = S__injectTime();
+    if (rslt == resultCode__success && atcmd_tryInvoke("AT+QGPSXTRADATA=\"%s\"", GNSSASSIST_XTRA_FILENAME))
+    {
+        rslt = atcmd_awaitResult();
+    }
+    file_delete(GNSSASSIST_XTRA_FILENAME);                                          // BGx has copied data, release UFS space
+
+    if (rslt == resultCode__success)
+        rslt = S__readXtraValidity();
+
+    PRINTF(dbgColor__info, "XTRA refresh rslt=%d, validUntil=%lu\r", rslt, gnssAssist.status.xtraValidUntil);
+    return rslt;
+}
+
+
+/**
+ *	@brief Start an assisted GNSS session.
+ */
+resultCode_t gnssAssist_on()
+{
+    if (gnssAssist.status.xtraEnabled && !gnssAssist.status.xtraValid)
+        gnssAssist_refresh();                                                       // best effort, a failed refresh does not prevent a fix
+
+    gnssAssist.status.timeInjected = (S__injectTime() == resultCode__success);      // warm/hot start needs time, BGx may not have it after power cycle
+
+    resultCode_t rslt = gnss_on();
+    if (rslt == resultCode__success || rslt == 504)                                 // 504 = session is already ongoing
+    {
+        gnssAssist.gnssOn = true;
+        gnssAssist.gnssOnAt = pMillis();
+        gnssAssist.status.ttff = 0;
+        rslt = resultCode__success;
+    }
+    return rslt;
+}
+
+
+/**
+ *	@brief End the assisted GNSS session.
+ */
+resultCode_t gnssAssist_off()
+{
+    gnssAssist.gnssOn = false;
+    return gnss_off();
+}
+
+
+/**
+ *	@brief Get location (fixed-point), recording time-to-first-fix and the last known position.
+ */
+resultCode_t gnssAssist_getLocation(gnssFix_t *fix)
+{
+    resultCode_t rslt = gnss_getLocationFix(fix);
+    if (rslt == resultCode__success && fix->valid)
+    {
+        if (gnssAssist.gnssOn && gnssAssist.status.ttff == 0)
+        {
+            gnssAssist.status.ttff = pMillis() - gnssAssist.gnssOnAt;
+            PRINTF(dbgColor__info, "GNSS TTFF=%lums (xtra=%d, time=%d)\r", gnssAssist.status.ttff, gnssAssist.status.xtraValid, gnssAssist.status.timeInjected);
+        }
+        memcpy(&gnssAssist.status.lastFix, fix, sizeof(gnssFix_t));
+    }
+    return rslt;
+}
+
+
+/**
+ *	@brief Get assistance status.
+ */
+const gnssAssistStatus_t *gnssAssist_getStatus()
+{
+    uint32_t utcNow = ltem_getUtc();
+    if (utcNow > 0)
+        gnssAssist.status.xtraValid = utcNow + gnssAssist__expiryMarginSecs < gnssAssist.status.xtraValidUntil;
+    return &gnssAssist.status;
+}
+
+#pragma endregion
+
+
+#pragma region Static Function Definitions
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ *	@brief Inject UTC time from the time service into BGx GNSS.
+ */
+static resultCode_t S__injectTime()
+{
+    char dateTime[time__dateTimeSz];
+    if (!time_getUtcDateTime(dateTime))                                             // YYYY-MM-DDTHH:MM:SSZ
+        return resultCode__preConditionFailed;
+
+    dateTime[4] = '/';                                                              // to BGx format: YYYY/MM/DD,HH:MM:SS
+    dateTime[7] = '/';
+    dateTime[10] = ',';
+    dateTime[19] = '\0';
+
+    if (atcmd_tryInvoke("AT+QGPSXTRATIME=0,\"%s\",1,1,%d", dateTime, gnssAssist__xtraTimeUncertainty))
+        return atcmd_awaitResult();
+    return resultCode__conflict;
+}
+
+
+/**
+ *	@brief Query BGx for injected XTRA data validity window.
+ */
+static resultCode_t S__readXtraValidity()
+{
+    resultCode_t rslt = resultCode__conflict;
+    if (atcmd_tryInvoke("AT+QGPSXTRADATA?"))
+    {
+        rslt = atcmd_awaitResultWithOptions(atcmd__defaultTimeout, S__xtraDataParser);
+        if (rslt == resultCode__success)
+        {
+            char *responsePtr;
+            uint32_t validMinutes = strtol(atcmd_getResponse(), &responsePtr, 10);
+            uint32_t xtraStart = time_parseDateTime(responsePtr);
+
+            gnssAssist.status.xtraValidUntil = (validMinutes > 0 && xtraStart > 0) ? xtraStart + validMinutes * 60 : 0;
+        }
+    }
+    gnssAssist_getStatus();                                                         // update xtraValid
+    return rslt;
+}
+
+
+/**
+ *	@brief Scheduled XTRA refresh, only between GNSS sessions.
+ */
+static void S__gnssAssistDoWork()
+{
+    if (gnssAssist.gnssOn || !time_isSynced())
+        return;
+
+    uint32_t sinceRefresh = pMillis() - gnssAssist.refreshedAt;
+    if (gnssAssist_getStatus()->xtraValid ? 
+        (gnssAssist.refreshPeriod > 0 && sinceRefresh >= gnssAssist.refreshPeriod) :       // valid, scheduled refresh (if set)
+        sinceRefresh >= PERIOD_FROM_SECONDS(gnssAssist__retrySecs))                         // none/expired, retry hourly
+    {
+        gnssAssist_refresh();
+    }
+}
+
+
+static cmdParseRslt_t S__xtraDataParser()
+{
+    return atcmd_stdResponseParser("+QGPSXTRADATA: ", true, ",", 0, 0, "OK\r\n", 0);
+}
+
+#pragma endregion
+
+#endif  // LTEMC_ENABLE_GNSS_ASSIST
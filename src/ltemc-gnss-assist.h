@@ -0,0 +1,127 @@
+/** ****************************************************************************
+  \file 
+  \brief Public API GNSS assistance: XTRA download/injection and time-to-first-fix reporting
+  \author Greg Terrell, LooUQ Incorporated
+
+  \loouq
+
+--------------------------------------------------------------------------------
+
+    This project is released under the GPL-3.0 License.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ 
+***************************************************************************** */
+
+
+#ifndef __LTEMC_GNSS_ASSIST_H__
+#define __LTEMC_GNSS_ASSIST_H__
+
+#include "ltemc-gnss.h"
+#include "ltemc-http.h"
+
+
+enum gnssAssist__constants
+{
+    gnssAssist__xtraPathSz = 64,
+    gnssAssist__defaultRefreshHours = 24,           ///< XTRA files are valid for 1-7 days (by file type), refresh well ahead of expiry
+    gnssAssist__expiryMarginSecs = 14400,           ///< XTRA considered expired this many seconds ahead of its validity end
+    gnssAssist__retrySecs = 3600,                   ///< refresh retry period while XTRA data is invalid (none, expired or failed refresh)
+    gnssAssist__xtraTimeUncertainty = 3500          ///< QGPSXTRATIME time uncertainty (mS), time service is +/-1 sec
+};
+
+#define GNSSASSIST_XTRA_FILENAME "UFS:xtra2.bin"
+
+
+/** 
+ *  \brief GNSS assistance status, including the time-to-first-fix of the most recent GNSS session.
+*/
+typedef struct gnssAssistStatus_tag
+{
+    bool xtraEnabled;               ///< XTRA enabled in BGx (AT+QGPSXTRA=1)
+    bool xtraValid;                 ///< XTRA data injected and not expired
+    uint32_t xtraValidUntil;        ///< UTC (seconds since 1970) when injected XTRA data expires
+    bool timeInjected;              ///< UTC time injected at last gnssAssist_on()
+    uint32_t ttff;                  ///< time-to-first-fix (mS) of the last GNSS session, 0 if no fix yet
+    gnssFix_t lastFix;              ///< last known position (valid=false if none)
+} gnssAssistStatus_t;
+
+
+/** 
+ *  \brief GNSS assistance controls.
+*/
+typedef struct gnssAssistCtrl_tag
+{
+    httpCtrl_t *httpCtrl;                           ///< HTTP control, connection set by application to XTRA server
+    char xtraPath[gnssAssist__xtraPathSz];          ///< relative URL of XTRA file on server, ex: "/xtra2.bin"
+    uint32_t refreshPeriod;                         ///< scheduled refresh period (mS)
+    uint32_t refreshedAt;                           ///< tick count of the last XTRA refresh attempt
+    bool gnssOn;                                    ///< GNSS session active (started with gnssAssist_on())
+    uint32_t gnssOnAt;                              ///< tick count when the GNSS session started
+    gnssAssistStatus_t status;
+} gnssAssistCtrl_t;
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *	@brief Initialize GNSS assistance and enable XTRA in BGx.
+ *  @details BGx requires a module restart after XTRA is first enabled (setting is persistent).
+ *  @param [in] httpCtrl HTTP control with connection set to the XTRA server, ex: "http://xtrapath1.izatcloud.net".
+ *  @param [in] xtraPath Relative URL of the XTRA file, ex: "/xtra2.bin" (BG96) or "/xtra3grc.bin" (BG95/BG77).
+ *  @param [in] refreshHours XTRA scheduled refresh period in hours, 0 = refresh only as it expires.
+ *  @return Result code representing status of operation, OK = 200.
+ */
+resultCode_t gnssAssist_init(httpCtrl_t *httpCtrl, const char *xtraPath, uint16_t refreshHours);
+
+/**
+ *	@brief Download XTRA data to BGx file system and inject it. Requires the LTE data link (GNSS off on BG95/BG77).
+ *  @return Result code representing status of operation, OK = 200.
+ */
+resultCode_t gnssAssist_refresh();
+
+/**
+ *	@brief Start an assisted GNSS session: refresh XTRA if expired, inject UTC time, then turn GNSS on.
+ *  @return Result code representing status of operation, OK = 200.
+ */
+resultCode_t gnssAssist_on();
+
+/**
+ *	@brief End the assisted GNSS session and turn GNSS off.
+ *  @return Result code representing status of operation, OK = 200.
+ */
+resultCode_t gnssAssist_off();
+
+/**
+ *	@brief Get location (fixed-point), the first valid fix of a session records time-to-first-fix and all valid fixes 
+ *  update the last known position.
+ *  @param [out] fix Caller's struct to receive the location.
+ *  @return Result code representing status of operation, OK = 200.
+ */
+resultCode_t gnssAssist_getLocation(gnssFix_t *fix);
+
+/**
+ *	@brief Get assistance status: XTRA validity, time injection and TTFF of the last GNSS session.
+ *  @return Pointer to the status (read only).
+ */
+const gnssAssistStatus_t *gnssAssist_getStatus();
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // !__LTEMC_GNSS_ASSIST_H__
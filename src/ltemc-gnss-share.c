@@ -0,0 +1,241 @@
+/** ****************************************************************************
+  \file 
+  \brief Public API GNSS/LTE time-sharing coordinator for single-radio modules (BG95/BG77)
+  \author Greg Terrell, LooUQ Incorporated
+
+  \loouq
+
+--------------------------------------------------------------------------------
+
+    This project is released under the GPL-3.0 License.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ 
+***************************************************************************** */
+
+
+#define _DEBUG 0                                // set to non-zero value for PRINTF debugging output, 
+// debugging output options                     // LTEm1c will satisfy PRINTF references with empty definition if not already resolved
+#if _DEBUG > 0
+    asm(".global _printf_float");               // forces build to link in float support for printf
+    #if _DEBUG == 1
+    #define SERIAL_DBG 1                        // enable serial port output using devl host platform serial, 1=wait for port
+    #elif _DEBUG == 2
+    #include <jlinkRtt.h>                       // output debug PRINTF macros to J-Link RTT channel
+    #define PRINTF(c_,f_,__VA_ARGS__...) do { rtt_printf(c_, (f_), ## __VA_ARGS__); } while(0)
+    #endif
+#else
+#define PRINTF(c_, f_, ...) 
+#endif
+
+#define SRCFILE "GSH"                           // create SRCFILE (3 char) MACRO for lq-diagnostics ASSERT
+#include "ltemc-internal.h"
+#include "ltemc-gnss-share.h"
+
+extern ltemDevice_t g_lqLTEM;
+
+#if LTEMC_ENABLE_GNSS_SHARE                     // module selection, see ltemc-config.h
+
+static gnssShareCtrl_t gnssShare = 
+{
+    .policy = { gnssShare__defaultMaxBlackout, gnssShare__defaultBatchWindow, gnssShare__defaultMinDataPeriod, false, NULL }
+};
+
+
+// private local declarations
+static void S__gnssShareDoWork();
+static void S__setState(gnssShareState_t newState);
+static resultCode_t S__setRadioPriority(bool gnssPriority);
+static void S__deliverFix(resultCode_t rslt);
+
+
+/*
+ *  BG95/BG77: AT+QGPSCFG="priority",<0=GNSS|1=WWAN>,0      (single radio, GNSS and LTE time-shared)
+ *  BG96: GNSS and LTE concurrent, no radio switch (window still used to batch requests)
+ * --------------------------------------------------------------------------------------------- */
+
+
+#pragma region public functions
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ *	@brief Set time-sharing policy.
+ */
+void gnssShare_setPolicy(const gnssSharePolicy_t *policy)
+{
+    ASSERT(policy->maxBlackout > 0);
+    memcpy(&gnssShare.policy, policy, sizeof(gnssSharePolicy_t));
+}
+
+
+/**
+ *	@brief Request a GNSS fix, batched with other pending requests.
+ */
+bool gnssShare_requestFix(gnssShareFix_func fixCB, void *userCntxt)
+{
+    ASSERT(fixCB != NULL);
+
+    if (gnssShare.requestCnt == gnssShare__requestMax)
+        return false;
+
+    if (gnssShare.requestCnt == 0)
+        gnssShare.firstRequestAt = pMillis();
+
+    gnssShare.requests[gnssShare.requestCnt].fixCB = fixCB;
+    gnssShare.requests[gnssShare.requestCnt].userCntxt = userCntxt;
+    gnssShare.requestCnt++;
+
+    LTEM_registerDoWorker(S__gnssShareDoWork);
+    return true;
+}
+
+
+/**
+ *	@brief Test if LTE data is currently unavailable due to a GNSS window.
+ */
+bool gnssShare_isDataBlackout()
+{
+    return gnssShare.state == gnssShareState_draining || gnssShare.state == gnssShareState_gnssActive;
+}
+
+
+/**
+ *	@brief Get coordinator state.
+ */
+gnssShareState_t gnssShare_getState()
+{
+    return gnssShare.state;
+}
+
+
+/**
+ *	@brief Get the duration of the last LTE data blackout (mS).
+ */
+uint32_t gnssShare_getLastBlackout()
+{
+    return gnssShare.lastBlackout;
+}
+
+#pragma endregion
+
+
+#pragma region Static Function Definitions
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ *	@brief Coordinator state machine, invoked by ltem_eventMgr() when no command is underway.
+ */
+static void S__gnssShareDoWork()
+{
+    switch (gnssShare.state)
+    {
+        case gnssShareState_idle:
+            if (gnssShare.requestCnt > 0 &&
+                pMillis() - gnssShare.firstRequestAt >= gnssShare.policy.batchWindow &&
+                (gnssShare.dataResumedAt == 0 || pMillis() - gnssShare.dataResumedAt >= gnssShare.policy.minDataPeriod))
+            {
+                if (gnssShare.policy.drainCB != NULL)
+                    (gnssShare.policy.drainCB)();                                   // application flushes queued publishes while LTE is up (before blackout)
+                S__setState(gnssShareState_draining);
+            }
+            break;
+
+        case gnssShareState_draining:
+            if (S__setRadioPriority(true) != resultCode__success)                   // radio not switched, LTE data was never suspended
+            {
+                S__deliverFix(resultCode__conflict);
+                S__setState(gnssShareState_idle);
+                break;
+            }
+            gnssShare.windowAt = pMillis();
+            if (gnss_on() != resultCode__success)                                   // 504 = already on, poll continues
+            {
+                PRINTF(dbgColor__warn, "gnssShare: gnss_on() failed\r");
+            }
+            S__setState(gnssShareState_gnssActive);
+            break;
+
+        case gnssShareState_gnssActive:
+            if (pMillis() - gnssShare.pollAt < gnssShare__pollInterval)
+                break;
+            gnssShare.pollAt = pMillis();
+
+            if (gnss_getLocationFix(&gnssShare.fix) == resultCode__success && gnssShare.fix.valid)
+            {
+                S__deliverFix(resultCode__success);
+                S__setState(gnssShareState_restoring);
+            }
+            else if (pMillis() - gnssShare.windowAt >= gnssShare.policy.maxBlackout)
+            {
+                S__deliverFix(resultCode__timeout);
+                S__setState(gnssShareState_restoring);
+            }
+            break;
+
+        case gnssShareState_restoring:
+            gnss_off();
+            S__setRadioPriority(false);
+            gnssShare.lastBlackout = pMillis() - gnssShare.windowAt;
+
+            if (gnssShare.policy.reopenStreams)
+                LTEM_reestablishStreams();
+            gnssShare.dataResumedAt = pMillis();
+            S__setState(gnssShareState_idle);
+            PRINTF(dbgColor__info, "gnssShare: LTE resumed, blackout=%lums\r", gnssShare.lastBlackout);
+            break;
+    }
+}
+
+
+static void S__setState(gnssShareState_t newState)
+{
+    PRINTF(dbgColor__dCyan, "gnssShare: state %d > %d\r", gnssShare.state, newState);
+    gnssShare.state = newState;
+    gnssShare.pollAt = 0;
+}
+
+
+/**
+ *	@brief Switch single radio between GNSS and WWAN (LTE), no-op for modules with concurrent GNSS.
+ */
+static resultCode_t S__setRadioPriority(bool gnssPriority)
+{
+    if (QBG_hasFeature(moduleFeature_gnssConcurrent))
+        return resultCode__success;
+
+    if (atcmd_tryInvoke("AT+QGPSCFG=\"priority\",%d,0", gnssPriority ? 0 : 1))
+        return atcmd_awaitResult();
+    return resultCode__conflict;
+}
+
+
+/**
+ *	@brief Deliver the window result to all batched requests, requests made during delivery are kept for the next window.
+ */
+static void S__deliverFix(resultCode_t rslt)
+{
+    uint8_t deliverCnt = gnssShare.requestCnt;
+    gnssShareRequest_t requests[gnssShare__requestMax];
+    memcpy(requests, gnssShare.requests, sizeof(requests));
+    gnssShare.requestCnt = 0;
+
+    for (uint8_t i = 0; i < deliverCnt; i++)
+    {
+        (requests[i].fixCB)(&gnssShare.fix, rslt, requests[i].userCntxt);
+    }
+}
+
+#pragma endregion
+
+#endif  // LTEMC_ENABLE_GNSS_SHARE
@@ -0,0 +1,144 @@
+/** ****************************************************************************
+  \file 
+  \brief Public API GNSS/LTE time-sharing coordinator for single-radio modules (BG95/BG77)
+  \author Greg Terrell, LooUQ Incorporated
+
+  \loouq
+
+--------------------------------------------------------------------------------
+
+    This project is released under the GPL-3.0 License.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ 
+***************************************************************************** */
+
+
+#ifndef __LTEMC_GNSS_SHARE_H__
+#define __LTEMC_GNSS_SHARE_H__
+
+#include "ltemc-gnss.h"
+
+
+enum gnssShare__constants
+{
+    gnssShare__requestMax = 4,                      ///< fix requests batched into one GNSS window
+    gnssShare__pollInterval = 1000,                 ///< location poll interval while GNSS window is open (mS)
+    gnssShare__defaultMaxBlackout = 60000,          ///< default max LTE data blackout per GNSS window (mS)
+    gnssShare__defaultBatchWindow = 2000,           ///< default wait after first request for others to batch (mS)
+    gnssShare__defaultMinDataPeriod = 30000         ///< default min LTE data period between GNSS windows (mS)
+};
+
+
+/** 
+ *  \brief Coordinator state.
+*/
+typedef enum gnssShareState_tag
+{
+    gnssShareState_idle = 0,                ///< LTE data active, no GNSS window
+    gnssShareState_draining,                ///< requests pending, application drained (drainCB), radio switch to GNSS
+    gnssShareState_gnssActive,              ///< LTE data suspended, GNSS acquiring fix
+    gnssShareState_restoring                ///< radio switch back to LTE, streams resumed
+} gnssShareState_t;
+
+
+/** 
+ *  \brief Callback delivering the result of a fix request.
+ *  \param fix [in] Fix acquired in the GNSS window, valid=false if none within the time budget.
+ *  \param rslt [in] Result of the request: 200 = fix, 408 = no fix within the max blackout, otherwise error.
+ *  \param userCntxt [in] Context provided with the request.
+*/
+typedef void (*gnssShareFix_func)(const gnssFix_t *fix, resultCode_t rslt, void *userCntxt);
+
+
+/** 
+ *  \brief Time-sharing policy knobs.
+*/
+typedef struct gnssSharePolicy_tag
+{
+    uint32_t maxBlackout;                   ///< max LTE data blackout per GNSS window, also the fix time budget (mS)
+    uint32_t batchWindow;                   ///< wait after the first request for additional requests (mS)
+    uint32_t minDataPeriod;                 ///< min LTE data period between GNSS windows (mS)
+    bool reopenStreams;                     ///< reopen data streams (stream recover handlers) after each GNSS window
+    void (*drainCB)();                      ///< optional application callback to flush queued publishes/sends before the window
+} gnssSharePolicy_t;
+
+
+typedef struct gnssShareRequest_tag
+{
+    gnssShareFix_func fixCB;
+    void *userCntxt;
+} gnssShareRequest_t;
+
+
+/** 
+ *  \brief Coordinator controls.
+*/
+typedef struct gnssShareCtrl_tag
+{
+    gnssSharePolicy_t policy;
+    gnssShareState_t state;
+    gnssShareRequest_t requests[gnssShare__requestMax];
+    uint8_t requestCnt;
+    uint32_t firstRequestAt;                ///< tick count of oldest pending request
+    uint32_t windowAt;                      ///< tick count when LTE data was suspended
+    uint32_t pollAt;                        ///< tick count of last location poll
+    uint32_t dataResumedAt;                 ///< tick count when LTE data last resumed
+    uint32_t lastBlackout;                  ///< duration of the last LTE data blackout (mS)
+    gnssFix_t fix;
+} gnssShareCtrl_t;
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *	@brief Set time-sharing policy, default policy is in effect until set.
+ *  @param [in] policy The policy knobs, copied.
+ */
+void gnssShare_setPolicy(const gnssSharePolicy_t *policy);
+
+/**
+ *	@brief Request a GNSS fix. Requests are batched so one radio switch serves all pending callers.
+ *  @details The GNSS window is driven by ltem_eventMgr(), the callback is invoked from ltem_eventMgr().
+ *  @param [in] fixCB Callback receiving the fix result.
+ *  @param [in] userCntxt Caller context passed back to the callback (optional).
+ *  @return True if the request was queued, false if the request queue is full.
+ */
+bool gnssShare_requestFix(gnssShareFix_func fixCB, void *userCntxt);
+
+/**
+ *	@brief Test if LTE data is currently unavailable due to a GNSS window. Application should hold sends/publishes,
+ *  mqtt_publish() and sckt_send() return 503 (unavailable) during the blackout.
+ *  @return True if LTE data is suspended (or being suspended).
+ */
+bool gnssShare_isDataBlackout();
+
+/**
+ *	@brief Get coordinator state.
+ */
+gnssShareState_t gnssShare_getState();
+
+/**
+ *	@brief Get the duration of the last LTE data blackout (mS).
+ */
+uint32_t gnssShare_getLastBlackout();
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // !__LTEMC_GNSS_SHARE_H__
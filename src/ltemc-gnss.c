@@ -43,6 +43,8 @@
 #include "ltemc-internal.h"
 #include "ltemc-gnss.h"
 
+#if LTEMC_ENABLE_GNSS                           // module selection, see ltemc-config.h
+
 
 #define GNSS_CMD_RESULTBUF_SZ 90
 #define GNSS_LOC_DATAOFFSET 12
@@ -52,13 +54,30 @@
 #define MIN(x, y) (((x) < (y)) ? (x) : (y))
 
 
+static gnssStreamCtrl_t gnssStream;            // streaming mode controls, parser and latest-fix snapshot
+
+
 // private local declarations
 static cmdParseRslt_t gnssLocCompleteParser(const char *response, char **endptr);
+static void S__gnmeaLineRecv(void *lineCntxt, const char *line, uint16_t lineSz, bool isComplete);
+static void S__gnssStreamDoWork();
+static void S__nmeaParseChar(char nmeaChar);
+static void S__nmeaDispatch();
+static void S__publishFix(bool newEpoch);
+static uint32_t S__parseUint(const char *src, const char **endPtr);
+static int32_t S__parseFixed(const char *src, uint8_t decimals, const char **endPtr);
+static uint32_t S__parseUtcMillis(const char *src, const char **endPtr);
+static void S__parseQgpsloc(const char *src, gnssFix_t *fix);
+static int32_t S__parseNmeaCoord(const char *src, char hemisphere);
+static uint8_t S__hexNibble(char hexChar);
 
 
 /*
  *  AT+QGPSLOC=2 (format=2)
  *  +QGPSLOC: 113355.0,44.74770,-85.56527,1.2,192.0,2,277.11,0.0,0.0,250420,10
+ *
+ *  AT+QGPSGNMEA="GGA" (AT+QGPSCFG="nmeasrc",1)
+ *  +QGPSGNMEA: $GPGGA,113355.00,4444.8620,N,08533.9162,W,1,10,1.2,192.0,M,-34.0,M,,*5C
  * --------------------------------------------------------------------------------------------- */
 
 
@@ -98,12 +117,29 @@ resultCode_t gnss_off()
  */
 gnssLocation_t gnss_getLocation()
 {
-    char tokenBuf[12] = {0};
-    gnssLocation_t gnssResult;
+    // +QGPSLOC: <UTC>,<latitude>,<longitude>,<hdop>,<altitude>,<fix>,<cog>,<spkm>,<spkn>,<date>,<nsat>
+    static const atcmdField_t qgpslocFields[] =
+    {
+        ATCMD_FIELD(atcmdField_str, gnssLocation_t, utc),
+        ATCMD_FIELD(atcmdField_float, gnssLocation_t, lat.val),
+        ATCMD_FIELD(atcmdField_float, gnssLocation_t, lon.val),
+        ATCMD_FIELD(atcmdField_float, gnssLocation_t, hdop),
+        ATCMD_FIELD(atcmdField_float, gnssLocation_t, altitude),
+        ATCMD_FIELD(atcmdField_int, gnssLocation_t, fixType),
+        ATCMD_FIELD(atcmdField_float, gnssLocation_t, course),
+        ATCMD_FIELD(atcmdField_float, gnssLocation_t, speedkm),
+        ATCMD_FIELD(atcmdField_float, gnssLocation_t, speedkn),
+        ATCMD_FIELD(atcmdField_str, gnssLocation_t, date),
+        ATCMD_FIELD(atcmdField_int, gnssLocation_t, nsat)
+    };
+    static const atcmdSchema_t qgpslocSchema = ATCMD_SCHEMA("", qgpslocFields, 11);
+
+    gnssLocation_t gnssResult = {0};
 
     //atcmd_t *gnssCmd = atcmd_build("AT+QGPSLOC=2", GNSS_CMD_RESULTBUF_SZ, 500, gnssLocCompleteParser);
     // result sz=86 >> +QGPSLOC: 121003.0,44.74769,-85.56535,1.1,189.0,2,95.45,0.0,0.0,250420,08  + \r\nOK\r\n
 
+    gnssResult.statusCode = resultCode__conflict;
     if (ATCMD_awaitLock(atcmd__defaultTimeout))
     {
         atcmd_invokeReuseLock("AT+QGPSLOC=2");
@@ -111,32 +147,17 @@ gnssLocation_t gnss_getLocation()
 
         gnssResult.statusCode = atResult;
         if (atResult != resultCode__success)                                            // return on failure, continue on success
+        {
+            atcmd_close();
             return gnssResult;
+        }
 
         PRINTF(dbgColor__warn, "getLocation(): parse starting...\r");
 
-        char *parsedResponse = atcmd_getResponse();
-        char *delimAt;
-
-
-        if ((delimAt = strchr(parsedResponse, (int)',')) != NULL)
-            strncpy(gnssResult.utc, parsedResponse, delimAt - parsedResponse);
-
-        gnssResult.lat.val = strtof(parsedResponse, &parsedResponse);                         // grab a float
+        if (!atcmd_getResponseFields(&qgpslocSchema, &gnssResult))
+            gnssResult.statusCode = resultCode__internalError;
         gnssResult.lat.dir = ' ';
-        gnssResult.lon.val = strtof(++parsedResponse, &parsedResponse);                       // ++parsedResponse, pre-incr to skip previous comma
         gnssResult.lon.dir = ' ';
-        gnssResult.hdop = strtof(++parsedResponse, &parsedResponse);
-        gnssResult.altitude = strtof(++parsedResponse, &parsedResponse);
-        gnssResult.fixType = strtol(++parsedResponse, &parsedResponse, 10);                   // grab an integer
-        gnssResult.course = strtof(++parsedResponse, &parsedResponse);
-        gnssResult.speedkm = strtof(++parsedResponse, &parsedResponse);
-        gnssResult.speedkn = strtof(++parsedResponse, &parsedResponse);
-
-        if ((delimAt = strchr(parsedResponse, (int)',')) != NULL)
-            strncpy(gnssResult.date, tokenBuf, 7);
-
-        gnssResult.nsat = strtol(parsedResponse, &parsedResponse, 10);
         atcmd_close();
 
         PRINTF(dbgColor__warn, "getLocation(): parse completed\r");
@@ -145,6 +166,163 @@ gnssLocation_t gnss_getLocation()
 }
 
 
+/**
+ *	@brief Query BGx for current location, parsed to fixed-point without floating point or allocation.
+ */
+resultCode_t gnss_getLocationFix(gnssFix_t *fix)
+{
+    memset(fix, 0, sizeof(gnssFix_t));
+
+    if (!ATCMD_awaitLock(atcmd__defaultTimeout))
+        return resultCode__conflict;
+
+    atcmd_invokeReuseLock("AT+QGPSLOC=2");
+    resultCode_t atResult = atcmd_awaitResultWithOptions(atcmd__defaultTimeout, gnssLocCompleteParser);
+    if (atResult == resultCode__success)
+    {
+        S__parseQgpsloc(atcmd_getResponse(), fix);
+    }
+    atcmd_close();
+    return atResult;
+}
+
+
+/**
+ *	@brief Start GNSS streaming mode, NMEA sentences are parsed incrementally into the latest-fix snapshot.
+ */
+resultCode_t gnss_startStream(gnssStreamSrc_t source, uint8_t fixRateHz, uint8_t nmeaMask, gnssFix_func fixCB)
+{
+    ASSERT(source == gnssStreamSrc_atPoll || source == gnssStreamSrc_nmeaPort);
+    ASSERT(fixRateHz > 0 && fixRateHz <= gnss__streamRateMax);
+    ASSERT(nmeaMask & (gnssNmea_gga | gnssNmea_rmc));                               // position sentence required for fixes
+
+    resultCode_t rslt = resultCode__conflict;
+    if (source == gnssStreamSrc_atPoll)
+    {
+        if (atcmd_tryInvoke("AT+QGPSCFG=\"nmeasrc\",1"))                            // enable AT+QGPSGNMEA
+            rslt = atcmd_awaitResult();
+    }
+    else
+    {
+        if (atcmd_tryInvoke("AT+QGPSCFG=\"outport\",\"uartnmea\""))                // route NMEA to UART NMEA port
+            rslt = atcmd_awaitResult();
+    }
+    if (rslt != resultCode__success)
+        return rslt;
+
+    if (atcmd_tryInvoke("AT+QGPSCFG=\"fixfreq\",%d", fixRateHz))                   // BG95/BG77, BG96 is fixed at 1Hz (error ignored)
+        atcmd_awaitResult();
+
+    memset(&gnssStream, 0, sizeof(gnssStreamCtrl_t));
+    gnssStream.nmeaMask = nmeaMask;
+    gnssStream.period = 1000 / fixRateHz;
+    gnssStream.fixCB = fixCB;
+    gnssStream.lastCbMillis = UINT32_MAX;
+    gnssStream.source = source;                                                     // last, worker and feed check source
+
+    LTEM_registerDoWorker(S__gnssStreamDoWork);
+    return resultCode__success;
+}
+
+
+/**
+ *	@brief Stop GNSS streaming mode.
+ */
+resultCode_t gnss_stopStream()
+{
+    gnssStreamSrc_t source = gnssStream.source;
+    gnssStream.source = gnssStreamSrc_none;
+
+    if (source == gnssStreamSrc_atPoll && atcmd_tryInvoke("AT+QGPSCFG=\"nmeasrc\",0"))
+        return atcmd_awaitResult();
+    if (source == gnssStreamSrc_nmeaPort && atcmd_tryInvoke("AT+QGPSCFG=\"outport\",\"none\""))
+        return atcmd_awaitResult();
+    return resultCode__success;
+}
+
+
+/**
+ *	@brief Feed NMEA characters to the streaming parser (gnssStreamSrc_nmeaPort).
+ */
+void gnss_nmeaFeed(const char *nmeaData, uint16_t dataSz)
+{
+    if (gnssStream.source == gnssStreamSrc_none)
+        return;
+
+    for (uint16_t i = 0; i < dataSz; i++)
+    {
+        S__nmeaParseChar(nmeaData[i]);
+    }
+}
+
+
+/**
+ *	@brief Get a consistent copy of the latest fix snapshot.
+ */
+bool gnss_getLatestFix(gnssFix_t *fix)
+{
+    uint32_t seq;
+    do                                                                              // retry if the parser updated the snapshot during the copy
+    {
+        seq = gnssStream.snapshotSeq;
+        memcpy(fix, (const void *)&gnssStream.snapshot, sizeof(gnssFix_t));
+    } while ((seq & 0x01) || seq != gnssStream.snapshotSeq);
+
+    return fix->valid;
+}
+
+
+#pragma endregion
+
+
+#pragma region LTEmC Internal Functions
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ *	@brief Approximate distance in metres (equirectangular, integer), shared by geofence and track.
+ */
+uint32_t GNSS_distance(int32_t lat1, int32_t lon1, int32_t lat2, int32_t lon2)
+{
+    int64_t dy = (int64_t)(lat2 - lat1) * gnss__mmPerMicroDeg;                     // millimetres
+    int64_t dx = (int64_t)(lon2 - lon1) * gnss__mmPerMicroDeg * GNSS_cosLatitude(lat1) / 1000;
+    uint64_t distSq = (dx * dx + dy * dy) / 1000000;                                // metres^2
+
+    uint64_t dist = 0;                                                              // integer sqrt (bitwise)
+    uint64_t bit = 1ULL << 62;
+    while (bit > distSq)
+    {
+        bit >>= 2;
+    }
+    while (bit != 0)
+    {
+        if (distSq >= dist + bit)
+        {
+            distSq -= dist + bit;
+            dist = (dist >> 1) + bit;
+        }
+        else
+            dist >>= 1;
+        bit >>= 2;
+    }
+    return (uint32_t)dist;
+}
+
+
+/**
+ *	@brief Cosine of latitude x1000, linear interpolation of a 10 degree table (error < 0.4%).
+ */
+uint16_t GNSS_cosLatitude(int32_t latitude)
+{
+    static const uint16_t cosTable[] = { 1000, 985, 940, 866, 766, 643, 500, 342, 174, 0 };     // cos x1000, 10 degree steps
+    uint32_t absLat = MIN(labs(latitude), 90000000);
+    uint8_t step = absLat / 10000000;
+    if (step >= 9)
+        return 0;
+
+    uint32_t frac = absLat % 10000000;                                              // microdegrees into step
+    return cosTable[step] - (uint32_t)(cosTable[step] - cosTable[step + 1]) * frac / 10000000;
+}
+
 #pragma endregion
 
 /* private (static) functions
@@ -163,4 +341,346 @@ static cmdParseRslt_t gnssLocCompleteParser(const char *response, char **endptr)
     return parseRslt;
 }
 
+
+/**
+ *	@brief Line mode receiver for AT+QGPSGNMEA, GSV (and multi-constellation GGA/RMC) return a line per sentence.
+ */
+static void S__gnmeaLineRecv(void *lineCntxt, const char *line, uint16_t lineSz, bool isComplete)
+{
+    for (uint16_t i = 0; i < lineSz; i++)                                           // parser syncs on '$', "+QGPSGNMEA: " prefix is ignored
+    {
+        S__nmeaParseChar(line[i]);
+    }
+    if (isComplete)
+    {
+        S__nmeaParseChar('\r');
+        S__nmeaParseChar('\n');
+    }
+}
+
+
+/**
+ *	@brief Streaming mode background worker (atPoll source), requests one sentence type per invoke.
+ */
+static void S__gnssStreamDoWork()
+{
+    if (gnssStream.source != gnssStreamSrc_atPoll)
+        return;
+
+    if (gnssStream.burstPending == 0)
+    {
+        if (pMillis() - gnssStream.burstAt < gnssStream.period)
+            return;
+        gnssStream.burstAt = pMillis();
+        gnssStream.burstPending = gnssStream.nmeaMask;
+    }
+    if (!ATCMD_awaitLockPriority(0, atcmdPriority_bulk, "gnss-nmea"))             // channel busy or higher priority waiting, resume next pass
+        return;
+
+    static const char *nmeaTypes[] = { "GGA", "RMC", "VTG", "GSA", "GSV" };
+    uint8_t typeIndx = 0;
+    while (!(gnssStream.burstPending & (1 << typeIndx)))
+    {
+        typeIndx++;
+    }
+    gnssStream.burstPending &= ~(1 << typeIndx);
+
+    atcmd_configLineMode(S__gnmeaLineRecv, NULL);                                  // sentences can exceed the response buffer
+    atcmd_invokeReuseLock("AT+QGPSGNMEA=\"%s\"", nmeaTypes[typeIndx]);
+    atcmd_awaitResultWithOptions(gnss__nmeaPollTimeout, NULL);                     // 516 = not fixed yet
+    atcmd_close();
+}
+
+
+/**
+ *	@brief Incremental NMEA parser, accepts one character. Sentences are dispatched when the checksum validates.
+ */
+static void S__nmeaParseChar(char nmeaChar)
+{
+    gnssNmeaParser_t *parser = &gnssStream.parser;
+
+    if (nmeaChar == '$')                                                            // start of sentence always (re)syncs parser
+    {
+        parser->state = 1;
+        parser->sentenceLen = 0;
+        parser->checksum = 0;
+        return;
+    }
+
+    switch (parser->state)
+    {
+        case 1:
+            if (nmeaChar == '*')
+            {
+                parser->sentence[parser->sentenceLen] = '\0';
+                parser->state = 2;
+            }
+            else if (nmeaChar == '\r' || nmeaChar == '\n' || parser->sentenceLen == gnss__nmeaSentenceSz - 1)
+            {
+                parser->checksumErrCnt++;                                           // truncated or overlength sentence
+                parser->state = 0;
+            }
+            else
+            {
+                parser->sentence[parser->sentenceLen++] = nmeaChar;
+                parser->checksum ^= nmeaChar;
+            }
+            break;
+
+        case 2:
+            parser->rxChecksum = S__hexNibble(nmeaChar) << 4;
+            parser->state = (S__hexNibble(nmeaChar) > 0x0F) ? 0 : 3;
+            break;
+
+        case 3:
+            parser->rxChecksum |= S__hexNibble(nmeaChar);
+            parser->state = 0;
+            if (S__hexNibble(nmeaChar) <= 0x0F && parser->rxChecksum == parser->checksum)
+            {
+                parser->sentenceCnt++;
+                S__nmeaDispatch();
+            }
+            else
+                parser->checksumErrCnt++;
+            break;
+    }
+}
+
+
+/**
+ *	@brief Tokenize validated sentence in place and update the working fix.
+ */
+static void S__nmeaDispatch()
+{
+    char *fields[gnss__nmeaFieldsMax];
+    uint8_t fieldCnt = 0;
+    char *parsePtr = gnssStream.parser.sentence;
+    gnssFix_t *fix = &gnssStream.working;
+
+    fields[fieldCnt++] = parsePtr;
+    while (*parsePtr && fieldCnt < gnss__nmeaFieldsMax)
+    {
+        if (*parsePtr == ',')
+        {
+            *parsePtr = '\0';
+            fields[fieldCnt++] = parsePtr + 1;
+        }
+        parsePtr++;
+    }
+    if (strlen(fields[0]) != 5)                                                     // talker (GP, GN, GL, GA) + type
+        return;
+
+    const char *sentenceType = fields[0] + 2;
+    bool positionSentence = false;
+
+    /* $GPGGA,time,lat,N/S,lon,E/W,quality,nsat,hdop,altitude,M,geoid,M,age,station
+     */
+    if (memcmp(sentenceType, "GGA", 3) == 0 && fieldCnt >= 10 && (gnssStream.nmeaMask & gnssNmea_gga))
+    {
+        uint32_t utcMillis = S__parseUtcMillis(fields[1], NULL);
+        positionSentence = (utcMillis != fix->utcMillis);
+        fix->utcMillis = utcMillis;
+        fix->quality = S__parseUint(fields[6], NULL);
+        fix->valid = fix->quality > 0;
+        if (fix->valid)
+        {
+            fix->latitude = S__parseNmeaCoord(fields[2], *fields[3]);
+            fix->longitude = S__parseNmeaCoord(fields[4], *fields[5]);
+            fix->altitude = S__parseFixed(fields[9], 1, NULL);
+        }
+        fix->nsat = S__parseUint(fields[7], NULL);
+        fix->hdop = S__parseFixed(fields[8], 2, NULL);
+    }
+
+    /* $GPRMC,time,status,lat,N/S,lon,E/W,speed(kn),course,date,magvar,E/W
+     */
+    else if (memcmp(sentenceType, "RMC", 3) == 0 && fieldCnt >= 10 && (gnssStream.nmeaMask & gnssNmea_rmc))
+    {
+        uint32_t utcMillis = S__parseUtcMillis(fields[1], NULL);
+        positionSentence = (utcMillis != fix->utcMillis);
+        fix->utcMillis = utcMillis;
+        fix->valid = *fields[2] == 'A';
+        if (fix->valid)
+        {
+            fix->latitude = S__parseNmeaCoord(fields[3], *fields[4]);
+            fix->longitude = S__parseNmeaCoord(fields[5], *fields[6]);
+            fix->speed = S__parseFixed(fields[7], 3, NULL) * 1852 / 36000;               // milli-knots to cm/s
+            fix->course = S__parseFixed(fields[8], 2, NULL);
+        }
+        fix->date = S__parseUint(fields[9], NULL);
+    }
+
+    /* $GPVTG,course,T,course(mag),M,speed,N,speed,K,mode
+     */
+    else if (memcmp(sentenceType, "VTG", 3) == 0 && fieldCnt >= 9 && (gnssStream.nmeaMask & gnssNmea_vtg))
+    {
+        if (*fields[1])
+            fix->course = S__parseFixed(fields[1], 2, NULL);
+        if (*fields[7])
+            fix->speed = S__parseFixed(fields[7], 3, NULL) / 36;                          // metres/hour to cm/s
+    }
+
+    /* $GPGSA,mode,fixType,sv1...sv12,pdop,hdop,vdop
+     */
+    else if (memcmp(sentenceType, "GSA", 3) == 0 && fieldCnt >= 18 && (gnssStream.nmeaMask & gnssNmea_gsa))
+    {
+        fix->fixType = S__parseUint(fields[2], NULL);
+        fix->hdop = S__parseFixed(fields[16], 2, NULL);
+    }
+
+    /* $GPGSV,msgCnt,msgNum,satsInView,[sv,elev,azimuth,snr]...
+     */
+    else if (memcmp(sentenceType, "GSV", 3) == 0 && fieldCnt >= 4 && (gnssStream.nmeaMask & gnssNmea_gsv))
+    {
+        fix->satsInView = S__parseUint(fields[3], NULL);
+    }
+    else
+        return;
+
+    S__publishFix(positionSentence && fix->valid);
+}
+
+
+/**
+ *	@brief Copy working fix to the snapshot (sequence guarded) and notify application of a new fix.
+ */
+static void S__publishFix(bool newEpoch)
+{
+    gnssStream.snapshotSeq++;                                                       // odd: readers retry
+    memcpy((void *)&gnssStream.snapshot, &gnssStream.working, sizeof(gnssFix_t));
+    gnssStream.snapshotSeq++;
+
+    if (newEpoch && gnssStream.fixCB != NULL && gnssStream.working.utcMillis != gnssStream.lastCbMillis)
+    {
+        gnssStream.lastCbMillis = gnssStream.working.utcMillis;
+        (gnssStream.fixCB)(&gnssStream.working);
+    }
+}
+
+
+/* NMEA integer field parsers, no floating point
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ *	@brief Single-pass tokenizer for AT+QGPSLOC=2 response to fixed-point fix.
+ *  @details <utc>,<lat>,<lon>,<hdop>,<altitude>,<fix>,<cog>,<spkm>,<spkn>,<date>,<nsat>
+ */
+static void S__parseQgpsloc(const char *src, gnssFix_t *fix)
+{
+    fix->utcMillis = S__parseUtcMillis(src, &src);
+    src += (*src == ',');
+    fix->latitude = S__parseFixed(src, 6, &src);                                    // decimal degrees to microdegrees
+    src += (*src == ',');
+    fix->longitude = S__parseFixed(src, 6, &src);
+    src += (*src == ',');
+    fix->hdop = S__parseFixed(src, 2, &src);
+    src += (*src == ',');
+    fix->altitude = S__parseFixed(src, 1, &src);
+    src += (*src == ',');
+    fix->fixType = S__parseUint(src, &src);
+    src += (*src == ',');
+
+    uint32_t courseDeg = S__parseUint(src, &src);                                   // cog format: ddd.mm (degrees, minutes)
+    uint32_t courseMin = (*src == '.') ? S__parseFixed(src, 2, &src) : 0;
+    fix->course = courseDeg * 100 + courseMin * 100 / 60;
+    src += (*src == ',');
+
+    fix->speed = S__parseFixed(src, 3, &src) / 36;                                  // km/h (metres/hour) to cm/s
+    src += (*src == ',');
+    S__parseFixed(src, 0, &src);                                                    // skip knots
+    src += (*src == ',');
+    fix->date = S__parseUint(src, &src);
+    src += (*src == ',');
+    fix->nsat = S__parseUint(src, &src);
+
+    fix->valid = fix->fixType >= 2;
+    fix->quality = fix->valid ? 1 : 0;
+}
+
+
+static uint32_t S__parseUint(const char *src, const char **endPtr)
+{
+    uint32_t value = 0;
+    while (*src >= '0' && *src <= '9')
+    {
+        value = value * 10 + (*src++ - '0');
+    }
+    if (endPtr != NULL)
+        *endPtr = src;
+    return value;
+}
+
+
+/**
+ *	@brief Parse decimal text to integer scaled by 10^decimals, extra digits are truncated: "-12.345",2 = -1234
+ */
+static int32_t S__parseFixed(const char *src, uint8_t decimals, const char **endPtr)
+{
+    bool negative = (*src == '-');
+    if (negative || *src == '+')
+        src++;
+
+    int32_t value = S__parseUint(src, &src);
+    bool fraction = (*src == '.');
+    if (fraction)
+        src++;
+    for (uint8_t i = 0; i < decimals; i++)
+    {
+        value *= 10;
+        if (*src >= '0' && *src <= '9')
+            value += *src++ - '0';
+    }
+    while (fraction && *src >= '0' && *src <= '9')                                  // truncated digits
+    {
+        src++;
+    }
+    if (endPtr != NULL)
+        *endPtr = src;
+    return negative ? -value : value;
+}
+
+
+/**
+ *	@brief Parse NMEA time hhmmss.sss to milliseconds since midnight.
+ */
+static uint32_t S__parseUtcMillis(const char *src, const char **endPtr)
+{
+    uint32_t hhmmss = S__parseUint(src, &src);
+    uint32_t millis = 0;
+    if (*src == '.')
+        millis = S__parseFixed(src, 3, &src);
+    if (endPtr != NULL)
+        *endPtr = src;
+    return ((hhmmss / 10000) * 3600 + ((hhmmss / 100) % 100) * 60 + hhmmss % 100) * 1000 + millis;
+}
+
+
+/**
+ *	@brief Parse NMEA coordinate (d)ddmm.mmmm and hemisphere to microdegrees.
+ */
+static int32_t S__parseNmeaCoord(const char *src, char hemisphere)
+{
+    uint32_t dddmm = S__parseUint(src, &src);
+    uint32_t minutesE6 = (dddmm % 100) * 1000000;
+    if (*src == '.')
+        minutesE6 += S__parseFixed(src, 6, NULL);
+
+    int32_t microDeg = (dddmm / 100) * 1000000 + (minutesE6 + 30) / 60;
+    return (hemisphere == 'S' || hemisphere == 'W') ? -microDeg : microDeg;
+}
+
+
+static uint8_t S__hexNibble(char hexChar)
+{
+    if (hexChar >= '0' && hexChar <= '9')
+        return hexChar - '0';
+    if (hexChar >= 'A' && hexChar <= 'F')
+        return hexChar - 'A' + 10;
+    if (hexChar >= 'a' && hexChar <= 'f')
+        return hexChar - 'a' + 10;
+    return 0xFF;                                                                    // not a hex digit
+}
+
 #pragma endregion
+
+#endif  // LTEMC_ENABLE_GNSS
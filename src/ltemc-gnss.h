@@ -28,6 +28,101 @@
 #define __LTEMC_GNSS_H__
 
 
+enum gnss__constants
+{
+    gnss__nmeaSentenceSz = 83,              ///< NMEA 0183 max sentence length (82) + \0
+    gnss__nmeaFieldsMax = 20,               ///< max fields tokenized from a sentence (GSA has 18)
+    gnss__streamRateMax = 10,               ///< max fix rate (Hz), BG95/BG77 "fixfreq" range 1-10
+    gnss__nmeaPollTimeout = 300,            ///< AT+QGPSGNMEA response timeout (mS)
+    gnss__mmPerMicroDeg = 111               ///< ~ millimetres per microdegree (latitude, and longitude at equator)
+};
+
+
+/** 
+ *  \brief Bitmap of NMEA sentence types serviced by the streaming parser.
+*/
+typedef enum gnssNmea_tag
+{
+    gnssNmea_gga = 0x01,            ///< Fix data: time, position, quality, satellites used, HDOP, altitude
+    gnssNmea_rmc = 0x02,            ///< Recommended minimum: time, status, position, speed, course, date
+    gnssNmea_vtg = 0x04,            ///< Course and speed over ground
+    gnssNmea_gsa = 0x08,            ///< Fix type (2D/3D) and DOP
+    gnssNmea_gsv = 0x10             ///< Satellites in view
+} gnssNmea_t;
+
+
+/** 
+ *  \brief Source of NMEA sentences for the streaming parser.
+*/
+typedef enum gnssStreamSrc_tag
+{
+    gnssStreamSrc_none = 0,         ///< Streaming not active
+    gnssStreamSrc_atPoll = 1,       ///< AT+QGPSGNMEA bursts on the AT channel, serviced by ltem_eventMgr() between other commands
+    gnssStreamSrc_nmeaPort = 2      ///< BGx NMEA output to UART port, host reads port and calls gnss_nmeaFeed()
+} gnssStreamSrc_t;
+
+
+/** 
+ *  \brief Fixed-point GNSS fix, updated incrementally from NMEA sentences.
+*/
+typedef struct gnssFix_tag
+{
+    uint32_t utcMillis;             ///< UTC time of fix, milliseconds since midnight (GGA/RMC)
+    uint32_t date;                  ///< UTC date of fix as integer ddmmyy (RMC)
+    int32_t latitude;               ///< Latitude in microdegrees, negative is south (GGA/RMC)
+    int32_t longitude;              ///< Longitude in microdegrees, negative is west (GGA/RMC)
+    int32_t altitude;               ///< Altitude above mean sea level in decimetres (GGA)
+    uint32_t speed;                 ///< Speed over ground in cm/s (RMC/VTG)
+    uint16_t course;                ///< Course over ground (true north) in centidegrees (RMC/VTG)
+    uint16_t hdop;                  ///< Horizontal dilution of precision x100 (GGA/GSA)
+    uint8_t quality;                ///< GGA fix quality: 0=invalid, 1=GPS, 2=DGPS, 6=estimated
+    uint8_t fixType;                ///< GSA fix type: 1=no fix, 2=2D, 3=3D
+    uint8_t nsat;                   ///< Satellites used in fix (GGA)
+    uint8_t satsInView;             ///< Satellites in view (GSV)
+    bool valid;                     ///< True if the most recent position sentence reported a valid fix
+} gnssFix_t;
+
+
+/** 
+ *  \brief Callback invoked once per new fix (new UTC time tag with a valid position).
+*/
+typedef void (*gnssFix_func)(const gnssFix_t *fix);
+
+
+/** 
+ *  \brief Incremental NMEA sentence parser state. Characters are accepted one at a time, sentences are validated by checksum.
+*/
+typedef struct gnssNmeaParser_tag
+{
+    char sentence[gnss__nmeaSentenceSz];    ///< sentence body between '$' and '*'
+    uint8_t sentenceLen;
+    uint8_t state;                          ///< 0=await '$', 1=body, 2=checksum hi nibble, 3=checksum lo nibble
+    uint8_t checksum;                       ///< running XOR of body chars
+    uint8_t rxChecksum;                     ///< checksum received in the sentence
+    uint32_t sentenceCnt;                   ///< sentences dispatched
+    uint32_t checksumErrCnt;                ///< sentences discarded for checksum error or overflow
+} gnssNmeaParser_t;
+
+
+/** 
+ *  \brief GNSS streaming mode controls.
+*/
+typedef struct gnssStreamCtrl_tag
+{
+    gnssStreamSrc_t source;                 ///< NMEA source, none if streaming is stopped
+    uint8_t nmeaMask;                       ///< gnssNmea_t sentence types serviced
+    uint16_t period;                        ///< fix period (mS), atPoll burst interval
+    uint8_t burstPending;                   ///< atPoll: sentence types remaining in current burst
+    uint32_t burstAt;                       ///< atPoll: tick count when current burst started
+    gnssFix_func fixCB;                     ///< application fix callback (optional)
+    gnssNmeaParser_t parser;                ///< incremental sentence parser
+    gnssFix_t working;                      ///< fix being assembled from sentences (parser only)
+    volatile uint32_t snapshotSeq;          ///< snapshot sequence, odd while the snapshot is being written
+    gnssFix_t snapshot;                     ///< latest fix snapshot, read with gnss_getLatestFix()
+    uint32_t lastCbMillis;                  ///< UTC time tag of the last fix callback
+} gnssStreamCtrl_t;
+
+
 /** 
  *  \brief Enum describing the output format for location data.
 */
@@ -92,6 +187,46 @@ resultCode_t gnss_off();
  */
 gnssLocation_t gnss_getLocation();
 
+/**
+ *	@brief Query BGx for current location, parsed to fixed-point without floating point or allocation. 
+ *  @param [out] fix Caller's struct to receive the location, valid is set if BGx reported a 2D/3D fix.
+ *  @return Result code representing status of operation, OK = 200. BGx 516 indicates no fix yet.
+ */
+resultCode_t gnss_getLocationFix(gnssFix_t *fix);
+
+
+/**
+ *	@brief Start GNSS streaming mode, NMEA sentences are parsed incrementally into the latest-fix snapshot.
+ *  @details GNSS must be on (gnss_on()). With gnssStreamSrc_atPoll, sentences are requested one type per ltem_eventMgr() 
+ *  pass and only when no other command is underway, other AT traffic interleaves between sentences.
+ *  @param [in] source NMEA source: AT channel polling or BGx NMEA UART port (host feeds with gnss_nmeaFeed()).
+ *  @param [in] fixRateHz Fix rate 1-10 Hz, rates above 1 Hz require BG95/BG77.
+ *  @param [in] nmeaMask Bitmap of gnssNmea_t sentence types to service, GGA|RMC recommended for atPoll.
+ *  @param [in] fixCB Optional callback invoked once per new fix.
+ *  @return Result code representing status of operation, OK = 200.
+ */
+resultCode_t gnss_startStream(gnssStreamSrc_t source, uint8_t fixRateHz, uint8_t nmeaMask, gnssFix_func fixCB);
+
+/**
+ *	@brief Stop GNSS streaming mode.
+ *  @return Result code representing status of operation, OK = 200.
+ */
+resultCode_t gnss_stopStream();
+
+/**
+ *	@brief Feed NMEA characters to the streaming parser (gnssStreamSrc_nmeaPort). Safe to call from a UART receive ISR.
+ *  @param [in] nmeaData Characters received from the BGx NMEA port.
+ *  @param [in] dataSz Number of characters.
+ */
+void gnss_nmeaFeed(const char *nmeaData, uint16_t dataSz);
+
+/**
+ *	@brief Get a consistent copy of the latest fix snapshot, does not block or send AT commands.
+ *  @param [out] fix Caller's struct to receive the fix.
+ *  @return True if the fix is valid.
+ */
+bool gnss_getLatestFix(gnssFix_t *fix);
+
 
 #ifdef __cplusplus
 }
@@ -43,10 +43,23 @@
 #include "ltemc-internal.h"
 #include "ltemc-gpio.h"
 
+#if LTEMC_ENABLE_GPIO                           // module selection, see ltemc-config.h
+
+#define GPIO_RESPONSE_PREAMBLE "+QCFG: \"gpio\","
+
+#define MIN(x, y) (((x) < (y)) ? (x) : (y))
+#define MAX(x, y) (((x) > (y)) ? (x) : (y))
+
+
+static adcSamplerCtrl_t adcSampler;
 
 // private local declarations
 static resultCode_t S__adcValueParser(const char *response, char **endptr);
 static resultCode_t S__ioValueParser(const char *response, char **endptr);
+static resultCode_t S__gpioBatch(gpioActionMode_tag mode, uint16_t pinMask, uint16_t pinValues, const char *configSuffix, uint16_t *readValues);
+static cmdParseRslt_t S__ioBatchReadParser();
+static void S__adcSamplerDoWork();
+static void S__adcSamplerAdd(uint16_t value, uint32_t sampledAt);
 
 
 /*  GPIO functions are accessed via a single AT command
@@ -62,14 +75,14 @@ static resultCode_t S__ioValueParser(const char *response, char **endptr);
  */
 resultCode_t gpio_adcRead(uint8_t portNumber, uint16_t* analogValue)
 {
-    ASSERT(portNumber > 0 && portNumber <= adc__BG77__maxPin);
+    ASSERT(portNumber > 0 && portNumber <= QBG_getModuleCaps()->adcMaxPin);
     ASSERT_W(portNumber > 0 && portNumber <= adc__LTEM3F__maxPin, "Bad port");
 
     if (atcmd_tryInvoke("AT+QADC=%d", portNumber))
     {
         if (atcmd_awaitResultWithOptions(atcmd__defaultTimeout, S__adcValueParser) == resultCode__success)
         {
-            if (memcmp(atcmd_getResponse(), "+QADC: 1", 8) == 0)
+            if (atcmd_getResponse()[0] == '1')                                      // +QADC: <status>,<value>, status 1=success
             {
                 *analogValue = atcmd_getValue();
                 return resultCode__success;
@@ -81,12 +94,69 @@ resultCode_t gpio_adcRead(uint8_t portNumber, uint16_t* analogValue)
 }
 
 
+/**
+ *	\brief Start the ADC background sampler.
+ */
+void gpio_adcSamplerStart(uint8_t portNumber, uint32_t periodMS, uint8_t decimation, adcSample_t *ring, uint16_t ringSz)
+{
+    ASSERT(portNumber > 0 && portNumber <= QBG_getModuleCaps()->adcMaxPin);
+    ASSERT(ring != NULL && ringSz > 0 && decimation > 0);
+
+    memset(&adcSampler, 0, sizeof(adcSamplerCtrl_t));
+    adcSampler.portNumber = portNumber;
+    adcSampler.period = MAX(periodMS, adc__samplerMinPeriod);
+    adcSampler.decimation = decimation;
+    adcSampler.ring = ring;
+    adcSampler.ringSz = ringSz;
+    adcSampler.nextAt = pMillis();
+    adcSampler.isRunning = true;
+    LTEM_registerDoWorker(S__adcSamplerDoWork);
+}
+
+
+/**
+ *	\brief Stop the ADC background sampler.
+ */
+void gpio_adcSamplerStop()
+{
+    adcSampler.isRunning = false;
+}
+
+
+/**
+ *	\brief Read (remove) the oldest ADC sampler entries.
+ */
+uint16_t gpio_adcSamplerRead(adcSample_t *samples, uint16_t maxCnt)
+{
+    uint16_t readCnt = MIN(maxCnt, adcSampler.count);
+    uint16_t tail = (adcSampler.head + adcSampler.ringSz - adcSampler.count) % adcSampler.ringSz;
+    for (uint16_t i = 0; i < readCnt; i++)
+    {
+        samples[i] = adcSampler.ring[tail];
+        tail = (tail + 1) % adcSampler.ringSz;
+    }
+    adcSampler.count -= readCnt;
+    return readCnt;
+}
+
+
+/**
+ *	\brief Get the ADC sampler controls.
+ */
+const adcSamplerCtrl_t *gpio_adcSamplerGetCtrl()
+{
+    return &adcSampler;
+}
+
+
 /**
  *	\brief Configure a GPIO port for intended use.
  */
 resultCode_t gpio_configPort(uint8_t portNumber, gpioDirection_t direction, gpioPull_t pullType, gpioPullDrive_t pullDriveCurrent)
 {
-    ASSERT(portNumber > 0 && portNumber <= gpio__BG77__maxPin);
+    if (!QBG_hasFeature(moduleFeature_gpio))
+        return resultCode__methodNotAllowed;                                    // module has no host GPIO (BG96)
+    ASSERT(portNumber > 0 && portNumber <= QBG_getModuleCaps()->gpioMaxPin);
     ASSERT_W(portNumber > 0 && portNumber <= gpio__LTEM3F__maxPin, "Bad port");
 
     bool invoked;
@@ -116,7 +186,9 @@ resultCode_t gpio_configPort(uint8_t portNumber, gpioDirection_t direction, gpio
  */
 resultCode_t gpio_read(uint8_t portNumber, bool* pinValue)
 {
-    ASSERT(portNumber > 0 && portNumber <= gpio__BG77__maxPin);
+    if (!QBG_hasFeature(moduleFeature_gpio))
+        return resultCode__methodNotAllowed;                                    // module has no host GPIO (BG96)
+    ASSERT(portNumber > 0 && portNumber <= QBG_getModuleCaps()->gpioMaxPin);
     ASSERT_W(portNumber > 0 && portNumber <= gpio__LTEM3F__maxPin, "Bad port");
 
     if (atcmd_tryInvoke("AT+QCFG=\"gpio\",2,%d", portNumber))
@@ -136,10 +208,12 @@ resultCode_t gpio_read(uint8_t portNumber, bool* pinValue)
  */
 resultCode_t gpio_write(uint8_t portNumber, bool pinValue)
 {
-    ASSERT(portNumber > 0 && portNumber <= gpio__BG77__maxPin);
+    if (!QBG_hasFeature(moduleFeature_gpio))
+        return resultCode__methodNotAllowed;                                    // module has no host GPIO (BG96)
+    ASSERT(portNumber > 0 && portNumber <= QBG_getModuleCaps()->gpioMaxPin);
     ASSERT_W(portNumber > 0 && portNumber <= gpio__LTEM3F__maxPin, "Bad port");
 
-    if (atcmd_tryInvoke("AT+QCFG=\"gpio\",3,%d/%d", portNumber, pinValue))
+    if (atcmd_tryInvoke("AT+QCFG=\"gpio\",3,%d,%d", portNumber, pinValue))
     {
         if (atcmd_awaitResult() == resultCode__success)
         {
@@ -151,12 +225,47 @@ resultCode_t gpio_write(uint8_t portNumber, bool pinValue)
 
 
 
+/**
+ *	\brief Configure a set of GPIO ports with the same settings.
+ */
+resultCode_t gpio_configMany(uint16_t pinMask, gpioDirection_t direction, gpioPull_t pullType, gpioPullDrive_t pullDriveCurrent)
+{
+    char configSuffix[12];
+    if (direction == gpioDirection_input)
+        snprintf(configSuffix, sizeof(configSuffix), ",0,%d,%d", pullType, pullDriveCurrent);
+    else
+        strcpy(configSuffix, ",1");
+
+    return S__gpioBatch(gpioActionMode_init, pinMask, 0, configSuffix, NULL);
+}
+
+
+/**
+ *	\brief Read a set of GPIO ports.
+ */
+resultCode_t gpio_readMany(uint16_t pinMask, uint16_t *pinValues)
+{
+    *pinValues = 0;
+    return S__gpioBatch(gpioActionMode_read, pinMask, 0, NULL, pinValues);
+}
+
+
+/**
+ *	\brief Write a set of GPIO ports.
+ */
+resultCode_t gpio_writeMany(uint16_t pinMask, uint16_t pinValues)
+{
+    return S__gpioBatch(gpioActionMode_write, pinMask, pinValues, NULL, NULL);
+}
+
+
+
 /* Static local functions
  * --------------------------------------------------------------------------------------------- */
 
 static resultCode_t S__adcValueParser(const char *response, char **endptr)
 {
-    cmdParseRslt_t parseRslt = atcmd_stdResponseParser("+QADC: ", true, ",", 1, 0, "\r\n", 0);
+    cmdParseRslt_t parseRslt = atcmd_stdResponseParser("+QADC: ", true, ",", 2, 2, "\r\n", 0);
     return parseRslt;
 }
 
@@ -166,3 +275,151 @@ static resultCode_t S__ioValueParser(const char *response, char **endptr)
     cmdParseRslt_t parseRslt = atcmd_stdResponseParser("+QCFG: \"gpio\",", true, ",", 1, 0, "\r\n", 0);
     return parseRslt;
 }
+
+
+/**
+ *	\brief Perform a GPIO action on a set of ports as concatenated command lines under a single lock.
+ *  \details AT+QCFG="gpio",<mode>,<pin>...;+QCFG="gpio",<mode>,<pin>... BGx returns one response per concatenated command, then a single OK.
+ */
+static resultCode_t S__gpioBatch(gpioActionMode_tag mode, uint16_t pinMask, uint16_t pinValues, const char *configSuffix, uint16_t *readValues)
+{
+    if (!QBG_hasFeature(moduleFeature_gpio))
+        return resultCode__methodNotAllowed;
+
+    uint8_t maxPin = QBG_getModuleCaps()->gpioMaxPin;
+    ASSERT(pinMask != 0 && (pinMask & ~(((1U << (maxPin + 1)) - 1) & ~1U)) == 0);
+
+    if (!ATCMD_awaitLock(atcmd__defaultTimeout))
+        return resultCode__conflict;
+
+    resultCode_t rslt = resultCode__success;
+    uint8_t linePinsMax = (mode == gpioActionMode_read) ? gpio__batchReadMax : maxPin;
+    uint8_t pin = 1;
+    while (rslt == resultCode__success && pin <= maxPin)
+    {
+        char cmdLine[gpio__batchLineSz] = "AT";
+        uint8_t linePins[gpio__BG77__maxPin];
+        uint8_t linePinCnt = 0;
+
+        for (; pin <= maxPin && linePinCnt < linePinsMax; pin++)                    // build a line: up to linePinsMax commands
+        {
+            if (!(pinMask & GPIO_PIN(pin)))
+                continue;
+
+            uint16_t cmdLen = strlen(cmdLine);
+            char *cmdPtr = cmdLine + cmdLen;
+            uint16_t remaining = sizeof(cmdLine) - cmdLen;
+            if (linePinCnt > 0)
+            {
+                *cmdPtr++ = ';';
+                remaining--;
+            }
+            if (mode == gpioActionMode_init)
+                snprintf(cmdPtr, remaining, "+QCFG=\"gpio\",1,%d%s", pin, configSuffix);
+            else if (mode == gpioActionMode_read)
+                snprintf(cmdPtr, remaining, "+QCFG=\"gpio\",2,%d", pin);
+            else
+                snprintf(cmdPtr, remaining, "+QCFG=\"gpio\",3,%d,%d", pin, (pinValues & GPIO_PIN(pin)) ? 1 : 0);
+            linePins[linePinCnt++] = pin;
+        }
+        if (linePinCnt == 0)
+            break;
+
+        atcmd_invokeReuseLock("%s", cmdLine);
+        if (mode != gpioActionMode_read)
+        {
+            rslt = atcmd_awaitResult();
+            continue;
+        }
+
+        rslt = atcmd_awaitResultWithOptions(atcmd__defaultTimeout, S__ioBatchReadParser);
+        if (rslt != resultCode__success)
+            break;
+
+        const char *responsePtr = atcmd_getResponse();                              // at 1st value (past preamble), responses in pin order
+        for (uint8_t i = 0; i < linePinCnt; i++)
+        {
+            if (responsePtr == NULL)
+            {
+                rslt = resultCode__internalError;                                   // fewer responses than commands
+                break;
+            }
+            if (strtol(responsePtr, NULL, 10))
+                *readValues |= GPIO_PIN(linePins[i]);
+
+            responsePtr = strstr(responsePtr, GPIO_RESPONSE_PREAMBLE);
+            responsePtr = responsePtr ? responsePtr + strlen(GPIO_RESPONSE_PREAMBLE) : NULL;
+        }
+    }
+    atcmd_close();
+    return rslt;
+}
+
+
+/**
+ *	\brief Parser for concatenated GPIO reads, completes at the single trailing OK.
+ */
+static cmdParseRslt_t S__ioBatchReadParser()
+{
+    return atcmd_stdResponseParser(GPIO_RESPONSE_PREAMBLE, true, "", 0, 0, "OK\r\n", 0);
+}
+
+
+/**
+ *	\brief ADC sampler background worker, invoked by ltem_eventMgr() when no command is underway.
+ *  \details At most one sample per pass; application commands are never delayed more than one AT+QADC exchange.
+ */
+static void S__adcSamplerDoWork()
+{
+    if (!adcSampler.isRunning || adcSampler.isBusy || (int32_t)(pMillis() - adcSampler.nextAt) < 0)
+        return;
+
+    uint32_t sampledAt = pMillis();
+    uint32_t lateBy = sampledAt - adcSampler.nextAt;
+    if (lateBy >= adcSampler.period)                                                // AT channel was busy for whole period(s)
+    {
+        adcSampler.missedCnt += lateBy / adcSampler.period;
+        adcSampler.nextAt = sampledAt;                                              // resync schedule, don't burst to catch up
+    }
+    adcSampler.nextAt += adcSampler.period;
+
+    adcSampler.isBusy = true;
+    uint16_t value;
+    if (gpio_adcRead(adcSampler.portNumber, &value) == resultCode__success)
+        S__adcSamplerAdd(value, sampledAt);
+    else
+        adcSampler.missedCnt++;
+    adcSampler.isBusy = false;
+}
+
+
+/**
+ *	\brief Add a sample to the decimation window, the window summary is written to the ring when complete.
+ */
+static void S__adcSamplerAdd(uint16_t value, uint32_t sampledAt)
+{
+    adcSample_t *window = &adcSampler.window;
+    if (window->count == 0)
+    {
+        window->timestamp = sampledAt;
+        window->min = value;
+        window->max = value;
+        adcSampler.windowSum = 0;
+    }
+    window->min = MIN(window->min, value);
+    window->max = MAX(window->max, value);
+    adcSampler.windowSum += value;
+    if (++window->count < adcSampler.decimation)
+        return;
+
+    window->mean = adcSampler.windowSum / window->count;
+    adcSampler.ring[adcSampler.head] = *window;
+    adcSampler.head = (adcSampler.head + 1) % adcSampler.ringSz;
+    if (adcSampler.count == adcSampler.ringSz)
+        adcSampler.overrunCnt++;                                                    // oldest unread entry overwritten
+    else
+        adcSampler.count++;
+    window->count = 0;
+}
+
+#endif  // LTEMC_ENABLE_GPIO
@@ -37,8 +37,15 @@ enum gpio__constants
 
     gpio__LTEM3F__maxPin = 6,
     adc__LTEM3F__maxPin = 2,
+
+    adc__samplerMinPeriod = 50,         /// min ADC sampler period (mS), each sample is an AT+QADC exchange
+
+    gpio__batchLineSz = 240,            /// max chars in a concatenated GPIO command line
+    gpio__batchReadMax = 5,             /// max pins read per command line, responses must fit atcmd response buffer
 };
 
+#define GPIO_PIN(n) (1U << (n))         /// pin mask bit for GPIO pin n (pins are numbered from 1, bit 0 unused)
+
 
 typedef enum gpioActionMode_tag
 {
@@ -79,6 +86,41 @@ typedef enum gpioPullDrive_tag
 } gpioPullDrive_t;
 
 
+/** 
+ *  \brief ADC sampler ring entry, a single sample or a decimation window summary.
+*/
+typedef struct adcSample_tag
+{
+    uint32_t timestamp;                 /// tick count (mS) of the (window's first) sample
+    uint16_t mean;                      /// sample value, or mean of window samples
+    uint16_t min;                       /// min of window samples
+    uint16_t max;                       /// max of window samples
+    uint8_t count;                      /// samples in window
+} adcSample_t;
+
+
+/** 
+ *  \brief ADC background sampler controls (singleton), ring storage provided by the application.
+*/
+typedef struct adcSamplerCtrl_tag
+{
+    uint8_t portNumber;                 /// ADC port sampled
+    uint32_t period;                    /// sample period (mS)
+    uint32_t nextAt;                    /// tick count next sample is due
+    uint8_t decimation;                 /// samples per ring entry, 1 = no decimation
+    adcSample_t *ring;                  /// application provided ring buffer
+    uint16_t ringSz;                    /// ring capacity (entries)
+    uint16_t head;                      /// next ring entry to write
+    uint16_t count;                     /// ring entries available to read
+    adcSample_t window;                 /// decimation window being accumulated
+    uint32_t windowSum;
+    uint32_t missedCnt;                 /// samples skipped, AT channel busy beyond a full period
+    uint32_t overrunCnt;                /// unread ring entries overwritten
+    bool isRunning;
+    bool isBusy;                        /// reentrancy guard, atcmd await loops invoke ltem_eventMgr()
+} adcSamplerCtrl_t;
+
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -90,6 +132,38 @@ extern "C" {
 resultCode_t gpio_adcRead(uint8_t portNumber, uint16_t* analogValue);
 
 
+/**
+ *	\brief Start the ADC background sampler, samples are taken by ltem_eventMgr() between other AT commands.
+ *	\param [in] portNumber - The ADC port to sample.
+ *	\param [in] periodMS - Sample period in milliseconds (min adc__samplerMinPeriod).
+ *	\param [in] decimation - Samples summarized (min/max/mean) per ring entry, 1 for no decimation.
+ *	\param [in] ring - Application buffer for sampler entries, oldest entries are overwritten when full.
+ *	\param [in] ringSz - Capacity of ring (entries).
+ */
+void gpio_adcSamplerStart(uint8_t portNumber, uint32_t periodMS, uint8_t decimation, adcSample_t *ring, uint16_t ringSz);
+
+
+/**
+ *	\brief Stop the ADC background sampler, unread entries remain available.
+ */
+void gpio_adcSamplerStop();
+
+
+/**
+ *	\brief Read (remove) the oldest ADC sampler entries.
+ *	\param [out] samples - Destination for entries, oldest first.
+ *	\param [in] maxCnt - Max entries to read.
+ *  \return Count of entries read.
+ */
+uint16_t gpio_adcSamplerRead(adcSample_t *samples, uint16_t maxCnt);
+
+
+/**
+ *	\brief Get the ADC sampler controls, entries available and missed/overrun counts.
+ */
+const adcSamplerCtrl_t *gpio_adcSamplerGetCtrl();
+
+
 /**
  *	\brief Configure a GPIO port for intended use.
  *	\param [in] portNumber - The GPIO port to configured, dependent on modem module and modem board.
@@ -118,6 +192,35 @@ resultCode_t gpio_read(uint8_t portNumber, bool* pinValue);
 resultCode_t gpio_write(uint8_t portNumber, bool pinValue);
 
 
+/**
+ *	\brief Configure a set of GPIO ports with the same settings, sent as concatenated AT command line.
+ *	\param [in] pinMask - Ports to configure, GPIO_PIN(n) bits.
+ *	\param [in] direction - Set the GPIO ports to be for input or output.
+ *	\param [in] pullType - Input pull up/down behavior. Ignored if "direction" is output.
+ *	\param [in] pullDriveCurrent - Input pull current limit. Ignored if "direction" is output.
+ *  \return Result code, 200 = all ports configured, 405 = module has no GPIO.
+ */
+resultCode_t gpio_configMany(uint16_t pinMask, gpioDirection_t direction, gpioPull_t pullType, gpioPullDrive_t pullDriveCurrent);
+
+
+/**
+ *	\brief Read a set of GPIO ports, sent as concatenated AT command lines (gpio__batchReadMax ports per line).
+ *	\param [in] pinMask - Ports to read, GPIO_PIN(n) bits.
+ *	\param [out] pinValues - Bitmap of port values, GPIO_PIN(n) bits; bits not in pinMask are 0.
+ *  \return Result code, 200 = all ports read, 405 = module has no GPIO.
+ */
+resultCode_t gpio_readMany(uint16_t pinMask, uint16_t *pinValues);
+
+
+/**
+ *	\brief Write a set of GPIO ports, sent as concatenated AT command line.
+ *	\param [in] pinMask - Ports to write, GPIO_PIN(n) bits.
+ *	\param [in] pinValues - Bitmap of values to write, GPIO_PIN(n) bits; bits not in pinMask are ignored.
+ *  \return Result code, 200 = all ports written, 405 = module has no GPIO.
+ */
+resultCode_t gpio_writeMany(uint16_t pinMask, uint16_t pinValues);
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,231 @@
+/** ****************************************************************************
+  \file 
+  \brief Public API LTEm health monitor: liveness probes and escalating recovery
+  \author Greg Terrell, LooUQ Incorporated
+
+  \loouq
+
+--------------------------------------------------------------------------------
+
+    This project is released under the GPL-3.0 License.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ 
+***************************************************************************** */
+
+
+#define _DEBUG 0                                // set to non-zero value for PRINTF debugging output, 
+// debugging output options                     // LTEm1c will satisfy PRINTF references with empty definition if not already resolved
+#if _DEBUG > 0
+    asm(".global _printf_float");               // forces build to link in float support for printf
+    #if _DEBUG == 1
+    #define SERIAL_DBG 1                        // enable serial port output using devl host platform serial, 1=wait for port
+    #elif _DEBUG == 2
+    #include <jlinkRtt.h>                       // output debug PRINTF macros to J-Link RTT channel
+    #define PRINTF(c_,f_,__VA_ARGS__...) do { rtt_printf(c_, (f_), ## __VA_ARGS__); } while(0)
+    #endif
+#else
+#define PRINTF(c_, f_, ...) 
+#endif
+
+#define SRCFILE "HLT"                           // create SRCFILE (3 char) MACRO for lq-diagnostics ASSERT
+#include "ltemc-internal.h"
+#include "ltemc-health.h"
+
+extern ltemDevice_t g_lqLTEM;
+
+#if LTEMC_ENABLE_HEALTH                         // module selection, see ltemc-config.h
+
+
+// private local declarations
+static bool S__probe();
+static bool S__attemptRecovery(recoveryLevel_t level);
+
+
+#pragma region public functions
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ *	@brief Enable the health monitor, liveness probes are performed from ltem_eventMgr().
+ */
+void health_enable(uint32_t probeIntervalMs, uint8_t failThreshold, healthRecovery_func recoveryCB)
+{
+    g_lqLTEM.health.probeInterval = (probeIntervalMs == 0) ? health__defaultProbeInterval : probeIntervalMs;
+    g_lqLTEM.health.failThreshold = (failThreshold == 0) ? health__defaultFailThreshold : failThreshold;
+    g_lqLTEM.health.recoveryCB = recoveryCB;
+    g_lqLTEM.health.probeFailures = 0;
+    g_lqLTEM.health.lastProbeAt = pMillis();
+    g_lqLTEM.health.enabled = true;
+}
+
+
+/**
+ *	@brief Disable the health monitor.
+ */
+void health_disable()
+{
+    g_lqLTEM.health.enabled = false;
+}
+
+
+/**
+ *	@brief Start recovery immediately, escalating from a starting level until BGx responds.
+ */
+recoveryLevel_t health_recover(recoveryLevel_t startLevel)
+{
+    ASSERT(startLevel > recoveryLevel_none && startLevel < recoveryLevel_failed);
+
+    bool wasBusy = g_lqLTEM.health.isBusy;
+    g_lqLTEM.health.isBusy = true;
+    g_lqLTEM.health.recoveryCnt++;
+    g_lqLTEM.health.lastRecoveryAt = pMillis();
+
+    recoveryLevel_t level = startLevel;
+    for (; level < recoveryLevel_failed; level = (recoveryLevel_t)(level + 1))
+    {
+        bool recovered = S__attemptRecovery(level);
+        PRINTF(dbgColor__warn, "Recovery L%d: %s\r", level, recovered ? "OK" : "fail");
+
+        if (g_lqLTEM.health.recoveryCB != NULL)
+            (g_lqLTEM.health.recoveryCB)(level, recovered);
+
+        if (recovered)
+        {
+            if (level >= recoveryLevel_swReset)                             // BGx restarted, protocol/socket state was lost
+                LTEM_reestablishStreams();
+            break;
+        }
+    }
+
+    g_lqLTEM.health.lastLevel = level;
+    g_lqLTEM.health.lastRecoveryDuration = pMillis() - g_lqLTEM.health.lastRecoveryAt;
+    g_lqLTEM.health.probeFailures = 0;
+    g_lqLTEM.health.lastProbeAt = pMillis();
+    g_lqLTEM.health.isBusy = wasBusy;
+
+    if (level == recoveryLevel_failed)
+        ltem_notifyApp(appEvent_fault_hardFault, "LTEm recovery failed");
+    return level;
+}
+
+
+/**
+ *	@brief Get health monitor controls and statistics.
+ */
+const healthCtrl_t *health_getStatus()
+{
+    return &g_lqLTEM.health;
+}
+
+#pragma endregion
+
+
+#pragma region LTEmC Internal
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ *	@brief Health monitor background work, invoked from ltem_eventMgr().
+ */
+void HEALTH_doWork()
+{
+    if (!g_lqLTEM.health.enabled || g_lqLTEM.health.isBusy || ATCMD_isLockActive() || ATCMD_isLockPending())  // no probing while a command is underway/queued
+        return;
+
+    uint32_t now = pMillis();
+    if (now - g_lqLTEM.health.lastProbeAt < g_lqLTEM.health.probeInterval)
+        return;
+    g_lqLTEM.health.lastProbeAt = now;
+
+    if (IOP_getRxIdleDuration() < g_lqLTEM.health.probeInterval)                        // BGx has sent recently, it is alive
+    {
+        g_lqLTEM.health.probeFailures = 0;
+        return;
+    }
+
+    g_lqLTEM.health.isBusy = true;
+    if (S__probe())
+    {
+        g_lqLTEM.health.probeFailures = 0;
+    }
+    else if (++g_lqLTEM.health.probeFailures >= g_lqLTEM.health.failThreshold)
+    {
+        PRINTF(dbgColor__warn, "LTEm unresponsive, starting recovery\r");
+        health_recover(recoveryLevel_bridgeResync);
+    }
+    g_lqLTEM.health.isBusy = false;
+}
+
+#pragma endregion
+
+
+#pragma region Static Function Definitions
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ *	@brief Cheap liveness check: "AT" with a short timeout.
+ */
+static bool S__probe()
+{
+    g_lqLTEM.health.probeCnt++;
+    if (atcmd_tryInvoke("AT"))
+    {
+        return atcmd_awaitResultWithOptions(health__probeTimeout, NULL) == resultCode__success;
+    }
+    return false;
+}
+
+
+/**
+ *	@brief Perform a single recovery level action and verify BGx responds.
+ */
+static bool S__attemptRecovery(recoveryLevel_t level)
+{
+    atcmd_reset(true);                                                          // abandon any in-flight command and its lock
+
+    switch (level)
+    {
+        case recoveryLevel_bridgeResync:
+            if (!QBG_isPowerOn() || !SC16IS7xx_isAvailable())                   // bridge not reachable over SPI or BGx off, escalate
+                return false;
+            SC16IS7xx_start();                                                  // re-initialize NXP SPI-UART bridge: FIFO, levels, baud, framing
+            SC16IS7xx_enableIrqMode();
+            IOP_resetRxBuffer();
+            QBG_clearDataState();                                               // BGx may be sitting in data mode awaiting EOT
+            break;
+
+        case recoveryLevel_swReset:
+            LTEM_restart(resetAction_swReset);
+            break;
+
+        case recoveryLevel_hwReset:
+            LTEM_restart(resetAction_hwReset);
+            break;
+
+        case recoveryLevel_powerCycle:
+            LTEM_restart(resetAction_powerReset);
+            break;
+
+        default:
+            return false;
+    }
+
+    if (level >= recoveryLevel_swReset && ltem_getStartState() != startState_ready)
+        return false;
+    return S__probe();
+}
+
+
+#pragma endregion
+
+#endif  // LTEMC_ENABLE_HEALTH
@@ -0,0 +1,139 @@
+/** ****************************************************************************
+  \file 
+  \brief Public API LTEm health monitor: liveness probes and escalating recovery
+  \author Greg Terrell, LooUQ Incorporated
+
+  \loouq
+
+--------------------------------------------------------------------------------
+
+    This project is released under the GPL-3.0 License.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ 
+***************************************************************************** */
+
+
+#ifndef __LTEMC_HEALTH_H__
+#define __LTEMC_HEALTH_H__
+
+#include "ltemc.h"
+
+
+/** 
+ *  @brief Typed numeric constants for health monitor.
+ */
+enum health__constants
+{
+    health__defaultProbeInterval = 30000,       /// mS between liveness probes, probe skipped if RX traffic within interval
+    health__probeTimeout = 300,                 /// mS, AT is answered by a healthy BGx in < 50mS
+    health__defaultFailThreshold = 2            /// consecutive probe failures before recovery is started
+};
+
+
+/** 
+ *  @brief Recovery escalation ladder, each level is more intrusive than the previous.
+ */
+typedef enum recoveryLevel_tag
+{
+    recoveryLevel_none = 0,
+    recoveryLevel_bridgeResync = 1,             /// re-initialize NXP SPI-UART bridge, BGx state is kept
+    recoveryLevel_swReset = 2,                  /// BGx soft reset: AT+CFUN=1,1
+    recoveryLevel_hwReset = 3,                  /// BGx reset pin
+    recoveryLevel_powerCycle = 4,               /// BGx power off/on
+    recoveryLevel_failed = 5                    /// all levels attempted without recovery
+} recoveryLevel_t;
+
+
+/** 
+ *  @brief Callback function for health monitor recovery progress.
+ *  @param [in] level The recovery level attempted.
+ *  @param [in] recovered True if BGx responded following the recovery action.
+ */
+typedef void (*healthRecovery_func)(recoveryLevel_t level, bool recovered);
+
+
+/** 
+ *  @brief Health monitor controls and statistics.
+ */
+typedef struct healthCtrl_tag
+{
+    bool enabled;                               /// health monitor active (serviced by ltem_eventMgr)
+    bool isBusy;                                /// reentrancy guard, probe/recovery commands invoke ltem_eventMgr()
+    uint32_t probeInterval;                     /// mS between liveness checks
+    uint8_t failThreshold;                      /// consecutive failures to start recovery
+    uint8_t probeFailures;                      /// current consecutive probe failures
+    uint32_t lastProbeAt;                       /// tick count of last liveness check (probe or skipped for traffic)
+    recoveryLevel_t lastLevel;                  /// level reached in last recovery
+    uint16_t probeCnt;                          /// count of AT probes sent
+    uint16_t recoveryCnt;                       /// count of recoveries started
+    uint32_t lastRecoveryAt;                    /// tick count when last recovery started
+    uint32_t lastRecoveryDuration;              /// mS from recovery start to BGx responding (or failure)
+    healthRecovery_func recoveryCB;             /// optional application callback for recovery progress
+} healthCtrl_t;
+
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+
+/**
+ *	@brief Enable the health monitor, liveness probes are performed from ltem_eventMgr().
+ *  @param [in] probeIntervalMs Period between liveness checks, 0 for default. Probes are skipped if BGx has sent data within the period.
+ *  @param [in] failThreshold Consecutive probe failures before recovery is started, 0 for default.
+ *  @param [in] recoveryCB Optional callback to notify application of recovery actions and results.
+ */
+void health_enable(uint32_t probeIntervalMs, uint8_t failThreshold, healthRecovery_func recoveryCB);
+
+
+/**
+ *	@brief Disable the health monitor.
+ */
+void health_disable();
+
+
+/**
+ *	@brief Start recovery immediately, escalating from a starting level until BGx responds.
+ *  @details Following a BGx reset recovery (swReset or higher), registered streams are re-established.
+ *  @param [in] startLevel Initial recovery level, escalates through higher levels as required.
+ *  @return The recovery level that restored communications, recoveryLevel_failed if not recovered.
+ */
+recoveryLevel_t health_recover(recoveryLevel_t startLevel);
+
+
+/**
+ *	@brief Get health monitor controls and statistics.
+ *  @return Pointer to health monitor state (read-only)
+ */
+const healthCtrl_t *health_getStatus();
+
+
+#pragma region LTEmC Internal
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ *	@brief Health monitor background work, invoked from ltem_eventMgr().
+ */
+void HEALTH_doWork();
+
+#pragma endregion
+
+
+#ifdef __cplusplus
+}
+#endif // !__cplusplus
+
+#endif  // !__LTEMC_HEALTH_H__
@@ -45,10 +45,16 @@
 
 extern ltemDevice_t g_lqLTEM;
 
+#if LTEMC_ENABLE_HTTP                           // module selection, see ltemc-config.h
+
 #define MIN(x, y) (((x) < (y)) ? (x) : (y))
 #define MAX(X, Y) (((X) > (Y)) ? (X) : (Y))
 
 
+/* BGx has a single HTTP(S) service, the SSL context bound to it is retained until BGx restarts */
+static int8_t S__httpSslCntxt = -1;             /// SSL context last bound with QHTTPCFG "sslctxid", -1=none
+static uint32_t S__httpSslCntxtAt = 0;          /// BGx start (startCtrl.startedAt) the binding was made in
+
 /* Local Static Functions
 ------------------------------------------------------------------------------------------------------------------------- */
 // static void S_httpDoWork();
@@ -56,7 +62,9 @@ static uint16_t S__parseResponseForHttpStatus(httpCtrl_t *httpCtrl, const char *
 static uint16_t S__setUrl(const char *host, const char *relative);
 static cmdParseRslt_t S__httpGetStatusParser();
 static cmdParseRslt_t S__httpPostStatusParser();
+static cmdParseRslt_t S__httpReadFileStatusParser();
 static resultCode_t S__httpRxHndlr();
+static bool S__isSslCntxtBound(uint8_t dataCntxt);
 
 
 /* Public Functions
@@ -215,7 +223,7 @@ resultCode_t http_get(httpCtrl_t *httpCtrl, const char* relativeUrl, bool return
     strcpy(httpCtrl->requestType, "GET");
     resultCode_t rslt;
 
-    if (ATCMD_awaitLock(httpCtrl->timeoutSec))
+    if (ATCMD_awaitLockPriority(PERIOD_FROM_SECONDS(httpCtrl->timeoutSec), atcmdPriority_bulk, "http"))    // bulk class, yields to control-plane at step boundaries
     {
         if (returnResponseHdrs)
         {
@@ -228,7 +236,7 @@ resultCode_t http_get(httpCtrl_t *httpCtrl, const char* relativeUrl, bool return
             }
         }
 
-        if (httpCtrl->useTls)
+        if (httpCtrl->useTls && !S__isSslCntxtBound(httpCtrl->dataCntxt))
         {
             // AT+QHTTPCFG="sslctxid",<httpCtrl->sckt>
             atcmd_invokeReuseLock("AT+QHTTPCFG=\"sslctxid\",%d",  (int)httpCtrl->dataCntxt);
@@ -238,6 +246,8 @@ resultCode_t http_get(httpCtrl_t *httpCtrl, const char* relativeUrl, bool return
                 atcmd_close();
                 return rslt;
             }
+            S__httpSslCntxt = httpCtrl->dataCntxt;
+            S__httpSslCntxtAt = g_lqLTEM.startCtrl.startedAt;
         }
 
         /* SET URL FOR REQUEST
@@ -247,6 +257,9 @@ resultCode_t http_get(httpCtrl_t *httpCtrl, const char* relativeUrl, bool return
         * NOTE: there is only 1 URL in the BGx at a time
         *---------------------------------------------------------------------------------------------------------------*/
 
+        if (!ATCMD_yieldLock(PERIOD_FROM_SECONDS(httpCtrl->timeoutSec)))                             // lock is released if yield fails
+            return resultCode__timeout;
+
         rslt = S__setUrl(httpCtrl->hostUrl, relativeUrl);
         if (rslt != resultCode__success)
         {
@@ -327,7 +340,7 @@ resultCode_t http_post(httpCtrl_t *httpCtrl, const char *relativeUrl, bool retur
     strcpy(httpCtrl->requestType, "POST");
     resultCode_t rslt;
 
-    if (ATCMD_awaitLock(httpCtrl->timeoutSec))
+    if (ATCMD_awaitLockPriority(PERIOD_FROM_SECONDS(httpCtrl->timeoutSec), atcmdPriority_bulk, "http"))    // bulk class, yields to control-plane at step boundaries
     {
         if (returnResponseHdrs)
         {
@@ -341,7 +354,7 @@ resultCode_t http_post(httpCtrl_t *httpCtrl, const char *relativeUrl, bool retur
             }
         }
 
-        if (httpCtrl->useTls)
+        if (httpCtrl->useTls && !S__isSslCntxtBound(httpCtrl->dataCntxt))
         {
             // AT+QHTTPCFG="sslctxid",<httpCtrl->sckt>
             atcmd_invokeReuseLock("AT+QHTTPCFG=\"sslctxid\",%d",  (int)httpCtrl->dataCntxt);
@@ -351,6 +364,8 @@ resultCode_t http_post(httpCtrl_t *httpCtrl, const char *relativeUrl, bool retur
                 atcmd_close();
                 return rslt;
             }
+            S__httpSslCntxt = httpCtrl->dataCntxt;
+            S__httpSslCntxtAt = g_lqLTEM.startCtrl.startedAt;
         }
 
         /* SET URL FOR REQUEST
@@ -360,6 +375,9 @@ resultCode_t http_post(httpCtrl_t *httpCtrl, const char *relativeUrl, bool retur
         * NOTE: there is only 1 URL in the BGx at a time
         *---------------------------------------------------------------------------------------------------------------*/
 
+        if (!ATCMD_yieldLock(PERIOD_FROM_SECONDS(httpCtrl->timeoutSec)))                             // lock is released if yield fails
+            return resultCode__timeout;
+
         rslt = S__setUrl(httpCtrl->hostUrl, relativeUrl);
         if (rslt != resultCode__success)
         {
@@ -440,7 +458,7 @@ uint16_t http_readPage(httpCtrl_t *httpCtrl)
     cBuffer_t* rxBffr = g_lqLTEM.iop->rxBffr;                                   // for better readability
     char* workPtr;
 
-    if (atcmd_tryInvoke("AT+QHTTPREAD=%d", httpCtrl->timeoutSec))
+    if (atcmd_tryInvokeFmt(atcmdFmt_qhttpread, httpCtrl->timeoutSec))
     {
         atcmd_configDataMode(httpCtrl->dataCntxt, "CONNECT", S__httpRxHndlr, NULL, 0, httpCtrl->appRecvDataCB, true);
         // atcmd_setStreamControl("CONNECT", (streamCtrl_t*)httpCtrl);
@@ -458,6 +476,27 @@ void http_cancelPage(httpCtrl_t *httpCtrl)
 }
 
 
+/**
+ *	@brief Saves page results from a previous GET or POST to a BGx file (UFS).
+ *  -----------------------------------------------------------------------------------------------
+ */
+resultCode_t http_readPageToFile(httpCtrl_t *httpCtrl, const char *filename)
+{
+    if (httpCtrl->requestState != httpState_requestComplete)
+        return resultCode__preConditionFailed;                                  // only valid after a completed GET\POST
+
+    resultCode_t rslt = resultCode__conflict;
+    if (atcmd_tryInvokeFmt(atcmdFmt_qhttpreadfile, filename, httpCtrl->timeoutSec))
+    {
+        rslt = atcmd_awaitResultWithOptions(PERIOD_FROM_SECONDS(httpCtrl->timeoutSec), S__httpReadFileStatusParser);
+        if (rslt == resultCode__success && atcmd_getValue() != 0)
+            rslt = atcmd_getValue();                                            // BGx HTTP error (7xx)
+    }
+    httpCtrl->requestState = httpState_idle;                                    // page is consumed
+    return rslt;
+}
+
+
 #pragma endregion
 
 
@@ -507,21 +546,32 @@ static resultCode_t S__setUrl(const char *host, const char *relative)
  */
 static uint16_t S__parseResponseForHttpStatus(httpCtrl_t *httpCtrl, const char *response)
 {
-    char *continueAt = strchr(response, ',');                               // skip ',' and parse http status
-    if (continueAt)
+    // <err>[,<httprspcode>[,<content_length>]]
+    static const atcmdField_t statusFields[] =
     {
-        httpCtrl->httpStatus = strtol(++continueAt, &continueAt, 10);
-        httpCtrl->pageSize = strtol(++continueAt, &continueAt, 10);         // skip next ',' and parse content length
-
-        httpCtrl->pageRemaining = 0;
-        if (httpCtrl->pageSize > 0)
-            httpCtrl->pageRemaining = httpCtrl->pageSize;                   // read() will decrement this
-    }
+        ATCMD_FIELD_SKIP,
+        ATCMD_FIELD(atcmdField_int, httpCtrl_t, httpStatus),
+        ATCMD_FIELD(atcmdField_int, httpCtrl_t, pageSize)
+    };
+    static const atcmdSchema_t statusSchema = ATCMD_SCHEMA("", statusFields, 2);
+
+    httpCtrl->pageSize = 0;
+    if (atcmd_parseFields(response, &statusSchema, httpCtrl, NULL))
+        httpCtrl->pageRemaining = httpCtrl->pageSize;                       // read() will decrement this
     else
         httpCtrl->httpStatus = resultCode__preConditionFailed;
     return httpCtrl->httpStatus;
 }
 
+/**
+ * @brief Test if the SSL context is the one bound to the BGx HTTP service in the current BGx start
+ */
+static bool S__isSslCntxtBound(uint8_t dataCntxt)
+{
+    return S__httpSslCntxt == dataCntxt && S__httpSslCntxtAt == g_lqLTEM.startCtrl.startedAt;
+}
+
+
 /**
  * @brief Handles the READ data flow from the BGx (via rxBffr) to app
  */
@@ -608,4 +658,12 @@ static cmdParseRslt_t S__httpPostStatusParser()
     return atcmd_stdResponseParser("+QHTTPPOST: ", true, ",", 0, 1, "\r\n", 0);
 }
 
-#pragma endregion
\ No newline at end of file
+static cmdParseRslt_t S__httpReadFileStatusParser() 
+{
+    // +QHTTPREADFILE: <err>
+    return atcmd_stdResponseParser("+QHTTPREADFILE: ", true, ",", 0, 0, "\r\n", 0);
+}
+
+#pragma endregion
+
+#endif  // LTEMC_ENABLE_HTTP
@@ -89,6 +89,7 @@ typedef struct httpCtrl_tag
     dataCntxt_t dataCntxt;                      /// integer representing the source of the stream; fixed for protocols, file handle for FS
     dataRxHndlr_func dataRxHndlr;               /// function to handle data streaming, initiated by eventMgr() or atcmd module
     urcEvntHndlr_func urcEvntHndlr;             /// function to determine if "potential" URC event is for an open stream and perform reqd actions
+    recoverHndlr_func recoverHndlr;             /// function to reopen stream following BGx restart, NULL if stream is not reopened
 
     /* Above section of <stream>Ctrl structure is the same for all LTEmC implemented streams/protocols TCP/HTTP/MQTT etc. 
     */
@@ -193,6 +194,8 @@ resultCode_t http_post(httpCtrl_t *httpCtrl, const char* relativeUrl, bool retur
 
 /**
  *	@brief Retrieves page results from a previous GET or POST.
+ *  @details The page is streamed by the BGx as a single data mode transfer, the AT channel is held until the page is complete.
+ *  For large pages use http_readPageToFile() and file_readBackground(), which releases the channel between chunks.
 
  *  @param [in] httpCtrl Pointer to the control block for HTTP communications.
  *  @return HTTP status of read.
@@ -207,6 +210,15 @@ uint16_t http_readPage(httpCtrl_t *httpCtrl);
  */
 void http_cancelPage(httpCtrl_t *httpCtrl);
 
+/**
+ *	@brief Saves page results from a previous GET or POST to a BGx file (UFS), instead of streaming to the application.
+
+ *  @param [in] httpCtrl Pointer to the control block for HTTP communications.
+ *  @param [in] filename BGx file to write, ex: "UFS:xtra2.bin". An existing file is overwritten.
+ *  @return Result code representing status of operation, OK = 200. BGx HTTP errors (7xx) are returned as-is.
+ */
+resultCode_t http_readPageToFile(httpCtrl_t *httpCtrl, const char *filename);
+
 
 // future support for fileSystem destinations, requires file_ module still under development planned for v2.1
 /*
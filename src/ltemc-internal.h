@@ -61,6 +61,8 @@ typedef struct ltemMetrics_tag
 {
     // metrics
     uint32_t cmdInvokes;
+    uint32_t cmdCacheHits;                      /// atcmd result cache, served without BGx round-trip
+    uint32_t cmdCacheMisses;                    /// atcmd result cache, opted-in command sent to BGx
 
 } ltemMetrics_t;
 
@@ -75,6 +77,25 @@ typedef enum recvEvent_tag
 } recvEvent_t;
 
 
+/**
+ * @brief Controls for the non-blocking LTEm start sequence, advanced by ltem_eventMgr()
+ */
+typedef struct startCtrl_tag
+{
+    startState_t state;                         /// current state of the start sequence
+    resetAction_t resetAction;                  /// reset action requested by the application at start
+    bool ltemReset;                             /// true if BGx will (re)start its firmware and send APP RDY
+    bool isBusy;                                /// reentrancy guard, atcmd await loops invoke ltem_eventMgr()
+    uint32_t startedAt;                         /// tick count when start sequence was requested
+    uint32_t stateAt;                           /// tick count when current state was entered
+    uint32_t providerCheckAt;                   /// tick count of last provider check (awaitProvider state)
+    uint8_t step;                               /// command step within the current state, one command per pass
+    uint8_t tries;                              /// attempts at the BGx start script (setOptions state)
+    bool cmdPending;                            /// step command sent, result is polled on following passes
+    startProgress_func progressCB;              /// optional application callback for start progress
+} startCtrl_t;
+
+
 typedef struct fileCtrl_tag
 {
     char streamType;                            /// stream type
@@ -84,6 +105,14 @@ typedef struct fileCtrl_tag
     uint8_t handle;
     dataRxHndlr_func dataRxHndlr;               /// function to handle data streaming, initiated by atcmd dataMode (RX only)
     appRcvProto_func appRecvDataCB;
+
+    // background (chunked) read job, file_readBackground()
+    bool jobActive;
+    uint8_t jobHandle;
+    uint16_t jobChunkSz;
+    uint32_t jobRemaining;                      /// bytes remaining to read, UINT32_MAX = read to end of file
+    uint32_t jobDelivered;                      /// bytes delivered to app receiver
+    resultCode_t jobResult;
 } fileCtrl_t;
 
 
@@ -97,8 +126,13 @@ typedef struct ltemDevice_tag
 	ltemPinConfig_t pinConfig;                  /// GPIO pin configuration for required GPIO and SPI interfacing
     bool cancellationRequest;                   /// For RTOS implementations, token to request cancellation of long running task/action
     deviceState_t deviceState;                  /// Device state of the BGx module
+    startCtrl_t startCtrl;                      /// Non-blocking start sequence controls
+    statusMonitor_t statusMon;                  /// BGx status pin edge monitor
+    healthCtrl_t health;                        /// liveness probes and recovery
+    timeCtrl_t timeCtrl;                        /// network time service
     appEvntNotify_func appEvntNotifyCB;         /// Event notification callback to parent application
     char moduleType[ltem__moduleTypeSz];        /// c-str indicating module type. BG96, BG95-M3, BG77, etc. (so far)
+    const moduleCaps_t *moduleCaps;             /// timing and capabilities for the module type, NULL until identified
     void *spi;                                  /// SPI device (methods signatures compatible with Arduino)
     iop_t *iop;                                 /// IOP subsystem controls
     atcmd_t *atcmd;                             /// Action subsystem controls
@@ -106,6 +140,8 @@ typedef struct ltemDevice_tag
 	modemInfo_t *modemInfo;                     /// Data structure holding persistent information about application modem state
     providerInfo_t *providerInfo;               /// Data structure representing the cellular network provider and the networks (PDP contexts it provides)
     streamCtrl_t* streams[ltem__streamCnt];     /// Data streams: protocols or file system
+    doWork_func doWorkers[ltem__doWorkerCnt];   /// Optional module background workers, invoked by ltem_eventMgr()
+    urcEvntHndlr_func urcHandlers[ltem__urcHandlersCnt];   /// Optional module URC handlers, offered URCs not serviced by a stream
     fileCtrl_t* fileCtrl;
 
     ltemMetrics_t metrics;                      /// metrics for operational analysis and reporting
@@ -130,9 +166,30 @@ extern "C"
 
 
 // LTEM Internal
+
+/**
+ *  \brief Restart BGx with the requested reset action and drive the start sequence to completion (blocking).
+ *  \param resetAction [in] - The reset action to perform.
+*/
+void LTEM_restart(resetAction_t resetAction);
+
+/**
+ *  \brief Register an optional module background worker, invoked from ltem_eventMgr() when no command is underway.
+ *  \param doWorker [in] - The module worker function, registering an already registered worker has no effect.
+*/
+void LTEM_registerDoWorker(doWork_func doWorker);
+
 // void LTEM_initIo();
-// void LTEM_registerDoWorker(doWork_func *doWorker);
-// void LTEM_registerUrcHandler(urcHandler_func *urcHandler);
+/**
+ *  \brief Register an optional module URC handler, offered URCs not serviced by a stream in ltem_eventMgr().
+ *  \param urcHandler [in] - The handler, returns resultCode__cancelled if the URC is not for the module.
+*/
+void LTEM_registerUrcHandler(urcEvntHndlr_func urcHandler);
+
+/**
+ *  \brief Reopen registered streams via their recover handler, streams stay registered if reopen fails (application notified).
+*/
+void LTEM_reestablishStreams();
 
 #pragma region ATCMD LTEmC Internal Functions
 /* LTEmC internal, not intended for user application consumption.
@@ -155,12 +212,56 @@ cmdParseRslt_t ATCMD_okResponseParser();
 */
 bool ATCMD_awaitLock(uint16_t timeoutMS);
 
+/**
+ *  \brief Awaits exclusive access to QBG module command interface, queued by priority class (FIFO within class).
+ *  \param timeoutMS [in] - Number of milliseconds to wait for a lock.
+ *  \param priority [in] - atcmdPriority_t class of the request.
+ *  \param holder [in] - Name of the requester, retained for contention metrics (NULL = "lock").
+ *  @return true if lock aquired prior to the timeout period.
+*/
+bool ATCMD_awaitLockPriority(uint32_t timeoutMS, uint8_t priority, const char *holder);
+
+/**
+ *  \brief Yield point for multi-step lock holders, call between steps where the BGx state allows other commands.
+ *  \details If the hold budget is exhausted and a caller of higher priority is waiting, the lock is released and re-requested
+ *  ahead of same priority waiters (sequence state is not disturbed by a peer). Otherwise returns immediately with the lock held.
+ *  \param timeoutMS [in] - Number of milliseconds to wait to re-acquire the lock.
+ *  @return true if lock is held on return, false if lock could not be re-acquired (sequence must be abandoned, no atcmd_close()).
+*/
+bool ATCMD_yieldLock(uint32_t timeoutMS);
+
 /**
  *	\brief Returns the current atCmd lock state
  *  \return True if atcmd lock is active (command underway)
  */
 bool ATCMD_isLockActive();
 
+/**
+ *	\brief Returns true if a lock request is queued, the requester is servicing ltem_eventMgr() while it waits
+ *  \details Background work must not invoke while a request is pending, it would start ahead of the queued requester.
+ */
+bool ATCMD_isLockPending();
+
+/**
+ *	\brief Invokes a BGx AT command only if the lock is available now, for callers that must not block (start sequence, doWorkers).
+ *  \param timeoutMS [in] - Number of milliseconds allowed for the command result.
+ *  \param cmdTemplate [in] - Command string or printf style template, followed by template arguments.
+ *  \return True if the command was sent, false if the lock is busy (retry on a later pass).
+ */
+bool ATCMD_tryInvokeNoWait(uint32_t timeoutMS, const char *cmdTemplate, ...);
+
+/**
+ *	\brief Checks once (no wait) for the result of the command underway, companion to ATCMD_tryInvokeNoWait().
+ *  \return resultCode__unknown while the result is pending, otherwise the command result (lock released).
+ */
+resultCode_t ATCMD_pollResult();
+
+/**
+ *	\brief Observes (does not consume) a URC at the head of dispatch, invalidating cached command results it affects.
+ *  \param urcAt [in] - Offset of the URC prefix char ('+') in the RX buffer.
+ */
+void ATCMD_observeUrc(uint16_t urcAt);
+
 /* LTEmC INTERNAL prompt parsers 
  * ------------------------------------------------------------------------- */
 
@@ -184,21 +285,77 @@ cmdParseRslt_t ATCMD_connectPromptParser();
  * End ATCMD LTEmC Internal Functions */
 
 
+#pragma region TLS LTEmC Internal Functions
+/* LTEmC internal, not intended for user application consumption.
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ *	\brief Record a successful TLS open (QSSLOPEN, QMTOPEN, etc.) for handshake reporting.
+ *  \param dataCntxt [in] - TLS/SSL context of the connection.
+ *  \param host [in] - Remote host, session resumption applies to the same host only.
+ *  \param duration [in] - Duration of the open command in mS.
+ */
+void TLS_recordHandshake(uint8_t dataCntxt, const char *host, uint32_t duration);
+
+#pragma endregion
+/* ------------------------------------------------------------------------------------------------
+ * End TLS LTEmC Internal Functions */
+
+
+#pragma region GNSS LTEmC Internal Functions
+/* LTEmC internal, not intended for user application consumption.
+ * --------------------------------------------------------------------------------------------- */
+
+/**
+ *	\brief Approximate distance in metres between two points (microdegrees), equirectangular integer approximation.
+ *  \details Adequate for fence radii and decimation distances (error grows with separation, < 0.5% under 10km).
+ */
+uint32_t GNSS_distance(int32_t lat1, int32_t lon1, int32_t lat2, int32_t lon2);
+
+/**
+ *	\brief Cosine of latitude (microdegrees) x1000, scales a longitude span to distance.
+ */
+uint16_t GNSS_cosLatitude(int32_t latitude);
+
+#pragma endregion
+/* ------------------------------------------------------------------------------------------------
+ * End GNSS LTEmC Internal Functions */
+
+
 #pragma region NTWK LTEmC Internal Functions
 /* LTEmC internal, not intended for user application consumption.
  * --------------------------------------------------------------------------------------------- */
 
 
 /**
- *	\brief Initialize BGx Radio Access Technology (RAT) options.
+ *	\brief Build a start sequence network config command: RAT options (scan sequence, scan mode, IoT mode) then default PDP context.
+ *  \param step [in] - Network config step, 0 based.
+ *  \param cmdBffr [out] - Command for the step, empty if the setting is not configured (skip step).
+ *  \param bffrSz [in] - Size of cmdBffr.
+ *  \return False if step is past the last network config step.
+ */
+bool NTWK_getStartCmd(uint8_t step, char *cmdBffr, uint16_t bffrSz);
+
+
+/**
+ *	\brief Parse a +COPS? response into provider info (provider info is cleared first).
+ *  \return True if registered with a provider (provider name found).
+ */
+bool NTWK_parseProvider(const char *response);
+
+
+/**
+ *	\brief Parse a +CGACT? response into the provider networks (PDP contexts), sets the network count.
+ *  \return Number of networks found.
  */
-void NTWK_initRatOptions();
+uint8_t NTWK_parseNetworks(const char *response);
 
 
 /**
- *	\brief Apply the default PDP context config to BGx.
+ *	\brief Parse a +CGPADDR response into the IP address of a provider network.
+ *  \param ntwkIndx [in] - Index of the network in provider info.
  */
-void NTWK_applyDefaulNetwork();
+void NTWK_parseNetworkAddress(uint8_t ntwkIndx, const char *response);
 
 
 #pragma endregion
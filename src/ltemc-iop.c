@@ -91,6 +91,10 @@ extern ltemDevice_t g_lqLTEM;
 /* ------------------------------------------------------------------------------------------------ */
 
 static void S_interruptCallbackISR();
+static void S_releaseRxLease(iop_rxLease_t *lease);
+static inline void S_trackRxPush(const char *pushAddr, uint16_t pushSz);
+static void S_enterRxCritical();
+static void S_exitRxCritical();
 static inline uint8_t S_convertCharToContextId(const char cntxtChar);
 
 #pragma endregion // Header
@@ -98,6 +102,50 @@ static inline uint8_t S_convertCharToContextId(const char cntxtChar);
 
 #pragma region Public Functions
 /*-----------------------------------------------------------------------------------------------*/
+
+/**
+ *	@brief Lease (hold) a received block beyond the receive callback, zero-copy.
+ */
+bool iop_leaseRxBlock(const char *data, uint16_t dataSz, iop_rxLease_t *lease)
+{
+    ASSERT(data != NULL && lease != NULL);
+
+    for (size_t i = 0; i < IOP__rxLeaseCnt; i++)
+    {
+        iopRxLeaseSlot_t *slot = &g_lqLTEM.iop->rxLeases[i];
+        if (!slot->active)
+        {
+            S_enterRxCritical();                                    // ISR checks slots on each RX push
+            slot->data = data;
+            slot->dataSz = dataSz;
+            slot->overrun = false;
+            slot->active = true;
+            g_lqLTEM.iop->rxLeasedSz += dataSz;
+            S_exitRxCritical();
+
+            lease->data = data;
+            lease->dataSz = dataSz;
+            lease->release = S_releaseRxLease;
+            lease->slot = i;
+            return true;
+        }
+    }
+    return false;                                                   // no lease slot, caller copies
+}
+
+
+/**
+ *	@brief Check that a leased region has not been overwritten.
+ */
+bool iop_isRxLeaseIntact(const iop_rxLease_t *lease)
+{
+    if (lease->data == NULL)
+        return false;
+
+    iopRxLeaseSlot_t *slot = &g_lqLTEM.iop->rxLeases[lease->slot];
+    return slot->active && slot->data == lease->data && !slot->overrun;
+}
+
 #pragma endregion // Public Functions
 
 
@@ -135,6 +183,7 @@ void IOP_create()
     // TX handled with CALLOC of struct
     cbffr_init(rxBffrCtrl, rxBffr, ltem__bufferSz_rx);              // initialize as a circ-buffer
     g_lqLTEM.iop->rxBffr = rxBffrCtrl;                              // add into IOP struct
+    g_lqLTEM.iop->rxBffrStart = rxBffr;
 }
 
 
@@ -245,6 +294,36 @@ uint32_t IOP_getRxIdleDuration()
 void IOP_resetRxBuffer()
 {
     cbffr_reset(g_lqLTEM.iop->rxBffr);
+    g_lqLTEM.iop->rxHead = NULL;                                    // set by next RX push
+
+    for (size_t i = 0; i < IOP__rxLeaseCnt; i++)                   // outstanding leases no longer valid
+    {
+        if (g_lqLTEM.iop->rxLeases[i].active)
+            g_lqLTEM.iop->rxLeases[i].overrun = true;
+    }
+}
+
+
+/**
+ *	@brief Get RX buffer space writable before RX reaches a leased region.
+ */
+uint16_t IOP_getRxVacant()
+{
+    uint16_t vacant = cbffr_getVacant(g_lqLTEM.iop->rxBffr);
+    const char *head = g_lqLTEM.iop->rxHead;
+    if (g_lqLTEM.iop->rxLeasedSz == 0 || head == NULL)              // no leases held, or none valid since RX reset
+        return vacant;
+
+    for (size_t i = 0; i < IOP__rxLeaseCnt; i++)
+    {
+        iopRxLeaseSlot_t *slot = &g_lqLTEM.iop->rxLeases[i];
+        if (slot->active && !slot->overrun)
+        {
+            uint16_t ahead = (slot->data - head + ltem__bufferSz_rx) % ltem__bufferSz_rx;  // ring distance from head to lease
+            vacant = MIN(vacant, ahead);
+        }
+    }
+    return vacant;
 }
 
 
@@ -254,6 +333,75 @@ void IOP_resetRxBuffer()
 #pragma region Static Function Definions
 /*-----------------------------------------------------------------------------------------------*/
 
+/**
+ *	@brief Return a leased region to the RX buffer (lease release function).
+ */
+static void S_releaseRxLease(iop_rxLease_t *lease)
+{
+    if (lease->data == NULL)                                        // already released
+        return;
+
+    iopRxLeaseSlot_t *slot = &g_lqLTEM.iop->rxLeases[lease->slot];
+    if (slot->active && slot->data == lease->data)
+    {
+        S_enterRxCritical();
+        slot->active = false;
+        g_lqLTEM.iop->rxLeasedSz -= slot->dataSz;
+        S_exitRxCritical();
+    }
+    lease->data = NULL;
+    lease->dataSz = 0;
+}
+
+
+/**
+ *	@brief ISR: advance RX head and flag leases overlapped by an RX push (region reclaimed by RX buffer before release).
+ */
+static inline void S_trackRxPush(const char *pushAddr, uint16_t pushSz)
+{
+    if (pushSz == 0)
+        return;
+
+    const char *pushEnd = pushAddr + pushSz;
+    g_lqLTEM.iop->rxHead = (pushEnd == g_lqLTEM.iop->rxBffrStart + ltem__bufferSz_rx) ? g_lqLTEM.iop->rxBffrStart : pushEnd;
+
+    if (g_lqLTEM.iop->rxLeasedSz == 0)
+        return;
+
+    for (size_t i = 0; i < IOP__rxLeaseCnt; i++)
+    {
+        iopRxLeaseSlot_t *slot = &g_lqLTEM.iop->rxLeases[i];
+        if (slot->active && !slot->overrun &&
+            pushAddr < slot->data + slot->dataSz && slot->data < pushAddr + pushSz)
+        {
+            slot->overrun = true;
+            g_lqLTEM.iop->rxLeaseOverruns++;
+        }
+    }
+}
+
+
+/**
+ *	@brief Hold off the RX ISR while lease slots are updated.
+ *  @details The platform has no interrupt mask, the ISR is detached. An IRQ asserted meanwhile is serviced on exit.
+ */
+static void S_enterRxCritical()
+{
+    platform_detachIsr(g_lqLTEM.pinConfig.irqPin);
+}
+
+
+/**
+ *	@brief Resume the RX ISR, servicing a bridge IRQ that asserted (falling edge missed) while detached.
+ */
+static void S_exitRxCritical()
+{
+    platform_attachIsr(g_lqLTEM.pinConfig.irqPin, true, gpioIrqTriggerOn_falling, S_interruptCallbackISR);
+    if (platform_readPin(g_lqLTEM.pinConfig.irqPin) == gpioValue_low)
+        S_interruptCallbackISR();
+}
+
+
 /**
  *	@brief Rapid fixed case conversion of context value returned from BGx to number.
  *  @param cntxChar [in] RX data buffer to sync.
@@ -337,6 +485,7 @@ static void S_interruptCallbackISR()
                 rxLevel = SC16IS7xx_readReg(SC16IS7xx_RXLVL_regAddr);
 
                 uint16_t bWrCnt = cbffr_pushBlock(g_lqLTEM.iop->rxBffr, &bAddr, rxLevel);   // get contiguous block to write from UART
+                S_trackRxPush(bAddr, bWrCnt);
                 PRINTF(dbgColor__dYellow, "-rx(%p:%d) -Bo=%d ", bAddr, bWrCnt, cbffr_getOccupied(g_lqLTEM.iop->rxBffr));
                 SC16IS7xx_read(bAddr, bWrCnt);
                 cbffr_pushBlockFinalize(g_lqLTEM.iop->rxBffr, true);
@@ -345,6 +494,7 @@ static void S_interruptCallbackISR()
                 {
                     rxLevel = SC16IS7xx_readReg(SC16IS7xx_RXLVL_regAddr);                   // get new rx number, push new receipts
                     bWrCnt = cbffr_pushBlock(g_lqLTEM.iop->rxBffr, &bAddr, rxLevel);
+                    S_trackRxPush(bAddr, bWrCnt);
                     PRINTF(dbgColor__dYellow, "-Wrx(%p:%d) -Bo=%d ", bAddr, bWrCnt, cbffr_getOccupied(g_lqLTEM.iop->rxBffr));
                     SC16IS7xx_read(bAddr, bWrCnt);
                     cbffr_pushBlockFinalize(g_lqLTEM.iop->rxBffr, true);
@@ -41,6 +41,28 @@ extern "C"
 #endif // __cplusplus
 
 
+/**
+ *	@brief Lease (hold) a received block beyond the receive callback, zero-copy.
+ *  @details Call from within a stream receive callback (socket, HTTP, file, MQTT message body) with the block passed to the
+ *  callback. The region is not counted as RX vacancy until released, solicited reads (socket IRD, background file reads) 
+ *  are sized and deferred accordingly. Unsolicited receives (HTTP page, MQTT) can still overrun a lease if the RX buffer 
+ *  fills; check with iop_isRxLeaseIntact() before use when the lease spans further receives.
+ *  @param data [in] Block pointer passed to the receive callback.
+ *  @param dataSz [in] Block size passed to the receive callback.
+ *  @param lease [out] Lease, call lease->release(lease) when done.
+ *  @return True if leased, false if all lease slots are in use (copy the block instead).
+ */
+bool iop_leaseRxBlock(const char *data, uint16_t dataSz, iop_rxLease_t *lease);
+
+
+/**
+ *	@brief Check that a leased region has not been overwritten.
+ *  @param lease [in] Lease to check.
+ *  @return True if the lease is held and the data is intact.
+ */
+bool iop_isRxLeaseIntact(const iop_rxLease_t *lease);
+
+
 /**
  *	@brief Initialize the Input/Output Process subsystem.
  */
@@ -116,7 +138,14 @@ uint32_t IOP_getRxIdleDuration();
 /**
  *	@brief Clear receive COMMAND/CORE response buffer.
  */
-void IOP_resetCoreRxBuffer();
+void IOP_resetRxBuffer();
+
+
+/**
+ *	@brief Get RX buffer space writable before RX reaches a leased region, use to size solicited reads.
+ *  @details Free space is counted from the RX head forward (ring order) to the nearest held lease, at most the buffer vacancy.
+ */
+uint16_t IOP_getRxVacant();
 
 
 // /**
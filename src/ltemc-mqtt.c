@@ -42,9 +42,14 @@
 #define SRCFILE "MQT"                           // create SRCFILE (3 char) MACRO for lq-diagnostics ASSERT
 #include "ltemc-internal.h"
 #include "ltemc-mqtt.h"
+#if LTEMC_ENABLE_GNSS_SHARE
+#include "ltemc-gnss-share.h"
+#endif
 
 extern ltemDevice_t g_lqLTEM;
 
+#if LTEMC_ENABLE_MQTT                           // module selection, see ltemc-config.h
+
 
 #define MAX(x, y) (((x) > (y)) ? (x) : (y))
 #define MIN(x, y) (((x) < (y)) ? (x) : (y))
@@ -68,6 +73,8 @@ enum
 static uint8_t S__findtopicIndx(mqttCtrl_t* mqttCntl, mqttTopicCtrl_t* topicCtrl);
 static resultCode_t S__notifyServerTopicChange(mqttCtrl_t* mqttCtrl, mqttTopicCtrl_t* topicCtrl, bool subscribe);
 static void S__mqttUrcHandler();
+static void S__discardRecvBody(cBuffer_t *rxBffr);
+static resultCode_t S__mqttRecoverHndlr(void *streamCtrl);
 
 //static cmdParseRslt_t S__mqttOpenStatusParser();
 static cmdParseRslt_t S__mqttOpenCompleteParser();
@@ -77,6 +84,25 @@ static cmdParseRslt_t S__mqttSubscribeCompleteParser();
 static cmdParseRslt_t S__mqttPublishCompleteParser();
 
 
+/* URC header schemas
+ */
+typedef struct qmtUrcFields_tag
+{
+    uint8_t dataCntxt;
+    uint16_t value;                                                     // msgId (+QMTRECV) or err_code (+QMTSTAT)
+} qmtUrcFields_t;
+
+// +QMTRECV: <tcpconnectID>,<msgID>,"<topic>","<payload>"
+// +QMTSTAT: <tcpconnectID>,<err_code>
+static const atcmdField_t qmtUrcFields[] =
+{
+    ATCMD_FIELD(atcmdField_int, qmtUrcFields_t, dataCntxt),
+    ATCMD_FIELD(atcmdField_int, qmtUrcFields_t, value)
+};
+static const atcmdSchema_t qmtrecvSchema = ATCMD_SCHEMA("+QMTRECV: ", qmtUrcFields, 2);
+static const atcmdSchema_t qmtstatSchema = ATCMD_SCHEMA("+QMTSTAT: ", qmtUrcFields, 2);
+
+
 /* public mqtt functions
  * --------------------------------------------------------------------------------------------- */
 #pragma region public functions
@@ -95,6 +121,7 @@ void mqtt_initControl(mqttCtrl_t *mqttCtrl, dataCntxt_t dataCntxt)
     mqttCtrl->streamType = streamType_MQTT;
     mqttCtrl->urcEvntHndlr = S__mqttUrcHandler;                 // for MQTT, URC handler performs all necessary functions
     mqttCtrl->dataRxHndlr = NULL;                               // marshalls data from buffer to app done by URC handler
+    mqttCtrl->recoverHndlr = S__mqttRecoverHndlr;               // reopen/connect/subscribe following BGx restart
 }
 
 
@@ -133,6 +160,7 @@ void mqtt_setConnection(mqttCtrl_t *mqttCtrl, const char *hostUrl, uint16_t host
     strcpy(mqttCtrl->hostUrl, hostUrl);
     mqttCtrl->hostPort = hostPort;
     mqttCtrl->useTls = useTls;
+    mqttCtrl->cfgStartedAt = 0;                                 // connection settings changed, reapply at next open
     mqttCtrl->mqttVersion = mqttVersion;
 
     strncpy(mqttCtrl->clientId, clientId, mqtt__clientIdSz);
@@ -141,6 +169,15 @@ void mqtt_setConnection(mqttCtrl_t *mqttCtrl, const char *hostUrl, uint16_t host
 }
 
 
+/**
+ *  @brief Set the TLS profile for the connection, applied at each open and reconnect.
+*/
+void mqtt_setTlsProfile(mqttCtrl_t *mqttCtrl, const tlsProfile_t *tlsProfile)
+{
+    mqttCtrl->tlsProfile = tlsProfile;
+}
+
+
 /**
  *  @brief Open a remote MQTT server IP connection for use.
  *  @details Preferred way for user app to connect to server is via mqtt_start() or mqtt_reset()
@@ -159,29 +196,42 @@ resultCode_t mqtt_open(mqttCtrl_t *mqttCtrl)
     // if (mqttCtrl->state != mqttState_closed)                    // not in a closed state, (most) mqtt setting changes require closed connection
     //     return resultCode__preConditionFailed;
 
-    // set options prior to open
-    if (mqttCtrl->useTls)
+    if (mqttCtrl->useTls && mqttCtrl->tlsProfile != NULL)
+    {
+        if (tls_applyProfile(mqttCtrl->dataCntxt, mqttCtrl->tlsProfile) != resultCode__success)     // no AT traffic if context unchanged
+            return resultCode__internalError;
+    }
+
+    // set options prior to open, BGx retains these until restarted so reconnects skip them
+    if (mqttCtrl->cfgStartedAt == 0 || mqttCtrl->cfgStartedAt != g_lqLTEM.startCtrl.startedAt)
     {
-        if (atcmd_tryInvoke("AT+QMTCFG=\"ssl\",%d,1,%d", mqttCtrl->dataCntxt, mqttCtrl->dataCntxt))
+        if (mqttCtrl->useTls)
+        {
+            if (atcmd_tryInvoke("AT+QMTCFG=\"ssl\",%d,1,%d", mqttCtrl->dataCntxt, mqttCtrl->dataCntxt))
+            {
+                if (atcmd_awaitResult() != resultCode__success)
+                    return resultCode__internalError;
+            }
+        }
+        // AT+QMTCFG="version",0,4
+        if (atcmd_tryInvoke("AT+QMTCFG=\"version\",%d,4", mqttCtrl->dataCntxt, mqttCtrl->mqttVersion))
         {
             if (atcmd_awaitResult() != resultCode__success)
                 return resultCode__internalError;
         }
-    }
-    // AT+QMTCFG="version",0,4
-    if (atcmd_tryInvoke("AT+QMTCFG=\"version\",%d,4", mqttCtrl->dataCntxt, mqttCtrl->mqttVersion))
-    {
-        if (atcmd_awaitResult() != resultCode__success)
-            return resultCode__internalError;
+        mqttCtrl->cfgStartedAt = g_lqLTEM.startCtrl.startedAt;
     }
 
     // TYPICAL: AT+QMTOPEN=0,"iothub-dev-pelogical.azure-devices.net",8883
+    uint32_t openStart = pMillis();
     if (atcmd_tryInvoke("AT+QMTOPEN=%d,\"%s\",%d", mqttCtrl->dataCntxt, mqttCtrl->hostUrl, mqttCtrl->hostPort))
     {
         resultCode_t rslt = atcmd_awaitResultWithOptions(PERIOD_FROM_SECONDS(45), S__mqttOpenCompleteParser);
         if (rslt == resultCode__success && atcmd_getValue() == 0)
         {
             mqttCtrl->state = mqttState_open;
+            if (mqttCtrl->useTls)
+                TLS_recordHandshake(mqttCtrl->dataCntxt, mqttCtrl->hostUrl, pMillis() - openStart);
             // g_lqLTEM.atcmd->mqttMap |= 0x01 << mqttCtrl->dataCntxt;
             // g_lqLTEM.atcmd->streamPeers[mqttCtrl->dataCntxt] = mqttCtrl;
             // LTEM_registerDoWorker(S__mqttDoWork);                                // register background recv worker
@@ -375,28 +425,34 @@ resultCode_t mqtt_cancelTopic(mqttCtrl_t *mqttCtrl, mqttTopicCtrl_t* topicCtrl)
 */
 resultCode_t mqtt_publish(mqttCtrl_t *mqttCtrl, const char *topic, mqttQos_t qos, const char *message, uint16_t messageSz, uint8_t timeoutSec)
 {
-    ASSERT(messageSz <= 4096);                                                                                  // max msg length PUB=4096 (PUBEX=560)
+    ASSERT(messageSz <= QBG_getModuleCaps()->mqttMessageMaxSz);                                                 // max msg length PUB=4096 (PUBEX=560)
     
     resultCode_t rslt = resultCode__conflict;                                                                   // assume lock not obtainable, conflict
-    uint32_t timeoutMS = (timeoutSec == 0) ? mqtt__publishTimeout : PERIOD_FROM_SECONDS(timeoutSec * 1000);
+    uint32_t timeoutMS = (timeoutSec == 0) ? mqtt__publishTimeout : PERIOD_FROM_SECONDS(timeoutSec);
+
+    #if LTEMC_ENABLE_GNSS_SHARE
+    if (gnssShare_isDataBlackout())                                                                             // radio serving a GNSS window, LTE data suspended
+        return resultCode__unavailable;
+    #endif
 
+    if (ATCMD_awaitLockPriority(timeoutMS, atcmdPriority_control, "mqtt-pub"))                                 // control-plane class, ahead of bulk transfers
+    {
         mqttCtrl->sentMsgId++;                                                                                  // keep sequence going regardless of MQTT QOS
         uint16_t msgId = ((uint8_t)qos == 0) ? 0 : mqttCtrl->sentMsgId;                                         // msgId not sent with QOS == 0, otherwise sent
         // AT+QMTPUB=<tcpconnectID>,<msgID>,<qos>,<retain>,"<topic>"
 
         atcmd_configDataMode(mqttCtrl->dataCntxt, "> ", atcmd_stdTxDataHndlr, message, messageSz, NULL, false); // send message with dataMode
 
-        if (atcmd_tryInvoke("AT+QMTPUB=%d,%d,%d,0,\"%s\",%d", mqttCtrl->dataCntxt, msgId, qos, topic, messageSz))
+        atcmd_invokeFmtReuseLock(atcmdFmt_qmtpub, mqttCtrl->dataCntxt, msgId, qos, 0, topic, messageSz);
+        rslt = atcmd_awaitResultWithOptions(timeoutMS, S__mqttPublishCompleteParser);
+        atcmd_close();
+        if (rslt == resultCode__success)                                        
         {
-            rslt = atcmd_awaitResultWithOptions(timeoutMS, S__mqttPublishCompleteParser);
-            if (rslt == resultCode__success)                                        
-            {
-                atcmd_close();
-                PRINTF(dbgColor__dYellow, "MQTT-PUB Success: rslt=%d\r", rslt);
-                return rslt;
-            }
+            PRINTF(dbgColor__dYellow, "MQTT-PUB Success: rslt=%d\r", rslt);
+            return rslt;
         }
-        return resultCode__conflict;
+    }
+    return resultCode__conflict;
 }
 
 
@@ -520,6 +576,25 @@ uint16_t mqtt_getErrCode(mqttCtrl_t *mqttCtrl)
 #pragma region private functions
 
 
+/**
+ *  @brief Reopen MQTT session following BGx restart (health monitor recovery), BGx has no MQTT state following restart.
+ */
+static resultCode_t S__mqttRecoverHndlr(void *streamCtrl)
+{
+    mqttCtrl_t *mqttCtrl = (mqttCtrl_t*)streamCtrl;
+
+    if (mqttCtrl->state != mqttState_connected)                                 // not in session with server (never started or app closed), nothing to reopen
+    {
+        mqttCtrl->state = mqttState_closed;                                     // BGx restart discarded any open (unconnected) MQTT context
+        if (ltem_getStreamFromCntxt(mqttCtrl->dataCntxt, streamType__ANY) == NULL)
+            ltem_addStream(mqttCtrl);                                           // recovery cleared the streams table slot, keep registered
+        return resultCode__success;
+    }
+    mqttCtrl->state = mqttState_closed;
+    return mqtt_start(mqttCtrl, true);
+}
+
+
 static uint8_t S__findtopicIndx(mqttCtrl_t* mqttCntl, mqttTopicCtrl_t* topicCtrl)
 {
     uint8_t emptySlot = UINT8_MAX;
@@ -551,20 +626,22 @@ static resultCode_t S__notifyServerTopicChange(mqttCtrl_t* mqttCtrl, mqttTopicCt
         strcat(topicName, "/#");
     }
 
+    if (!ATCMD_awaitLockPriority(atcmd__defaultTimeout, atcmdPriority_control, "mqtt-sub"))                    // control-plane class, ahead of bulk transfers
+        return resultCode__conflict;
+
+    resultCode_t rslt;
     if (subscribe)
     {
-        if (atcmd_tryInvoke("AT+QMTSUB=%d,%d,\"%s\",%d", mqttCtrl->dataCntxt, ++mqttCtrl->sentMsgId, topicName, topicCtrl->Qos))
-        {
-            return atcmd_awaitResultWithOptions(PERIOD_FROM_SECONDS(30), S__mqttSubscribeCompleteParser);
-        }
+        atcmd_invokeReuseLock("AT+QMTSUB=%d,%d,\"%s\",%d", mqttCtrl->dataCntxt, ++mqttCtrl->sentMsgId, topicName, topicCtrl->Qos);
+        rslt = atcmd_awaitResultWithOptions(PERIOD_FROM_SECONDS(30), S__mqttSubscribeCompleteParser);
     }
     else
     {
-        if (atcmd_tryInvoke("AT+QMTUNS=%d,%d,\"%s\"", mqttCtrl->dataCntxt, ++mqttCtrl->sentMsgId, topicName))
-        {
-            return atcmd_awaitResult();
-        }
+        atcmd_invokeReuseLock("AT+QMTUNS=%d,%d,\"%s\"", mqttCtrl->dataCntxt, ++mqttCtrl->sentMsgId, topicName);
+        rslt = atcmd_awaitResult();
     }
+    atcmd_close();
+    return rslt;
 }
 
 
@@ -602,10 +679,14 @@ static void S__mqttUrcHandler()
         ASSERT(findIndx < sizeof(workBffr));
         cbffr_pop(rxBffr, workBffr, findIndx + 3);                                          // rxBffr->tail now points to message, operate on header in workBffr
 
-        workPtr += sizeof("+QMTRECV: ") - 1;
-        dataCntxt = strtol(workPtr, &workPtr, 10);
-        workPtr++;
-        uint16_t msgId = strtol(workPtr, &workPtr, 10);
+        qmtUrcFields_t urcFields = {0};
+        if (!atcmd_parseFields(workBffr, &qmtrecvSchema, &urcFields, NULL))
+        {
+            S__discardRecvBody(rxBffr);                                                     // header consumed, body must not be left to parse as a URC
+            return;
+        }
+        dataCntxt = urcFields.dataCntxt;
+        uint16_t msgId = urcFields.value;
 
         // find topic in ctrl, to get callback func
         streamType_t* ctrlPtr = ltem_getStreamFromCntxt(dataCntxt, streamType_MQTT);
@@ -614,7 +695,7 @@ static void S__mqttUrcHandler()
 
         mqttTopicCtrl_t* topicCtrl;
         uint16_t topicLen;
-        workPtr += 2;
+        workPtr = strchr(workBffr, '"') + 1;                                                // topic follows opening quote, header ends with "," found above
         bool topicFound = false;
         for (size_t i = 0; i < mqtt__topicsCnt; i++)
         {
@@ -676,20 +757,40 @@ static void S__mqttUrcHandler()
         if (CBFFR_FOUND(eopUrl))
         {
             cbffr_pop(rxBffr, workBffr, eopUrl);
-            workPtr = lq_strnstr(workBffr, "+QMSTAT", sizeof(workBffr)) + 9;
 
-            uint8_t cntxt = strtol(workPtr, &workPtr, 10);
-            workPtr++;
+            qmtUrcFields_t urcFields = {0};
+            if (!atcmd_parseFields(workBffr, &qmtstatSchema, &urcFields, NULL))
+                return;
 
-            streamCtrl_t* streamCtrl = ltem_getStreamFromCntxt(cntxt, streamType_MQTT);
+            streamCtrl_t* streamCtrl = ltem_getStreamFromCntxt(urcFields.dataCntxt, streamType_MQTT);
             ASSERT(streamCtrl != NULL);
-            ((mqttCtrl_t*)streamCtrl)->errCode = strtol(workPtr, NULL, 10);
+            ((mqttCtrl_t*)streamCtrl)->errCode = urcFields.value;
             ((mqttCtrl_t*)streamCtrl)->state = mqttState_closed;
         }
     }
 }
 
 
+/**
+ *	@brief Discard a +QMTRECV message body (header already popped) through its closing quote and CRLF.
+ */
+static void S__discardRecvBody(cBuffer_t *rxBffr)
+{
+    uint32_t waitStart = pMillis();
+    while (!pElapsed(waitStart, atcmd__defaultTimeout))                                     // body may still be arriving
+    {
+        int16_t eomIndx = cbffr_find(rxBffr, "\"\r\n", 0, 0, false);
+        if (CBFFR_FOUND(eomIndx))
+        {
+            cbffr_skipTail(rxBffr, eomIndx + 3);
+            return;
+        }
+        pYield();
+    }
+    PRINTF(dbgColor__warn, "mqttUrcHndlr() QMTRECV body end not found\r");
+}
+
+
 #pragma endregion
 
 /* MQTT ATCMD Parsers
@@ -762,3 +863,5 @@ static cmdParseRslt_t S__mqttCloseCompleteParser()
 
 
 #pragma endregion
+
+#endif  // LTEMC_ENABLE_MQTT
@@ -28,6 +28,7 @@
 #define __MQTT_H__
 
 #include "ltemc-types.h"
+#include "ltemc-tls.h"
 
 /** 
  *  @brief typed numeric constants used by MQTT subsystem.
@@ -39,10 +40,10 @@ enum mqtt__constants
     mqtt__publishTimeout = 15000,
 
     mqtt__messageSz = 1548,                                             /// Maximum message size for BGx family (BG96, BG95, BG77)
-    mqtt__topicsCnt = 4,
+    mqtt__topicsCnt = LTEMC_MQTT_TOPICS_CNT,
     mqtt__topic_offset = 24,
-    mqtt__topic_nameSz = 90,                                            /// Azure IoTHub typically 50-70 chars
-    mqtt__topic_propsSz = 320,                                          /// typically 250-300 bytes
+    mqtt__topic_nameSz = LTEMC_MQTT_TOPIC_NAME_SZ,                      /// Azure IoTHub typically 50-70 chars
+    mqtt__topic_propsSz = LTEMC_MQTT_TOPIC_PROPS_SZ,                    /// typically 250-300 bytes
     mqtt__topicSz = (mqtt__topic_nameSz + mqtt__topic_propsSz),         /// Total topic size (name+props) for buffer sizing
     mqtt__topic_publishCmdOvrhdSz = 27,                                 /// when publishing, number of extra chars in outgoing buffer added to AT cmd
 
@@ -52,9 +53,9 @@ enum mqtt__constants
     */
     mqtt__propertiesCnt = 12,
 
-    mqtt__clientIdSz = 20,
-    mqtt__userNameSz = 100,
-    mqtt__userPasswordSz = 200
+    mqtt__clientIdSz = LTEMC_MQTT_CLIENTID_SZ,
+    mqtt__userNameSz = LTEMC_MQTT_USERNAME_SZ,
+    mqtt__userPasswordSz = LTEMC_MQTT_PASSWORD_SZ
 };
 
 
@@ -172,6 +173,7 @@ typedef struct mqttCtrl_tag
     dataCntxt_t dataCntxt;                      /// integer representing the source of the stream; fixed for protocols, file handle for FS
     dataRxHndlr_func dataRxHndlr;               /// function to handle data streaming, initiated by eventMgr() or atcmd module
     urcEvntHndlr_func urcEvntHndlr;             /// function to determine if "potential" URC event is for an open stream and perform reqd actions
+    recoverHndlr_func recoverHndlr;             /// function to reopen stream following BGx restart, NULL if stream is not reopened
 
     /* Above section of <stream>Ctrl structure is the same for all LTEmC implemented streams/protocols TCP/HTTP/MQTT etc. 
     */
@@ -187,6 +189,8 @@ typedef struct mqttCtrl_tag
     uint16_t sentMsgId;                             /// MQTT TX message ID for QOS, automatically incremented, rolls at max value.
     uint16_t recvMsgId;                             /// last received message identifier
     uint8_t errCode;
+    const tlsProfile_t *tlsProfile;             /// optional TLS profile applied at each open (reconnect), application owned
+    uint32_t cfgStartedAt;                      /// BGx start (startCtrl.startedAt) the QMTCFG ssl/version settings were applied in, 0=not applied
 } mqttCtrl_t;
 
 
@@ -242,6 +246,14 @@ void mqtt_initTopicControl(mqttTopicCtrl_t* topicCtrl, const char* topic, uint8_
 */
 void mqtt_setConnection(mqttCtrl_t *mqttCtrl, const char *hostUrl, uint16_t hostPort, bool useTls, mqttVersion_t useMqttVersion, const char *deviceId, const char *userId, const char *secret);
 
+/**
+ *  @brief Set the TLS profile for the connection, applied (only changes) to the MQTT data context at each open and reconnect.
+ *  @details Enable tlsProfile_t sessionCache for reconnects to resume the TLS session, see tls_getHandshakeInfo() for results.
+ *  @param mqttCtrl [in] Pointer to MQTT control structure
+ *  @param tlsProfile [in] TLS profile, must remain valid while the connection is in use; NULL to leave context settings unmanaged
+ */
+void mqtt_setTlsProfile(mqttCtrl_t *mqttCtrl, const tlsProfile_t *tlsProfile);
+
 
 
 /**
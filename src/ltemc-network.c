@@ -53,8 +53,50 @@ extern ltemDevice_t g_lqLTEM;
 
 // local static functions
 static cmdParseRslt_t S__contextStatusCompleteParser(void * atcmd, const char *response);
-static char *S__grabToken(char *source, int delimiter, char *tokenBuf, uint8_t tokenBufSz);
 static void S__clearProviderInfo();
+static void S__providersLineRecv(void *lineCntxt, const char *line, uint16_t lineSz, bool isComplete);
+
+typedef struct providersCntxt_tag
+{
+    char *list;                                                         // next write position
+    uint16_t remaining;                                                 // space remaining, excluding '\0'
+} providersCntxt_t;
+
+
+/* response schemas
+ * --------------------------------------------------------------------------------------------- */
+
+typedef struct copsFields_tag
+{
+    char name[ntwk__providerNameSz];
+    uint8_t accessTech;                                                 // 8 = LTE-M1, 9 = NB-IoT
+} copsFields_t;
+
+// +COPS: <mode>,<format>,"<oper>",<AcT>
+static const atcmdField_t copsFields[] =
+{
+    ATCMD_FIELD_SKIP,
+    ATCMD_FIELD_SKIP,
+    ATCMD_FIELD(atcmdField_qstr, copsFields_t, name),
+    ATCMD_FIELD(atcmdField_int, copsFields_t, accessTech)
+};
+static const atcmdSchema_t copsSchema = ATCMD_SCHEMA("+COPS: ", copsFields, 3);
+
+// +CGACT: <cid>,<state>
+static const atcmdField_t cgactFields[] =
+{
+    ATCMD_FIELD(atcmdField_int, networkInfo_t, pdpContextId),
+    ATCMD_FIELD(atcmdField_int, networkInfo_t, isActive)
+};
+static const atcmdSchema_t cgactSchema = ATCMD_SCHEMA("+CGACT: ", cgactFields, 2);
+
+// +CGPADDR: <cid>,<PDP_addr>
+static const atcmdField_t cgpaddrFields[] =
+{
+    ATCMD_FIELD_SKIP,
+    ATCMD_FIELD(atcmdField_qstr, networkInfo_t, ipAddress)
+};
+static const atcmdSchema_t cgpaddrSchema = ATCMD_SCHEMA("+CGPADDR: ", cgpaddrFields, 2);
 
 
 /* public tcpip functions
@@ -86,30 +128,79 @@ void ntwk_setDefaulNetworkConfig(uint8_t pdpContextId, const char *protoType, co
 
 
 /**
- *	\brief Initialize BGx Radio Access Technology (RAT) options.
+ *	\brief Build a start sequence network config command, RAT options then default PDP context (one command per step).
  */
-void NTWK_initRatOptions()
+bool NTWK_getStartCmd(uint8_t step, char *cmdBffr, uint16_t bffrSz)
 {
-    ltem_setProviderScanSeq(g_lqLTEM.modemSettings->scanSequence);
-    ltem_setProviderScanMode(g_lqLTEM.modemSettings->scanMode);
-    ltem_setIotMode(g_lqLTEM.modemSettings->iotMode);
+    cmdBffr[0] = '\0';
+    switch (step)
+    {
+        case 0:
+            if (strlen(g_lqLTEM.modemSettings->scanSequence) > 0)
+                snprintf(cmdBffr, bffrSz, "AT+QCFG=\"nwscanseq\",%s", g_lqLTEM.modemSettings->scanSequence);
+            return true;
+        case 1:
+            snprintf(cmdBffr, bffrSz, "AT+QCFG=\"nwscanmode\",%d", g_lqLTEM.modemSettings->scanMode);
+            return true;
+        case 2:
+            snprintf(cmdBffr, bffrSz, "AT+QCFG=\"iotopmode\",%d", g_lqLTEM.modemSettings->iotMode);
+            return true;
+        case 3:
+            snprintf(cmdBffr, bffrSz, "%s", g_lqLTEM.modemSettings->defaultNtwkConfig);     // configures default PDP context for likely autostart with provider attach
+            return true;
+    }
+    return false;
 }
 
 
 /**
- *	\brief Apply the default PDP context config to BGx.
+ *	\brief Parse a +COPS? response into provider info (provider info is cleared first).
  */
-void NTWK_applyDefaulNetwork()
+bool NTWK_parseProvider(const char *response)
 {
-    resultCode_t rslt;
-    if(strlen(g_lqLTEM.modemSettings->defaultNtwkConfig) > 0 &&
-        atcmd_tryInvoke(g_lqLTEM.modemSettings->defaultNtwkConfig))
+    S__clearProviderInfo();
+
+    copsFields_t cops = {0};
+    if (atcmd_parseFields(response, &copsSchema, &cops, NULL))
     {
-        rslt = atcmd_awaitResult();
-        if (rslt != resultCode__success)
-            PRINTF(dbgColor__cyan, "DefaultNtwk Config Failed=%d\r", rslt);
+        strcpy(g_lqLTEM.providerInfo->name, cops.name);
+        if (cops.accessTech == 8)
+            strcpy(g_lqLTEM.providerInfo->iotMode, "M1");
+        else
+            strcpy(g_lqLTEM.providerInfo->iotMode, "NB1");
     }
-    atcmd_close();
+    return !STREMPTY(g_lqLTEM.providerInfo->name);
+}
+
+
+/**
+ *	\brief Parse a +CGACT? response into the provider networks, addresses are set by NTWK_parseNetworkAddress().
+ */
+uint8_t NTWK_parseNetworks(const char *response)
+{
+    uint8_t ntwkCnt = 0;
+    const char *pLine = response;                                                           // +CGACT: <cid>,<state> line per context
+    while (ntwkCnt < ntwk__pdpContextCnt &&
+           atcmd_parseFields(pLine, &cgactSchema, &g_lqLTEM.providerInfo->networks[ntwkCnt], &pLine))
+    {
+        // only supported protocol now is IPv4, alias IP
+        strcpy(g_lqLTEM.providerInfo->networks[ntwkCnt].pdpProtocolType, PDP_PROTOCOL_IPV4);
+        if (!g_lqLTEM.providerInfo->networks[ntwkCnt].isActive)
+            strcpy(g_lqLTEM.providerInfo->networks[ntwkCnt].ipAddress, "0.0.0.0");
+        ntwkCnt++;
+    }
+    g_lqLTEM.providerInfo->networkCnt = ntwkCnt;
+    return ntwkCnt;
+}
+
+
+/**
+ *	\brief Parse a +CGPADDR response into the IP address of a provider network.
+ */
+void NTWK_parseNetworkAddress(uint8_t ntwkIndx, const char *response)
+{
+    ASSERT(ntwkIndx < ntwk__pdpContextCnt);
+    atcmd_parseFields(response, &cgpaddrSchema, &g_lqLTEM.providerInfo->networks[ntwkIndx], NULL);
 }
 
 
@@ -165,22 +256,7 @@ providerInfo_t *ntwk_awaitProvider(uint16_t waitSec)
         do 
         {
             atcmd_invokeReuseLock("AT+COPS?");                              // get PROVIDER cellular carrier
-            if (atcmd_awaitResult() == resultCode__success)
-            {
-                char *pContinue;
-                pContinue = strchr(atcmd_getResponse(), '"');
-                if (pContinue != NULL)
-                {
-                    pContinue = S__grabToken(pContinue + 1, '"', g_lqLTEM.providerInfo->name, ntwk__providerNameSz);
-
-                    uint8_t ntwkMode = (uint8_t)strtol(pContinue + 1, &pContinue, 10);
-                    if (ntwkMode == 8)
-                        strcpy(g_lqLTEM.providerInfo->iotMode, "M1");
-                    else
-                        strcpy(g_lqLTEM.providerInfo->iotMode, "NB1");
-                }
-            }
-            if (!STREMPTY(g_lqLTEM.providerInfo->name))
+            if (atcmd_awaitResult() == resultCode__success && NTWK_parseProvider(atcmd_getResponse()))
                 break;
 
             pDelay(1000);                                                                   // this yields, allowing alternate execution
@@ -195,45 +271,26 @@ providerInfo_t *ntwk_awaitProvider(uint16_t waitSec)
         */
         if (!STREMPTY(g_lqLTEM.providerInfo->name))
         {
-            char *pContinue;
-            uint8_t ntwkIndx = 0;
+            uint8_t ntwkCnt = 0;
 
             atcmd_invokeReuseLock("AT+CGACT?");
             if (atcmd_awaitResultWithOptions(PERIOD_FROM_SECONDS(20), NULL) == resultCode__success)
             {
-                pContinue = strstr(atcmd_getResponse(), "+CGACT: ");
-                while (pContinue != NULL && ntwkIndx < ntwk__pdpContextCnt)
-                {
-                    g_lqLTEM.providerInfo->networks[ntwkIndx].pdpContextId = strtol(pContinue + 8, &pContinue, 10);
-                    g_lqLTEM.providerInfo->networks[ntwkIndx].isActive = *(++pContinue) == '1';
-                    // only supported protocol now is IPv4, alias IP
-                    strcpy(g_lqLTEM.providerInfo->networks[ntwkIndx].pdpProtocolType, PDP_PROTOCOL_IPV4);
-                    pContinue = strstr(pContinue, "+CGACT: ");
-                    if (pContinue == NULL)
-                        break;
-                    ntwkIndx++;
-                }
+                ntwkCnt = NTWK_parseNetworks(atcmd_getResponse());
             }
             // get IP addresses
-            for (size_t i = 0; i <= ntwkIndx; i++)
+            for (size_t i = 0; i < ntwkCnt; i++)
             {
                 if (g_lqLTEM.providerInfo->networks[i].isActive)
                 {
+                    atcmd_configCache(PERIOD_FROM_SECONDS(300), atcmdCacheInval_registration | atcmdCacheInval_pdpDeact);   // address is stable while context remains active
                     atcmd_invokeReuseLock("AT+CGPADDR=%d", g_lqLTEM.providerInfo->networks[i].pdpContextId);
                     if (atcmd_awaitResult() == resultCode__success)
                     {
-                        pContinue = strstr(atcmd_getResponse(), "+CGPADDR: ");
-                        pContinue = strchr(pContinue + 10, ',') + 1;
-                        char *pLineEnd = strchr(pContinue, '\r');
-                        strncpy(g_lqLTEM.providerInfo->networks[i].ipAddress, pContinue, MIN(pLineEnd - pContinue, ntwk__ipAddressSz));
+                        NTWK_parseNetworkAddress(i, atcmd_getResponse());
                     }
                 }
-                else
-                {
-                    strcpy(g_lqLTEM.providerInfo->networks[i].ipAddress, "0.0.0.0");
-                }
             }
-            g_lqLTEM.providerInfo->networkCnt = ++ntwkIndx;
         }
     }
     atcmd_close();
@@ -351,11 +408,12 @@ void ntwkDIAG_getProviders(char *providersList, uint16_t listSz)
     {
         if (g_lqLTEM.modemInfo->imei[0] == 0)
         {
+            memset(providersList, 0, listSz);
+            providersCntxt_t providersCntxt = { providersList, listSz - 1 };
+
+            atcmd_configLineMode(S__providersLineRecv, &providersCntxt);       // response can be several hundred chars, exceeds response buffer
             atcmd_invokeReuseLock("AT+COPS=?");
-            if (atcmd_awaitResultWithOptions(PERIOD_FROM_SECONDS(180), NULL) == resultCode__success)
-            {
-                strncpy(providersList, atcmd_getResponse() + 9, listSz - 1);
-            }
+            atcmd_awaitResultWithOptions(PERIOD_FROM_SECONDS(180), NULL);
         }
     }
     atcmd_close();
@@ -370,6 +428,26 @@ void ntwkDIAG_getProviders(char *providersList, uint16_t listSz)
 #pragma region private functions
 
 
+/**
+ *   \brief Line mode receiver for AT+COPS=?, appends the provider list (delivered in segments) to the caller's buffer.
+*/
+static void S__providersLineRecv(void *lineCntxt, const char *line, uint16_t lineSz, bool isComplete)
+{
+    // +COPS: (<stat>,"<long oper>","<short oper>","<numeric oper>",<AcT>),...,,(<mode list>),(<format list>)
+    providersCntxt_t *providers = (providersCntxt_t*)lineCntxt;
+
+    if (lineSz >= 7 && memcmp(line, "+COPS: ", 7) == 0)
+    {
+        line += 7;
+        lineSz -= 7;
+    }
+    uint16_t copySz = MIN(lineSz, providers->remaining);
+    memcpy(providers->list, line, copySz);
+    providers->list += copySz;
+    providers->remaining -= copySz;
+}
+
+
 static void S__clearProviderInfo()
 {
     memset((void*)g_lqLTEM.providerInfo->networks, 0, g_lqLTEM.providerInfo->networkCnt * sizeof(networkInfo_t));
@@ -396,30 +474,4 @@ static providerInfo_t *S__getNetworkProvider()
 }
 
 
-/**
- *  \brief Scans a C-String (char array) for the next delimeted token and null terminates it.
- * 
- *  \param [in] source - Original char array to scan.
- *  \param [in] delimeter - Character separating tokens (passed as integer value).
- *  \param [out] tokenBuf - Pointer to where token should be copied to.
- *  \param [in] tokenBufSz - Size of buffer to receive token.
- * 
- *  \return Pointer to the location in the source string immediately following the token.
-*/
-static char *S__grabToken(char *source, int delimiter, char *tokenBuf, uint8_t tokenBufSz) 
-{
-    char *delimAt;
-    if (source == NULL)
-        return false;
-
-    delimAt = strchr(source, delimiter);
-    uint8_t tokenSz = delimAt - source;
-    if (tokenSz == 0)
-        return NULL;
-
-    memset(tokenBuf, 0, tokenBufSz);
-    memcpy(tokenBuf, source, MIN(tokenSz, tokenBufSz-1));
-    return delimAt + 1;
-}
-
 #pragma endregion
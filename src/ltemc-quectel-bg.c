@@ -51,12 +51,34 @@ extern ltemDevice_t g_lqLTEM;
 extern const char* const qbg_initCmds[];
 extern int8_t qbg_initCmdsCnt;
 
+#define MIN(x, y) (((x) < (y)) ? (x) : (y))
 #define MAX(X, Y) (((X) > (Y)) ? (X) : (Y))
 
 
+/* BGx module timing and capabilities, by module type
+ * ---------------------------------------------------------------------------------------------
+ * Entry 0 is the conservative default, used until the module type is identified (or if unknown). GPIO is allowed on the
+ * default entry (BG95/BG77 pin range), the module rejects the command if it has no GPIO.
+ * Timings from Quectel hardware design guides: BG96 reset pin active 150-460ms, BG95/BG77 2-3.8s.
+ * ------------------------------------------------------------------------------------------------ */
+static const moduleCaps_t qbg_moduleCaps[] = 
+{
+    //  type    pwrOn                pwrOff                reset                  mqttPub  sckt   gpio  adc  features
+    { "",       BGX__powerOnDelay,   BGX__powerOffDelay,   BGX__resetPulseDelay,  4096,    1460,  9,    2,   moduleFeature_gnss | moduleFeature_gpio },
+    { "BG96",   500,                 1500,                 300,                   4096,    1460,  0,    2,   moduleFeature_gnss | moduleFeature_gsm | moduleFeature_nbIot | moduleFeature_gnssConcurrent },
+    { "BG95",   500,                 1500,                 2500,                  4096,    1460,  9,    2,   moduleFeature_gnss | moduleFeature_gsm | moduleFeature_nbIot | moduleFeature_geofence | moduleFeature_gpio | moduleFeature_mqttPubEx | moduleFeature_tlsSessionCache },
+    { "BG77",   500,                 1500,                 2500,                  4096,    1460,  9,    2,   moduleFeature_gnss | moduleFeature_nbIot | moduleFeature_geofence | moduleFeature_gpio | moduleFeature_mqttPubEx | moduleFeature_tlsSessionCache }
+};
+
+static const uint8_t qbg_moduleCapsCnt = sizeof(qbg_moduleCaps) / sizeof(moduleCaps_t);
+
+
 /* Private static functions
  --------------------------------------------------------------------------------------------- */
-bool S__statusFix();
+static bool S__awaitPowerState(bool powerOn, uint32_t timeoutMs);
+static bool S__readStatusPin();
+static void S__checkLatchedOff();
+static void S__statusPinISR();
 
 
 #pragma region public functions
@@ -68,29 +90,81 @@ bool S__statusFix();
  */
 bool QBG_isPowerOn()
 {
-    gpioPinValue_t statusPin = platform_readPin(g_lqLTEM.pinConfig.statusPin);
-
-    #ifdef STATUS_LOW_PULLDOWN
-    if (statusPin)                     // if pin high, assume latched
+    bool statusPin;
+    if (g_lqLTEM.statusMon.isAttached)
     {
-        platform_closePin(g_lqLTEM.pinConfig.statusPin);
-        platform_openPin(g_lqLTEM.pinConfig.statusPin, gpioMode_output);    // open status for write, set low
-        platform_writePin(g_lqLTEM.pinConfig.statusPin, gpioValue_low);     // set low
-        //pDelay(1);
-        platform_closePin(g_lqLTEM.pinConfig.statusPin);
-        platform_openPin(g_lqLTEM.pinConfig.statusPin, gpioMode_input);     // reopen for normal usage (read)
-
-        statusPin = platform_readPin(g_lqLTEM.pinConfig.statusPin);                     // perform 2nd read, after pull-down sequence
+        #ifdef STATUS_LOW_PULLDOWN
+        if (g_lqLTEM.statusMon.isPowerOn && pMillis() - g_lqLTEM.statusMon.latchCheckAt >= BGX__powerPollInterval)
+            S__checkLatchedOff();                                           // latched status pin goes OFF without an edge
+        #endif
+        statusPin = g_lqLTEM.statusMon.isPowerOn;                           // ISR maintained at each status pin edge, no GPIO access
     }
-    #else
-    statusPin = platform_readPin(g_lqLTEM.pinConfig.statusPin);
-    #endif
+    else
+        statusPin = S__readStatusPin();
 
     g_lqLTEM.deviceState = statusPin ? MAX(deviceState_powerOn, g_lqLTEM.deviceState) : deviceState_powerOff;
     return statusPin;
 }
 
 
+/**
+ *	@brief Attach edge interrupt monitoring to the BGx status pin.
+ */
+void QBG_attachStatusMonitor()
+{
+    g_lqLTEM.statusMon.isPowerOn = S__readStatusPin();
+    g_lqLTEM.statusMon.lastEdgeAt = pMillis();
+    g_lqLTEM.statusMon.unexpectedOff = false;
+    g_lqLTEM.statusMon.unexpectedOn = false;
+
+    platform_attachIsr(g_lqLTEM.pinConfig.statusPin, true, gpioIrqTriggerOn_change, S__statusPinISR);
+    g_lqLTEM.statusMon.isAttached = true;
+}
+
+
+/**
+ *	@brief Detach edge interrupt monitoring from the BGx status pin.
+ */
+void QBG_detachStatusMonitor()
+{
+    platform_detachIsr(g_lqLTEM.pinConfig.statusPin);
+    g_lqLTEM.statusMon.isAttached = false;
+}
+
+
+/**
+ *	@brief Signal that the driver is performing a power state change, edges are expected (not faults).
+ */
+void QBG_expectPowerChange(bool isExpected)
+{
+    g_lqLTEM.statusMon.expectChange = isExpected;
+}
+
+
+/**
+ *	@brief Check for (and clear) a power state change the driver did not request.
+ */
+bool QBG_checkUnexpectedPowerChange()
+{
+    if (!g_lqLTEM.statusMon.unexpectedOff && !g_lqLTEM.statusMon.unexpectedOn)
+        return false;
+
+    if (g_lqLTEM.statusMon.unexpectedOff)
+    {
+        PRINTF(dbgColor__warn, "LTEm power lost @%lu\r", g_lqLTEM.statusMon.lastOffAt);
+        ltem_notifyApp(appEvent_fault_hardFault, "LTEm unexpected power off");
+    }
+    else
+    {
+        PRINTF(dbgColor__warn, "LTEm restarted @%lu\r", g_lqLTEM.statusMon.lastOnAt);
+        ltem_notifyApp(appEvent_fault_hardFault, "LTEm unexpected restart");
+    }
+    g_lqLTEM.statusMon.unexpectedOff = false;
+    g_lqLTEM.statusMon.unexpectedOn = false;
+    return true;
+}
+
+
 /**
  *	@brief Power on the BGx module
  */
@@ -103,21 +177,19 @@ void QBG_powerOn()
         return;
     }
     g_lqLTEM.deviceState = deviceState_powerOff;
+    QBG_expectPowerChange(true);
 
     PRINTF(dbgColor__none, "Powering LTEm On...");
     platform_writePin(g_lqLTEM.pinConfig.powerkeyPin, gpioValue_high);  // toggle powerKey pin to power on/off
-    pDelay(BGX__powerOnDelay);
+    pDelay(QBG_getModuleCaps()->powerOnDelay);
     platform_writePin(g_lqLTEM.pinConfig.powerkeyPin, gpioValue_low);
 
-    uint8_t waitAttempts = 0;
-    while (!QBG_isPowerOn())
+    bool powerChanged = S__awaitPowerState(true, BGX__powerChangeTimeout);
+    QBG_expectPowerChange(false);
+    if (!powerChanged)
     {
-        if (waitAttempts++ == 60)
-        {
-            PRINTF(dbgColor__none, "FAILED\r");
-            return;
-        }
-        pDelay(100);                                                    // allow background tasks to operate
+        PRINTF(dbgColor__none, "FAILED\r");
+        return;
     }
     g_lqLTEM.deviceState = deviceState_powerOn;
     PRINTF(dbgColor__none, "DONE\r");
@@ -135,87 +207,25 @@ void QBG_powerOff()
         g_lqLTEM.deviceState = deviceState_powerOff;
         return;
     }
+    QBG_expectPowerChange(true);
 
     PRINTF(dbgColor__none, "Powering LTEm Off...");
 	platform_writePin(g_lqLTEM.pinConfig.powerkeyPin, gpioValue_high);  // toggle powerKey pin to power on/off
-	pDelay(BGX__powerOffDelay);
+	pDelay(QBG_getModuleCaps()->powerOffDelay);
 	platform_writePin(g_lqLTEM.pinConfig.powerkeyPin, gpioValue_low);
 
-    uint8_t waitAttempts = 0;
-    while (QBG_isPowerOn())
+    bool powerChanged = S__awaitPowerState(false, BGX__powerChangeTimeout);
+    QBG_expectPowerChange(false);
+    if (!powerChanged)
     {
-        if (waitAttempts++ == 60)
-        {
-            PRINTF(dbgColor__none, "FAILED\r");
-            return;
-        }
-        pDelay(100);                                                    // allow background tasks to operate
+        PRINTF(dbgColor__none, "FAILED\r");
+        return;
     }
     g_lqLTEM.deviceState = deviceState_powerOff;
     PRINTF(dbgColor__none, "DONE\r");
 }
 
 
-/**
- *	@brief Perform a hardware (pin)software reset of the BGx module
- */
-void QBG_reset(resetAction_t resetAction)
-{
-    // if (resetAction == skipIfOn)
-    // {fall through}
-
-    if (resetAction == resetAction_swReset && QBG_isPowerOn())
-    {
-        SC16IS7xx_sendBreak();                                              // test for do no harm
-        // atcmd_exitTextMode();                                            // clear possible text mode (hung MQTT publish, etc.)
-        // atcmd_sendCmdData("AT\r", 3, "");                                // clear cmd state
-
-        char cmdData[] = "AT+CFUN=1,1\r";                                   // DMA SPI DMA may not tolerate Flash source
-        IOP_startTx(cmdData, sizeof(cmdData));                              // soft-reset command: performs a module internal HW reset and cold-start
-
-        uint32_t waitStart = pMillis();                                     // start timer to wait for status pin == OFF
-        while (QBG_isPowerOn())
-        {
-            yield();                                                        // give application some time back for processing
-            if (pMillis() - waitStart > PERIOD_FROM_SECONDS(3))
-            {
-                PRINTF(dbgColor__warn, "LTEm swReset:OFF timeout\r");
-                // SC16IS7xx_sendBreak();
-                // atcmd_exitTextMode();                                    // clear possible text mode (hung MQTT publish, etc.)
-                QBG_reset(resetAction_powerReset);                          // recursive call with power-cycle reset specified
-                return;
-            }
-        }
-
-        waitStart = pMillis();                                              // start timer to wait for status pin == ON
-        while (!QBG_isPowerOn())
-        {
-            yield();                                                        // give application some time back for processing
-            if (pMillis() - waitStart > PERIOD_FROM_SECONDS(3))
-            {
-                PRINTF(dbgColor__warn, "LTEm swReset:ON timeout\r");
-                return;
-            }
-        }
-        PRINTF(dbgColor__white, "LTEm swReset\r");
-    }
-    else if (resetAction == resetAction_hwReset)
-    {
-        platform_writePin(g_lqLTEM.pinConfig.resetPin, gpioValue_high);     // hardware reset: reset pin (LTEm inverts)
-        pDelay(4000);                                                       // BG96: active for 150-460ms , BG95: 2-3.8s
-        platform_writePin(g_lqLTEM.pinConfig.resetPin, gpioValue_low);
-        PRINTF(dbgColor__white, "LTEm hwReset\r");
-    }
-    else // if (resetAction == powerReset)
-    {
-        QBG_powerOff();                                                     
-        pDelay(500);
-        QBG_powerOn();
-        PRINTF(dbgColor__white, "LTEm pwrReset\r");
-    }
-}
-
-
 /**
  *	@brief Initializes the BGx module
  */
@@ -270,6 +280,15 @@ void QBG_setOptions()
 }
 
 
+/**
+ *	@brief Get a BGx start script command by index, the non-blocking start sequence applies one per ltem_eventMgr() pass.
+ */
+const char *QBG_getInitCmd(uint8_t cmdIndx)
+{
+    return (cmdIndx < qbg_initCmdsCnt) ? qbg_initCmds[cmdIndx] : NULL;
+}
+
+
 /**
  *	@brief Attempts recovery of command control of the BGx module left in data mode
  */
@@ -293,5 +312,162 @@ const char *QBG_getModuleType()
 }
 
 
+/**
+ *	@brief Query BGx for its module type (ATI) and select the timing/capabilities table entry for the module.
+ */
+bool QBG_identifyModule()
+{
+    if (atcmd_tryInvoke("ATI") && atcmd_awaitResult() == resultCode__success)
+        return QBG_selectModule(atcmd_getResponse());
+    return QBG_selectModule(NULL);
+}
+
+
+/**
+ *	@brief Select the timing/capabilities table entry for the module from its ATI response.
+ */
+bool QBG_selectModule(const char *atiResponse)
+{
+    /* ATI response: Quectel\r\nBG96\r\nRevision: BG96MAR02A07M1G\r\n\r\nOK
+     */
+    char *typeStart = (atiResponse == NULL) ? NULL : strstr(atiResponse, "BG");
+    if (typeStart != NULL)
+    {
+        char *typeEnd = strchr(typeStart, '\r');
+        uint8_t typeSz = (typeEnd == NULL) ? 0 : MIN(typeEnd - typeStart, ltem__moduleTypeSz - 1);
+        memset(g_lqLTEM.moduleType, 0, ltem__moduleTypeSz);
+        memcpy(g_lqLTEM.moduleType, typeStart, typeSz);
+    }
+
+    for (size_t i = 1; i < qbg_moduleCapsCnt; i++)                          // entry 0 is default, matches everything
+    {
+        if (memcmp(g_lqLTEM.moduleType, qbg_moduleCaps[i].moduleType, strlen(qbg_moduleCaps[i].moduleType)) == 0)
+        {
+            g_lqLTEM.moduleCaps = &qbg_moduleCaps[i];
+            PRINTF(dbgColor__info, "Module: %s\r", g_lqLTEM.moduleType);
+            return true;
+        }
+    }
+    PRINTF(dbgColor__warn, "Module type unknown: %s\r", g_lqLTEM.moduleType);
+    g_lqLTEM.moduleCaps = &qbg_moduleCaps[0];
+    return false;
+}
+
+
+/**
+ *	@brief Get the timing and capabilities for the BGx module.
+ */
+const moduleCaps_t *QBG_getModuleCaps()
+{
+    return (g_lqLTEM.moduleCaps == NULL) ? &qbg_moduleCaps[0] : g_lqLTEM.moduleCaps;
+}
+
+
+/**
+ *	@brief Test if the BGx module supports a feature.
+ */
+bool QBG_hasFeature(moduleFeature_t feature)
+{
+    return (QBG_getModuleCaps()->features & feature) == feature;
+}
+
+
 #pragma endregion
 
+
+#pragma region Static Function Definitions
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ *	@brief Wait for the BGx status pin to reach a power state, completes at the status edge when monitored.
+ */
+static bool S__awaitPowerState(bool powerOn, uint32_t timeoutMs)
+{
+    uint32_t waitStart = pMillis();
+    while (QBG_isPowerOn() != powerOn)
+    {
+        if (pMillis() - waitStart > timeoutMs)
+            return false;
+
+        if (g_lqLTEM.statusMon.isAttached)
+            pYield();                                                       // give application some time back for processing
+        else
+            pDelay(BGX__powerPollInterval);                                 // no edge monitoring, poll the status pin
+    }
+    return true;
+}
+
+
+/**
+ *	@brief Read the BGx status pin directly (GPIO).
+ */
+static bool S__readStatusPin()
+{
+    gpioPinValue_t statusPin = platform_readPin(g_lqLTEM.pinConfig.statusPin);
+
+    #ifdef STATUS_LOW_PULLDOWN
+    if (statusPin)                                                          // if pin high, assume latched
+    {
+        if (g_lqLTEM.statusMon.isAttached)
+            platform_detachIsr(g_lqLTEM.pinConfig.statusPin);               // discharge is not a status edge
+        platform_closePin(g_lqLTEM.pinConfig.statusPin);
+        platform_openPin(g_lqLTEM.pinConfig.statusPin, gpioMode_output);    // open status for write, set low
+        platform_writePin(g_lqLTEM.pinConfig.statusPin, gpioValue_low);     // set low
+        //pDelay(1);
+        platform_closePin(g_lqLTEM.pinConfig.statusPin);
+        platform_openPin(g_lqLTEM.pinConfig.statusPin, gpioMode_input);     // reopen for normal usage (read)
+        if (g_lqLTEM.statusMon.isAttached)
+            platform_attachIsr(g_lqLTEM.pinConfig.statusPin, true, gpioIrqTriggerOn_change, S__statusPinISR);
+
+        statusPin = platform_readPin(g_lqLTEM.pinConfig.statusPin);         // perform 2nd read, after pull-down sequence
+    }
+    #endif
+
+    return statusPin == gpioValue_high;
+}
+
+
+/**
+ *	@brief Discharge a latched status pin (rate limited), record the OFF transition the edge ISR cannot see.
+ */
+static void S__checkLatchedOff()
+{
+    g_lqLTEM.statusMon.latchCheckAt = pMillis();
+    if (S__readStatusPin())
+        return;
+
+    g_lqLTEM.statusMon.isPowerOn = false;
+    g_lqLTEM.statusMon.lastOffAt = g_lqLTEM.statusMon.lastEdgeAt = g_lqLTEM.statusMon.latchCheckAt;
+    g_lqLTEM.statusMon.transitions++;
+    g_lqLTEM.statusMon.unexpectedOff = !g_lqLTEM.statusMon.expectChange;
+}
+
+
+/**
+ *	@brief ISR for BGx status pin edges, timestamps the power state transition.
+ */
+static void S__statusPinISR()
+{
+    bool isPowerOn = platform_readPin(g_lqLTEM.pinConfig.statusPin) == gpioValue_high;
+    if (isPowerOn == g_lqLTEM.statusMon.isPowerOn)                          // no level change (bounce)
+        return;
+
+    uint32_t edgeAt = pMillis();
+    g_lqLTEM.statusMon.isPowerOn = isPowerOn;
+    g_lqLTEM.statusMon.lastEdgeAt = edgeAt;
+    g_lqLTEM.statusMon.transitions++;
+
+    if (isPowerOn)
+    {
+        g_lqLTEM.statusMon.lastOnAt = edgeAt;
+        g_lqLTEM.statusMon.unexpectedOn = !g_lqLTEM.statusMon.expectChange;
+    }
+    else
+    {
+        g_lqLTEM.statusMon.lastOffAt = edgeAt;
+        g_lqLTEM.statusMon.unexpectedOff = !g_lqLTEM.statusMon.expectChange;
+        g_lqLTEM.deviceState = deviceState_powerOff;                        // firmware (if restarting) will send APP RDY again
+    }
+}
+
+#pragma endregion
@@ -50,10 +50,65 @@ enum BGX__constants
     BGX__powerOnDelay = 500,
     BGX__powerOffDelay = 1500,
     BGX__resetDelay = 500,
+    BGX__resetPulseDelay = 4000,            /// BG96: active for 150-460ms , BG95: 2-3.8s
+    BGX__powerChangeTimeout = 6000,         /// max wait for status pin to follow a powerkey action
+    BGX__powerPollInterval = 100,           /// status pin poll interval, when status pin edge monitoring is not attached
     BGX__baudRate = 115200
 };
 
 
+/** 
+ *  \brief BGx status pin monitor, maintained by status pin edge ISR
+ */
+typedef struct statusMonitor_tag
+{
+    bool isAttached;                            /// edge ISR attached, isPowerOn is current without GPIO read
+    volatile bool isPowerOn;                    /// status pin level following last edge
+    volatile uint32_t lastEdgeAt;               /// tick count (mS) of last status pin transition
+    volatile uint32_t lastOnAt;                 /// tick count (mS) of last OFF to ON transition
+    volatile uint32_t lastOffAt;                /// tick count (mS) of last ON to OFF transition
+    volatile uint16_t transitions;              /// count of status pin transitions
+    volatile bool expectChange;                 /// driver is performing power/reset action, transitions are expected
+    volatile bool unexpectedOff;                /// BGx powered off without driver action: brownout or module fault
+    volatile bool unexpectedOn;                 /// BGx powered on without driver action: module restarted on its own
+    uint32_t latchCheckAt;                      /// tick count (mS) of last latched status pin check (STATUS_LOW_PULLDOWN)
+} statusMonitor_t;
+
+
+/** 
+ *  \brief Bit-map of BGx features that vary by module type
+ */
+typedef enum moduleFeature_tag
+{
+    moduleFeature_gnss = 0x0001,                /// GNSS receiver (QGPS)
+    moduleFeature_gsm = 0x0002,                 /// GSM (2G) fallback RAT
+    moduleFeature_nbIot = 0x0004,               /// LTE Cat NB-IoT RAT
+    moduleFeature_geofence = 0x0008,            /// module geo-fencing (QCFGEXT "addgeo")
+    moduleFeature_gpio = 0x0010,                /// host accessible GPIO (QCFG "gpio")
+    moduleFeature_mqttPubEx = 0x0020,           /// MQTT publish extended (QMTPUBEX)
+    moduleFeature_gnssConcurrent = 0x0040,      /// GNSS and LTE can operate simultaneously (BG95/BG77 share a single radio)
+    moduleFeature_tlsSessionCache = 0x0080      /// TLS session resumption (QSSLCFG "session_cache")
+} moduleFeature_t;
+
+
+/** 
+ *  \brief Module timing and capabilities, selected at start from the detected module type
+ */
+typedef struct moduleCaps_tag
+{
+    const char *moduleType;                     /// module type prefix as reported by ATI: BG96, BG95, BG77
+    uint16_t powerOnDelay;                      /// powerkey pulse width to turn ON (mS)
+    uint16_t powerOffDelay;                     /// powerkey pulse width to turn OFF (mS)
+    uint16_t resetPulseDelay;                   /// reset pin pulse width for hardware reset (mS)
+    uint16_t mqttMessageMaxSz;                  /// max message size for QMTPUB
+    uint16_t scktSendMaxSz;                     /// max data size for a single QISEND/QSSLSEND
+    uint8_t gpioMaxPin;                         /// highest module GPIO pin number (0 = no GPIO)
+    uint8_t adcMaxPin;                          /// highest module ADC port number
+    uint16_t features;                          /// bit-map of moduleFeature_t
+} moduleCaps_t;
+
+
+
 
 
 #ifdef __cplusplus
@@ -69,6 +124,33 @@ extern "C"
 bool QBG_isPowerOn();
 
 
+/**
+ *	@brief Attach edge interrupt monitoring to the BGx status pin.
+ *  @details Once attached QBG_isPowerOn() reports the ISR maintained state and power waits complete at the status pin edge.
+ */
+void QBG_attachStatusMonitor();
+
+
+/**
+ *	@brief Detach edge interrupt monitoring from the BGx status pin.
+ */
+void QBG_detachStatusMonitor();
+
+
+/**
+ *	@brief Signal that the driver is performing a power state change, status pin edges are expected (not faults).
+ *  @param isExpected [in] True while a power/reset action is underway.
+ */
+void QBG_expectPowerChange(bool isExpected);
+
+
+/**
+ *	@brief Check for (and clear) a status pin transition the driver did not request, notifies application if found.
+ *  @return True if the BGx powered off or restarted without a driver request (brownout, module reset).
+ */
+bool QBG_checkUnexpectedPowerChange();
+
+
 /**
  *	@brief Power on the BGx module
  */
@@ -81,16 +163,19 @@ void QBG_powerOn();
 void QBG_powerOff();
 
 
+
 /**
- *	@brief Perform a hardware or software reset of the BGx module
+ *	@brief Initializes the BGx module
  */
-void QBG_reset(resetAction_t resetAction);
+void QBG_setOptions();
 
 
 /**
- *	@brief Initializes the BGx module
+ *	@brief Get a BGx start script command (see QBG_setOptions()) by index.
+ *  @param cmdIndx [in] Index of the command in the start script.
+ *  @return The command, NULL if the index is past the end of the script.
  */
-void QBG_setOptions();
+const char *QBG_getInitCmd(uint8_t cmdIndx);
 
 
 /**
@@ -106,6 +191,37 @@ bool QBG_clearDataState();
 const char *QBG_getModuleType();
 
 
+/**
+ *	@brief Query BGx for its module type (ATI) and select the timing/capabilities table entry for the module.
+ *  @return True if the module type was recognized, otherwise the conservative default table entry remains selected.
+ */
+bool QBG_identifyModule();
+
+
+/**
+ *	@brief Select the timing/capabilities table entry for the module from its ATI response (no BGx command).
+ *  @param atiResponse [in] Response to ATI, NULL if not available.
+ *  @return True if the module type was recognized, otherwise the conservative default table entry is selected.
+ */
+bool QBG_selectModule(const char *atiResponse);
+
+
+/**
+ *	@brief Get the timing and capabilities for the BGx module.
+ *  @details Prior to module identification (1st start), the conservative default values are returned.
+ *  @return Pointer to the (const) module capabilities table entry
+ */
+const moduleCaps_t *QBG_getModuleCaps();
+
+
+/**
+ *	@brief Test if the BGx module supports a feature.
+ *  @param feature [in] The feature to test for.
+ *  @return True if the feature is supported by the module.
+ */
+bool QBG_hasFeature(moduleFeature_t feature);
+
+
 #ifdef __cplusplus
 }
 #endif // !__cplusplus
@@ -42,9 +42,14 @@
 #define SRCFILE "SKT"                           // create SRCFILE (3 char) MACRO for lq-diagnostics ASSERT
 #include "ltemc-internal.h"
 #include "ltemc-sckt.h"
+#if LTEMC_ENABLE_GNSS_SHARE
+#include "ltemc-gnss-share.h"
+#endif
 
 extern ltemDevice_t g_lqLTEM;
 
+#if LTEMC_ENABLE_SCKT                           // module selection, see ltemc-config.h
+
 
 #define MIN(x, y) (((x) < (y)) ? (x) : (y))
 #define MAX(x, y) (((x) < (y)) ? (y) : (x))
@@ -56,8 +61,10 @@ extern ltemDevice_t g_lqLTEM;
 
 // file scope local function declarations
 static resultCode_t S__scktTxDataHndlr();
-static void S__scktUrcHndlr();
+static resultCode_t S__scktUrcHndlr();
+static void S__scktDoWork();
 static resultCode_t S__scktRxHndlr();
+static resultCode_t S__scktRecoverHndlr(void *streamCtrl);
 
 static cmdParseRslt_t S__irdResponseHeaderParser();
 static cmdParseRslt_t S__sslrecvResponseHeaderParser();
@@ -84,13 +91,16 @@ void sckt_initControl(scktCtrl_t *scktCtrl, dataCntxt_t dataCntxt, streamType_t
     scktCtrl->dataCntxt = dataCntxt;
     scktCtrl->streamType = (char)protocol;
     scktCtrl->useTls = protocol == streamType_SSLTLS;
-    scktCtrl->irdPending = false;
+    scktCtrl->irdPending = 0;
     scktCtrl->flushing = false;
     scktCtrl->statsRxCnt = 0;
     scktCtrl->statsTxCnt = 0;
     scktCtrl->appRecvDataCB = recvCallback;
+    scktCtrl->urcEvntHndlr = S__scktUrcHndlr;
+    scktCtrl->recoverHndlr = S__scktRecoverHndlr;
 
     g_lqLTEM.streams[dataCntxt] = (streamCtrl_t*)scktCtrl;
+    LTEM_registerDoWorker(S__scktDoWork);                               // drains receives in chunks, releasing AT channel between chunks
 }
 
 
@@ -106,6 +116,15 @@ void sckt_setConnection(scktCtrl_t *scktCtrl, uint8_t pdpCntxt, const char *host
 }
 
 
+/**
+ *	@brief Set the TLS profile for a SSL/TLS socket, applied at each open and reopen
+ */
+void sckt_setTlsProfile(scktCtrl_t *scktCtrl, const tlsProfile_t *tlsProfile)
+{
+    scktCtrl->tlsProfile = tlsProfile;
+}
+
+
 /**
  *	@brief Open a data connection (socket) to d data to an established endpoint via protocol used to open socket (TCP/UDP/TCP INCOMING).
  */
@@ -128,13 +147,21 @@ resultCode_t sckt_open(scktCtrl_t *scktCtrl, bool cleanSession)
 
     else if (scktCtrl->streamType == 'S')               // protocol == SSL/TLS
     {
+        if (scktCtrl->tlsProfile != NULL && (rslt = tls_applyProfile(scktCtrl->dataCntxt, scktCtrl->tlsProfile)) != resultCode__success)
+            return rslt;                                                        // no AT traffic if context unchanged
+
+        uint32_t openStart = pMillis();
         atcmd_tryInvoke("AT+QSSLOPEN=%d,%d,\"SSL\",\"%s\",%d,%d", pdpCntxt, scktCtrl->dataCntxt, scktCtrl->hostUrl, scktCtrl->hostPort, scktCtrl->lclPort);
         rslt = atcmd_awaitResultWithOptions(sckt__defaultOpenTimeoutMS, S__sslOpenCompleteParser);
+        if (rslt == resultCode__success)
+            TLS_recordHandshake(scktCtrl->dataCntxt, scktCtrl->hostUrl, pMillis() - openStart);
     }
 
     if (rslt == resultCode__success)
     {
-        ltem_addStream(scktCtrl);
+        scktCtrl->state = scktState_open;
+        if (ltem_getStreamFromCntxt(scktCtrl->dataCntxt, streamType__ANY) == NULL)    // registered at init, re-added here on reopen
+            ltem_addStream(scktCtrl);
     }
     return rslt;
 }
@@ -211,11 +238,17 @@ bool sckt_getState(scktCtrl_t *scktCtrl)
 resultCode_t sckt_send(scktCtrl_t *scktCtrl, const char *data, uint16_t dataSz)
 {
     resultCode_t rslt;
+    ASSERT(dataSz <= QBG_getModuleCaps()->scktSendMaxSz);                   // max send length QISEND=1460
+
+    #if LTEMC_ENABLE_GNSS_SHARE
+    if (gnssShare_isDataBlackout())                                         // radio serving a GNSS window, LTE data suspended
+        return resultCode__unavailable;
+    #endif
 
     atcmd_configDataMode(scktCtrl->dataCntxt, "> ", atcmd_stdTxDataHndlr, data, dataSz, NULL, true);
     atcmd_configDataModeEot(0x1A);
 
-    if (atcmd_tryInvoke("AT+QISEND=%d,%d", scktCtrl->dataCntxt, dataSz))
+    if (atcmd_tryInvokeFmt(atcmdFmt_qisend, scktCtrl->dataCntxt, dataSz))
     {
         rslt = atcmd_awaitResultWithOptions(atcmd__defaultTimeout, S__socketSendCompleteParser);
         if (rslt == resultCode__success)
@@ -263,6 +296,27 @@ resultCode_t sckt_send(scktCtrl_t *scktCtrl, const char *data, uint16_t dataSz)
 
 #define SCKT_URC_HEADERSZ 30
 
+
+/**
+ *   @brief Reopen socket following BGx restart (health monitor recovery), BGx has no socket state following restart.
+*/
+static resultCode_t S__scktRecoverHndlr(void *streamCtrl)
+{
+    scktCtrl_t *scktCtrl = (scktCtrl_t*)streamCtrl;
+    scktCtrl->irdPending = 0;
+    scktCtrl->flushing = false;
+
+    if (scktCtrl->state != scktState_open)                                      // never opened or closed by app/peer, nothing to reopen
+    {
+        if (ltem_getStreamFromCntxt(scktCtrl->dataCntxt, streamType__ANY) == NULL)
+            ltem_addStream(scktCtrl);                                           // recovery cleared the streams table slot, keep registered
+        return resultCode__success;
+    }
+    scktCtrl->state = scktState_closed;
+    return sckt_open(scktCtrl, true);
+}
+
+
 /**
  *   @brief Move socket data through pipeline.
  * 
@@ -280,21 +334,21 @@ resultCode_t sckt_send(scktCtrl_t *scktCtrl, const char *data, uint16_t dataSz)
      * +QIURC: "pdpdeact",<contextID>   // not handled here, falls through to global URC handler
     */
 
-static void S__scktUrcHndlr()
+static resultCode_t S__scktUrcHndlr()
 {
     cBuffer_t *rxBffr = g_lqLTEM.iop->rxBffr;                           // for convenience
 
     // not a socket URC or insufficient chars to parse URC header
     if (cbffr_find(rxBffr, "\"pdpdeact\"", 0, 0, false) >= 0)           // +QIURC: "pdpdeact" handled at higher level, +QIURC overlaps with UDP/TCP
     {
-        return;
+        return resultCode__cancelled;
     }
 
     bool isUdpTcp = CBFFR_FOUND(cbffr_find(rxBffr, "+QIURC", 0, 0, false));
     bool isSslTls = CBFFR_FOUND(cbffr_find(rxBffr, "+QSSLURC", 0, 0, false));
     if (!isUdpTcp && !isSslTls)
     {
-        return;
+        return resultCode__cancelled;
     }
 
     /* UDP/TCP/SSL/TLS URC
@@ -320,7 +374,7 @@ static void S__scktUrcHndlr()
     }
     else
     {
-        return;                                                             // don't have full URC line yet, come back later
+        return resultCode__cancelled;                                       // don't have full URC line yet, come back later
     }
     
     /* URC ready to process
@@ -340,24 +394,8 @@ static void S__scktUrcHndlr()
                streamCtrl->streamType == streamType_SSLTLS);
         scktCtrl_t* scktCtrl = (scktCtrl_t*)streamCtrl;
 
-        uint16_t irdRemain = 0;
-        do
-        {
-            uint16_t irdRqstSz = cbffr_getVacant(g_lqLTEM.iop->rxBffr) / 2;     // request up to half of available buffer space
-            if (isUdpTcp)
-            {
-                atcmd_configDataMode(scktCtrl->dataCntxt, "+QIRD: ", S__scktRxHndlr, NULL, 0, scktCtrl->appRecvDataCB, true);
-                atcmd_tryInvoke("AT+QIRD=%d,%d", (uint8_t)dataCntxt, irdRqstSz);
-            }
-            else
-            {
-                atcmd_configDataMode(scktCtrl->dataCntxt, "+QSSLRECV: ", S__scktRxHndlr, NULL, 0, scktCtrl->appRecvDataCB, true);
-                atcmd_tryInvoke("AT+QSSLRECV=%d,%d", (uint8_t)dataCntxt, irdRqstSz);
-            }
-            atcmd_awaitResult();
-            irdRemain = atcmd_getValue();
-
-        } while (irdRemain > 0);
+        scktCtrl->irdPending = sckt__irdRequestPageSz;                      // drained by S__scktDoWork() a chunk per pass, resumable
+        scktCtrl->statsRxCnt++;
     }
 
     // "closed" = socket closed
@@ -370,10 +408,60 @@ static void S__scktUrcHndlr()
         ((scktCtrl_t*)g_lqLTEM.streams[indx])->state = scktState_closed;
     }
 
-    return;
+    return resultCode__success;
 }    
 
 
+/**
+ * @brief Socket background worker, drains pending receives one IRD/SSLRECV chunk per pass.
+ * @details The AT channel is taken (bulk priority) for a single chunk and released, other commands interleave between
+ *          chunks. Drain state (irdPending) is kept in the socket control, sockets are serviced round-robin.
+ */
+static void S__scktDoWork()
+{
+    static uint8_t nextStream = 0;
+
+    for (size_t i = 0; i < ltem__streamCnt; i++)
+    {
+        uint8_t indx = (nextStream + i) % ltem__streamCnt;
+        streamCtrl_t *streamCtrl = g_lqLTEM.streams[indx];
+        if (streamCtrl == NULL || 
+            (streamCtrl->streamType != streamType_UDP && streamCtrl->streamType != streamType_TCP && streamCtrl->streamType != streamType_SSLTLS))
+            continue;
+
+        scktCtrl_t *scktCtrl = (scktCtrl_t*)streamCtrl;
+        if (scktCtrl->irdPending == 0)
+            continue;
+
+        uint16_t rxVacant = IOP_getRxVacant();                                         // RX buffer space net of app held (leased) regions
+        if (rxVacant < IOP__rxLeaseHeadroom)                                            // backpressure: leases outstanding, resume after release
+            return;
+        if (!ATCMD_awaitLockPriority(0, atcmdPriority_bulk, "sckt-rd"))                // channel busy or higher priority waiting, resume next pass
+            return;
+
+        uint16_t irdRqstSz = MIN(rxVacant / 2, sckt__irdRequestMaxSz);                 // request up to half of available buffer space
+        if (scktCtrl->useTls)
+        {
+            atcmd_configDataMode(scktCtrl->dataCntxt, "+QSSLRECV: ", S__scktRxHndlr, NULL, 0, scktCtrl->appRecvDataCB, true);
+            atcmd_invokeFmtReuseLock(atcmdFmt_qsslrecv, scktCtrl->dataCntxt, irdRqstSz);
+        }
+        else
+        {
+            atcmd_configDataMode(scktCtrl->dataCntxt, "+QIRD: ", S__scktRxHndlr, NULL, 0, scktCtrl->appRecvDataCB, true);
+            atcmd_invokeFmtReuseLock(atcmdFmt_qird, scktCtrl->dataCntxt, irdRqstSz);
+        }
+        if (atcmd_awaitResult() == resultCode__success)
+            scktCtrl->irdPending = atcmd_getValue();                                    // chunk size read, 0 = drained
+        else
+            scktCtrl->irdPending = 0;                                                   // abandon, next recv URC restarts drain
+        atcmd_close();
+
+        nextStream = indx + 1;                                                          // one chunk per pass
+        return;
+    }
+}
+
+
 /**
  * @brief Socket protocol (UDP/TCP/SSL) stream RX data handler, marshalls incoming data from RX buffer to app (application).
  */
@@ -507,3 +595,5 @@ static cmdParseRslt_t S__socketStatusParser(const char *response, char **endptr)
 }
 
 #pragma endregion
+
+#endif  // LTEMC_ENABLE_SCKT
@@ -29,6 +29,7 @@
 
 #include <lq-types.h>
 #include "ltemc-types.h"
+#include "ltemc-tls.h"
 
 
 
@@ -51,7 +52,7 @@ typedef void (*scktAppRecv_func)(dataCntxt_t dataCntxt, char* dataPtr, uint16_t
  */
 enum sckt__constants
 {
-    sckt__urlHostSz = 128,
+    sckt__urlHostSz = LTEMC_SCKT_URL_SZ,
     sckt__resultCode_alreadyOpen = 563,
     sckt__defaultOpenTimeoutMS = 60000,
     sckt__irdRequestMaxSz = 1500,
@@ -79,6 +80,7 @@ typedef struct scktCtrl_tag
     dataCntxt_t dataCntxt;                      /// integer representing the source of the stream; fixed for protocols, file handle for FS
     dataRxHndlr_func dataRxHndlr;               /// function to handle data streaming, initiated by eventMgr() or atcmd module
     urcEvntHndlr_func urcEvntHndlr;             /// function to determine if "potential" URC event is for an open stream and perform reqd actions
+    recoverHndlr_func recoverHndlr;             /// function to reopen stream following BGx restart, NULL if stream is not reopened
 
     /* Above section of <stream>Ctrl structure is the same for all LTEmC implemented streams/protocols TCP/HTTP/MQTT etc. 
     */
@@ -88,10 +90,11 @@ typedef struct scktCtrl_tag
     uint16_t hostPort;
     uint16_t lclPort;
     bool useTls;
+    const tlsProfile_t *tlsProfile;             /// optional TLS profile applied at each SSL open (reopen), application owned
     scktState_t state;
 
     bool flushing;                              /// True if the socket was opened with cleanSession and the socket was found already open.
-    uint16_t irdPending;                        /// Char count of remaining for current IRD/SSLRECV flow. Starts at reported IRD value and counts down
+    uint16_t irdPending;                        /// Receive drain pending (size of last IRD/SSLRECV chunk), 0 = drained. Set by recv URC, serviced by background worker
     uint32_t statsTxCnt;                        /// Number of atomic TX sends
     uint32_t statsRxCnt;                        /// Number of atomic RX segments (URC/IRD)
 } scktCtrl_t;
@@ -129,6 +132,15 @@ void sckt_initControl(scktCtrl_t *scktCtrl, dataCntxt_t dataCntxt, streamType_t
 void sckt_setConnection(scktCtrl_t *scktCtrl, uint8_t pdpCntxt, const char *hostUrl, const uint16_t hostPort, uint16_t lclPort);
 
 
+/**
+ *	@brief Set the TLS profile for a SSL/TLS socket, applied (only changes) to the socket data context at each open and reopen
+ *  @details Enable tlsProfile_t sessionCache for reopens to resume the TLS session, see tls_getHandshakeInfo() for results.
+ *  @param scktCtrl [in/out] Pointer to socket control structure
+ *  @param tlsProfile [in] TLS profile, must remain valid while the socket is in use; NULL to leave context settings unmanaged
+ */
+void sckt_setTlsProfile(scktCtrl_t *scktCtrl, const tlsProfile_t *tlsProfile);
+
+
 /**
  *	@brief Open a data connection (socket) to d data to an established endpoint via protocol used to open socket (TCP/UDP/TCP INCOMING)
  *  @param scktCtrl [in/out] Pointer to socket control structure
@@ -0,0 +1,457 @@
+/** ****************************************************************************
+  \file 
+  \brief Public API network time service: cached UTC clock with tick offset interpolation
+  \author Greg Terrell, LooUQ Incorporated
+
+  \loouq
+
+--------------------------------------------------------------------------------
+
+    This project is released under the GPL-3.0 License.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ 
+***************************************************************************** */
+
+
+#define _DEBUG 0                                // set to non-zero value for PRINTF debugging output, 
+// debugging output options                     // LTEm1c will satisfy PRINTF references with empty definition if not already resolved
+#if _DEBUG > 0
+    asm(".global _printf_float");               // forces build to link in float support for printf
+    #if _DEBUG == 1
+    #define SERIAL_DBG 1                        // enable serial port output using devl host platform serial, 1=wait for port
+    #elif _DEBUG == 2
+    #include <jlinkRtt.h>                       // output debug PRINTF macros to J-Link RTT channel
+    #define PRINTF(c_,f_,__VA_ARGS__...) do { rtt_printf(c_, (f_), ## __VA_ARGS__); } while(0)
+    #endif
+#else
+#define PRINTF(c_, f_, ...) 
+#endif
+
+#define SRCFILE "TIM"                           // create SRCFILE (3 char) MACRO for lq-diagnostics ASSERT
+#include "ltemc-internal.h"
+#include "ltemc-time.h"
+
+extern ltemDevice_t g_lqLTEM;
+
+#if LTEMC_ENABLE_TIME                           // module selection, see ltemc-config.h
+
+#define TIME_MINVALID_YEAR 2020                 // BGx RTC reports 1980 (or 2000) when never synchronized
+#define TIME_SECS_PER_DAY 86400
+
+
+// private local declarations
+static bool S__parseDateTime(const char *dtStr, bool applyTz, uint32_t *epoch);
+static void S__applySync(uint32_t epoch, timeSource_t timeSource);
+static resultCode_t S__cellChangeUrcHndlr();
+static cmdParseRslt_t S__qltsParser();
+static cmdParseRslt_t S__cclkParser();
+static cmdParseRslt_t S__qntpParser();
+
+
+/* Time formats
+ *  +QLTS: "2019/01/13,03:40:48+32,0"       (mode=1: GMT with local timezone in quarter hours, DST)
+ *  +CCLK: "19/01/13,11:40:48+32"           (local time with timezone in quarter hours)
+ *  +QNTP: 0,"2019/01/13,11:40:48+32"       (URC following OK, local time with timezone)
+***************************************************************************** */
+
+
+#pragma region public functions
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ *	@brief Synchronize the host UTC clock from a BGx time source.
+ */
+resultCode_t time_sync(timeSource_t timeSource)
+{
+    resultCode_t rslt = resultCode__conflict;
+    uint32_t epoch = 0;
+    bool parsed = false;
+
+    g_lqLTEM.timeCtrl.lastAttemptAt = pMillis();
+    if (timeSource == timeSource_network)
+    {
+        if (atcmd_tryInvoke("AT+QLTS=1"))
+        {
+            rslt = atcmd_awaitResultWithOptions(atcmd__defaultTimeout, S__qltsParser);
+            if (rslt == resultCode__success)
+                parsed = S__parseDateTime(atcmd_getResponse(), false, &epoch);
+        }
+    }
+    else if (timeSource == timeSource_module)
+    {
+        if (atcmd_tryInvoke("AT+CCLK?"))
+        {
+            rslt = atcmd_awaitResultWithOptions(atcmd__defaultTimeout, S__cclkParser);
+            if (rslt == resultCode__success)
+                parsed = S__parseDateTime(atcmd_getResponse(), true, &epoch);
+        }
+    }
+    else if (timeSource == timeSource_ntp)
+    {
+        ASSERT(!STREMPTY(g_lqLTEM.timeCtrl.ntpServer));
+
+        uint8_t pdpCntxt = (g_lqLTEM.providerInfo->defaultContext == 0) ? 1 : g_lqLTEM.providerInfo->defaultContext;
+        if (atcmd_tryInvoke("AT+QNTP=%d,\"%s\",%d", pdpCntxt, g_lqLTEM.timeCtrl.ntpServer, time__defaultNtpPort))
+        {
+            rslt = atcmd_awaitResultWithOptions(time__ntpTimeout, S__qntpParser);
+            if (rslt == resultCode__success)
+            {
+                char *ntpRslt = atcmd_getResponse();
+                if (strtol(ntpRslt, &ntpRslt, 10) == 0)                             // QNTP error code, 0 = success
+                    parsed = S__parseDateTime(ntpRslt, true, &epoch);
+                else
+                    rslt = resultCode__gtwyTimeout;                                 // NTP server not reached/responded
+            }
+        }
+    }
+
+    if (rslt == resultCode__success)
+    {
+        if (!parsed)
+            return resultCode__notFound;                                            // source has no valid time (yet)
+
+        S__applySync(epoch, timeSource);
+    }
+    return rslt;
+}
+
+
+/**
+ *	@brief Set NTP server used for timeSource_ntp synchronization.
+ */
+void time_setNtpServer(const char *ntpServer)
+{
+    strncpy(g_lqLTEM.timeCtrl.ntpServer, ntpServer, time__ntpServerSz - 1);
+}
+
+
+/**
+ *	@brief Enable automatic resync, serviced by ltem_eventMgr().
+ */
+void time_enableAutoSync(timeSource_t timeSource, uint32_t resyncPeriodSec, bool onCellChange)
+{
+    g_lqLTEM.timeCtrl.source = timeSource;
+    g_lqLTEM.timeCtrl.resyncPeriod = PERIOD_FROM_SECONDS(resyncPeriodSec);
+    g_lqLTEM.timeCtrl.resyncOnCellChange = onCellChange;
+
+    if (onCellChange)
+    {
+        LTEM_registerUrcHandler(S__cellChangeUrcHndlr);                             // serviced by ltem_eventMgr() URC dispatch (after cache invalidation observes)
+        if (atcmd_tryInvoke("AT+CEREG=2"))                                          // registration URC with TAC and cell ID
+            atcmd_awaitResult();
+    }
+}
+
+
+/**
+ *	@brief Set the BGx RTC from the host UTC clock.
+ */
+resultCode_t time_setModuleClock()
+{
+    char dateTime[time__dateTimeSz];
+    if (!time_getUtcDateTime(dateTime))                                             // YYYY-MM-DDTHH:MM:SSZ
+        return resultCode__preConditionFailed;
+
+    resultCode_t rslt = resultCode__conflict;
+    if (atcmd_tryInvoke("AT+CCLK=\"%.2s/%.2s/%.2s,%.8s+00\"", dateTime + 2, dateTime + 5, dateTime + 8, dateTime + 11))   // "yy/MM/dd,hh:mm:ss±zz", UTC
+    {
+        rslt = atcmd_awaitResult();
+        if (rslt == resultCode__success)
+        {
+            g_lqLTEM.timeCtrl.moduleClockSet = true;
+            g_lqLTEM.timeCtrl.moduleClockStart = g_lqLTEM.startCtrl.startedAt;
+        }
+    }
+    return rslt;
+}
+
+
+/**
+ *	@brief Test if the time service has been synchronized.
+ */
+bool time_isSynced()
+{
+    return g_lqLTEM.timeCtrl.syncCnt > 0;
+}
+
+
+/**
+ *	@brief Get the host tick drift estimate.
+ */
+int32_t time_getDriftPpm()
+{
+    return g_lqLTEM.timeCtrl.driftPpm;
+}
+
+
+/**
+ *	@brief Get the current UTC time in milliseconds since 1970, no AT command is sent.
+ */
+uint64_t time_getUtcMillis()
+{
+    if (g_lqLTEM.timeCtrl.syncCnt == 0)
+        return 0;
+
+    int64_t elapsed = (uint32_t)(pMillis() - g_lqLTEM.timeCtrl.syncMillis);                 // unsigned difference handles pMillis() roll
+    elapsed -= elapsed * g_lqLTEM.timeCtrl.driftPpm / 1000000;                              // correct host tick drift
+    return (uint64_t)g_lqLTEM.timeCtrl.syncEpoch * 1000 + elapsed;
+}
+
+
+/**
+ *	@brief Get the current UTC as an ISO8601 string (YYYY-MM-DDTHH:MM:SSZ), no AT command is sent.
+ */
+bool time_getUtcDateTime(char *dateTime)
+{
+    uint32_t epoch = ltem_getUtc();
+    if (epoch == 0)
+        return false;
+
+    /* civil from days: Howard Hinnant, chrono-Compatible Low-Level Date Algorithms
+     */
+    uint32_t secsOfDay = epoch % TIME_SECS_PER_DAY;
+    uint32_t z = epoch / TIME_SECS_PER_DAY + 719468;
+    uint32_t era = z / 146097;
+    uint32_t doe = z - era * 146097;
+    uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    uint32_t mp = (5 * doy + 2) / 153;
+    uint8_t day = doy - (153 * mp + 2) / 5 + 1;
+    uint8_t month = mp < 10 ? mp + 3 : mp - 9;
+    uint16_t year = yoe + era * 400 + (month <= 2);
+
+    snprintf(dateTime, time__dateTimeSz, "%04d-%02d-%02dT%02d:%02d:%02dZ", year, month, day, 
+             secsOfDay / 3600, (secsOfDay % 3600) / 60, secsOfDay % 60);
+    return true;
+}
+
+
+/**
+ *	@brief Convert UTC calendar date/time to seconds since 1970.
+ *  @details days from civil: Howard Hinnant, chrono-Compatible Low-Level Date Algorithms
+ */
+uint32_t time_toEpoch(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second)
+{
+    year -= (month <= 2);
+    uint32_t era = year / 400;
+    uint32_t yoe = year - era * 400;
+    uint32_t doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    uint32_t days = era * 146097 + doe - 719468;
+    return days * TIME_SECS_PER_DAY + hour * 3600 + minute * 60 + second;
+}
+
+
+/**
+ *	@brief Convert a BGx quoted date/time (UTC) to seconds since 1970.
+ */
+uint32_t time_parseDateTime(const char *dateTime)
+{
+    uint32_t epoch;
+    return S__parseDateTime(dateTime, false, &epoch) ? epoch : 0;
+}
+
+
+/**
+ *	@brief Get the current UTC time, interpolated from the last sync with host ticks. No AT command is sent.
+ */
+uint32_t ltem_getUtc()
+{
+    return (uint32_t)(time_getUtcMillis() / 1000);
+}
+
+#pragma endregion
+
+
+#pragma region LTEmC Internal
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ *	@brief Set the BGx RTC from the host clock once per BGx start, BGx checks TLS certificate expiration against its RTC.
+ */
+void TIME_syncModuleClock()
+{
+    if (g_lqLTEM.timeCtrl.syncCnt == 0 || g_lqLTEM.timeCtrl.source == timeSource_module)    // no host time, or host time is from the BGx RTC
+        return;
+    if (g_lqLTEM.timeCtrl.moduleClockSet && g_lqLTEM.timeCtrl.moduleClockStart == g_lqLTEM.startCtrl.startedAt)
+        return;                                                                             // set in this BGx start
+
+    if (time_setModuleClock() != resultCode__success)
+    {
+        PRINTF(dbgColor__warn, "Module clock set failed\r");
+    }
+}
+
+
+/**
+ *	@brief Time service background work (scheduled/cell change resync), invoked from ltem_eventMgr().
+ */
+void TIME_doWork()
+{
+    if (g_lqLTEM.timeCtrl.source == timeSource_none ||                                      // auto sync not enabled
+        ATCMD_isLockActive() ||                                                             // command underway, its response may be in rxBffr
+        ATCMD_isLockPending() ||                                                            // requester queued for the lock
+        g_lqLTEM.deviceState != deviceState_appReady)
+        return;
+
+    bool resyncDue = g_lqLTEM.timeCtrl.resyncRequested || 
+                     (g_lqLTEM.timeCtrl.resyncPeriod > 0 && pMillis() - g_lqLTEM.timeCtrl.lastAttemptAt >= g_lqLTEM.timeCtrl.resyncPeriod);
+    if (resyncDue)
+    {
+        g_lqLTEM.timeCtrl.resyncRequested = false;                                          // on failure, retry is next period (no retry storm)
+        if (time_sync(g_lqLTEM.timeCtrl.source) != resultCode__success)
+        {
+            PRINTF(dbgColor__warn, "Time resync failed\r");
+        }
+    }
+}
+
+#pragma endregion
+
+
+#pragma region Static Function Definitions
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ *	@brief Record new sync point, updating drift estimate when the interval since the last sync is sufficient.
+ */
+static void S__applySync(uint32_t epoch, timeSource_t timeSource)
+{
+    uint32_t now = pMillis();
+
+    if (g_lqLTEM.timeCtrl.syncCnt > 0)
+    {
+        uint32_t hostElapsed = now - g_lqLTEM.timeCtrl.syncMillis;
+        if (hostElapsed >= time__driftMinInterval)
+        {
+            int64_t predictedMs = (int64_t)g_lqLTEM.timeCtrl.syncEpoch * 1000 + hostElapsed;   // uncorrected host tick prediction
+            int64_t errorMs = predictedMs - (int64_t)epoch * 1000;
+            int32_t ppm = (int32_t)(errorMs * 1000000 / hostElapsed);
+
+            if (ppm > -time__driftMaxPpm && ppm < time__driftMaxPpm)
+            {
+                g_lqLTEM.timeCtrl.driftPpm = (g_lqLTEM.timeCtrl.driftCnt > 0) ? (g_lqLTEM.timeCtrl.driftPpm + ppm) / 2 : ppm;
+                g_lqLTEM.timeCtrl.driftCnt++;
+            }
+            PRINTF(dbgColor__info, "Time drift: err=%ldms ppm=%ld\r", (int32_t)errorMs, ppm);
+        }
+    }
+    g_lqLTEM.timeCtrl.syncEpoch = epoch;
+    g_lqLTEM.timeCtrl.syncMillis = now;
+    g_lqLTEM.timeCtrl.syncCnt++;
+    if (g_lqLTEM.timeCtrl.source == timeSource_none)
+        g_lqLTEM.timeCtrl.source = timeSource;
+}
+
+
+/**
+ *	@brief Parse BGx quoted date/time: "[YY]YY/MM/DD,hh:mm:ss±zz" to UTC epoch.
+ *  @param [in] dtStr Response text, parsing starts at first double-quote.
+ *  @param [in] applyTz True if time is local time, timezone (quarter hours) is removed to obtain UTC.
+ */
+static bool S__parseDateTime(const char *dtStr, bool applyTz, uint32_t *epoch)
+{
+    char *parsePtr = strchr(dtStr, '"');
+    if (parsePtr == NULL || parsePtr[1] == '"')                                     // no time available: ""
+        return false;
+
+    uint16_t year = strtol(parsePtr + 1, &parsePtr, 10);
+    uint8_t month = strtol(parsePtr + 1, &parsePtr, 10);
+    uint8_t day = strtol(parsePtr + 1, &parsePtr, 10);
+    uint8_t hour = strtol(parsePtr + 1, &parsePtr, 10);
+    uint8_t minute = strtol(parsePtr + 1, &parsePtr, 10);
+    uint8_t second = strtol(parsePtr + 1, &parsePtr, 10);
+    int8_t tzQtrHours = (*parsePtr == '+' || *parsePtr == '-') ? strtol(parsePtr, &parsePtr, 10) : 0;
+
+    year += (year < 100) ? 2000 : 0;
+    if (year < TIME_MINVALID_YEAR || month < 1 || month > 12 || day < 1 || day > 31)
+        return false;
+
+    *epoch = time_toEpoch(year, month, day, hour, minute, second);
+    if (applyTz)
+        *epoch -= tzQtrHours * 900;
+    return true;
+}
+
+
+
+/**
+ *	@brief Service +CEREG URC (n=2), request resync if serving cell has changed.
+ */
+static resultCode_t S__cellChangeUrcHndlr()
+{
+    cBuffer_t *rxBffr = g_lqLTEM.iop->rxBffr;                                       // for convenience
+
+    /* +CEREG: <stat>[,"<tac>","<ci>",<AcT>]
+     */
+    if (cbffr_find(rxBffr, "+CEREG: ", 0, 0, false) != 0)                           // URC must be at tail, leading data belongs to other handlers
+        return resultCode__cancelled;
+
+    int16_t eolIndx = cbffr_find(rxBffr, "\r\n", 0, 0, false);
+    if (CBFFR_NOTFOUND(eolIndx))                                                    // URC not fully received, offered again on next eventMgr pass
+        return resultCode__cancelled;
+
+    char urcBffr[48] = {0};
+    if (eolIndx >= (int16_t)sizeof(urcBffr) - 1)                                    // not a form we handle, discard
+    {
+        cbffr_skipTail(rxBffr, eolIndx + 2);
+        return resultCode__success;
+    }
+    cbffr_pop(rxBffr, urcBffr, eolIndx + 2);
+
+    char *ciPtr = strchr(urcBffr, ',');                                             // ,"<tac>"
+    ciPtr = (ciPtr == NULL) ? NULL : strstr(ciPtr + 1, ",\"");                      // ,"<ci>"
+    if (ciPtr == NULL)
+        return resultCode__success;
+
+    ciPtr += 2;
+    char *ciEnd = strchr(ciPtr, '"');
+    if (ciEnd == NULL || ciEnd - ciPtr >= time__cellIdSz)
+        return resultCode__success;
+    *ciEnd = '\0';
+
+    if (strcmp(g_lqLTEM.timeCtrl.cellId, ciPtr) != 0)
+    {
+        PRINTF(dbgColor__info, "Cell change: %s > %s\r", g_lqLTEM.timeCtrl.cellId, ciPtr);
+        g_lqLTEM.timeCtrl.resyncRequested = g_lqLTEM.timeCtrl.resyncOnCellChange && !STREMPTY(g_lqLTEM.timeCtrl.cellId);  // initial report is not a change
+        strcpy(g_lqLTEM.timeCtrl.cellId, ciPtr);
+    }
+    return resultCode__success;
+}
+
+
+/* Time Response Parsers
+ * --------------------------------------------------------------------------------------------- */
+
+static cmdParseRslt_t S__qltsParser()
+{
+    return atcmd_stdResponseParser("+QLTS: ", true, "", 0, 0, "OK\r\n", 0);
+}
+
+
+static cmdParseRslt_t S__cclkParser()
+{
+    return atcmd_stdResponseParser("+CCLK: ", true, "", 0, 0, "OK\r\n", 0);
+}
+
+
+static cmdParseRslt_t S__qntpParser()
+{
+    return atcmd_stdResponseParser("+QNTP: ", true, "", 0, 0, "\r\n", 0);
+}
+
+#pragma endregion
+
+#endif  // LTEMC_ENABLE_TIME
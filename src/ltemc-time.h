@@ -0,0 +1,193 @@
+/** ****************************************************************************
+  \file 
+  \brief Public API network time service: cached UTC clock with tick offset interpolation
+  \author Greg Terrell, LooUQ Incorporated
+
+  \loouq
+
+--------------------------------------------------------------------------------
+
+    This project is released under the GPL-3.0 License.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ 
+***************************************************************************** */
+
+
+#ifndef __LTEMC_TIME_H__
+#define __LTEMC_TIME_H__
+
+#include "ltemc.h"
+
+
+/** 
+ *  @brief Typed numeric constants for time service.
+ */
+enum time__constants
+{
+    time__ntpServerSz = 40,
+    time__cellIdSz = 10,
+    time__dateTimeSz = 21,                      /// ISO8601 UTC: YYYY-MM-DDTHH:MM:SSZ
+    time__ntpTimeout = 125000,                  /// BGx QNTP max response time (mS)
+    time__driftMinInterval = 14400000,          /// min mS between syncs to update drift estimate (1 sec sync resolution = ~70ppm at 4hr)
+    time__driftMaxPpm = 500,                    /// drift estimates beyond this are discarded (clock step, not drift)
+    time__defaultNtpPort = 123
+};
+
+
+/** 
+ *  @brief Time sources available from BGx.
+ */
+typedef enum timeSource_tag
+{
+    timeSource_none = 0,
+    timeSource_network = 1,                     /// AT+QLTS: time from network (NITZ), available after network registration
+    timeSource_module = 2,                      /// AT+CCLK: BGx RTC, valid if BGx RTC previously synchronized
+    timeSource_ntp = 3                          /// AT+QNTP: NTP over active PDP context, also sets BGx RTC
+} timeSource_t;
+
+
+/** 
+ *  @brief Time service state: last sync point and host tick drift estimate.
+ */
+typedef struct timeCtrl_tag
+{
+    timeSource_t source;                        /// source of the last successful sync
+    uint32_t syncEpoch;                         /// UTC (seconds since 1970) at last sync
+    uint32_t syncMillis;                        /// host pMillis() at last sync
+    int32_t driftPpm;                           /// host tick drift estimate, parts per million (+ host fast)
+    uint16_t driftCnt;                          /// count of intervals contributing to driftPpm
+    uint16_t syncCnt;                           /// count of successful syncs
+    uint32_t lastAttemptAt;                     /// host pMillis() at last sync attempt (resync scheduling)
+    uint32_t resyncPeriod;                      /// mS between scheduled resyncs, 0 = no scheduled resync
+    bool resyncOnCellChange;                    /// resync when serving cell changes (+CEREG URC)
+    bool resyncRequested;                       /// resync is due (cell change)
+    char cellId[time__cellIdSz];                /// serving cell ID at last +CEREG
+    char ntpServer[time__ntpServerSz];          /// NTP server for timeSource_ntp
+    bool moduleClockSet;                        /// BGx RTC set from host clock (AT+CCLK=)
+    uint32_t moduleClockStart;                  /// startCtrl.startedAt of the BGx start the RTC was set in
+} timeCtrl_t;
+
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+
+/**
+ *	@brief Synchronize the host UTC clock from a BGx time source.
+ *  @param [in] timeSource Network (QLTS), module RTC (CCLK) or NTP (QNTP).
+ *  @return resultCode__success if synchronized, otherwise error code (HTTP status type).
+ */
+resultCode_t time_sync(timeSource_t timeSource);
+
+
+/**
+ *	@brief Set NTP server used for timeSource_ntp synchronization.
+ *  @param [in] ntpServer Host name or IP address of the NTP server.
+ */
+void time_setNtpServer(const char *ntpServer);
+
+
+/**
+ *	@brief Enable automatic resync, serviced by ltem_eventMgr().
+ *  @param [in] timeSource Source to use for resync.
+ *  @param [in] resyncPeriodSec Seconds between resyncs, 0 to disable scheduled resync.
+ *  @param [in] onCellChange Also resync when the serving cell changes (enables +CEREG URC with location).
+ */
+void time_enableAutoSync(timeSource_t timeSource, uint32_t resyncPeriodSec, bool onCellChange);
+
+
+/**
+ *	@brief Set the BGx RTC (AT+CCLK=) from the host UTC clock. BGx checks TLS certificate expiration against its RTC.
+ *  @details Set automatically (once per BGx start) when a TLS profile with tlsCertExpiration_check is applied.
+ *  @return resultCode__success if set, 412 if the time service is not synchronized, otherwise error code (HTTP status type).
+ */
+resultCode_t time_setModuleClock();
+
+
+/**
+ *	@brief Test if the time service has been synchronized.
+ *  @return True if at least one sync has completed.
+ */
+bool time_isSynced();
+
+
+/**
+ *	@brief Get the host tick drift estimate.
+ *  @return Drift in parts per million, positive if host ticks run fast.
+ */
+int32_t time_getDriftPpm();
+
+
+/**
+ *	@brief Get the current UTC time in milliseconds since 1970, no AT command is sent.
+ *  @return UTC milliseconds, 0 if time service not synchronized.
+ */
+uint64_t time_getUtcMillis();
+
+
+/**
+ *	@brief Get the current UTC as an ISO8601 string (YYYY-MM-DDTHH:MM:SSZ), no AT command is sent.
+ *  @param [out] dateTime Char buffer of at least time__dateTimeSz to receive the formatted time.
+ *  @return True if time service synchronized and dateTime is set.
+ */
+bool time_getUtcDateTime(char *dateTime);
+
+
+/**
+ *	@brief Convert a BGx quoted date/time ("[YY]YY/MM/DD,hh:mm:ss[±zz]", UTC) to seconds since 1970.
+ *  @param [in] dateTime Text containing the quoted date/time, parsing starts at the first double-quote.
+ *  @return UTC seconds since 1970, 0 if the text is not a valid date/time.
+ */
+uint32_t time_parseDateTime(const char *dateTime);
+
+
+/**
+ *	@brief Convert UTC calendar date/time to seconds since 1970.
+ *  @param [in] year Full year (ex: 2023).
+ *  @return UTC seconds since 1970.
+ */
+uint32_t time_toEpoch(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second);
+
+
+/**
+ *	@brief Get the current UTC time, interpolated from the last sync with host ticks. No AT command is sent.
+ *  @return UTC seconds since 1970, 0 if time service not synchronized.
+ */
+uint32_t ltem_getUtc();
+
+
+#pragma region LTEmC Internal
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ *	@brief Time service background work (scheduled/cell change resync), invoked from ltem_eventMgr().
+ */
+void TIME_doWork();
+
+/**
+ *	@brief Set the BGx RTC from the host clock once per BGx start (TLS certificate expiration), no-op if set or host time not synchronized.
+ */
+void TIME_syncModuleClock();
+
+#pragma endregion
+
+
+#ifdef __cplusplus
+}
+#endif // !__cplusplus
+
+#endif  // !__LTEMC_TIME_H__
@@ -42,52 +42,321 @@
 #include "ltemc-internal.h"
 #include "ltemc-tls.h"
 #include "ltemc-atcmd.h"
+#if LTEMC_ENABLE_TIME
+#include "ltemc-time.h"
+#endif
+
+#if LTEMC_ENABLE_TLS                            // module selection, see ltemc-config.h
+
+
+/* Settings each BGx SSL/TLS context currently holds, as applied by this module. Certificate paths are remembered as hashes.
+ * A context record is current only for the BGx start it was applied in, BGx does not retain QSSLCFG settings over a restart.
+ */
+typedef struct tlsCntxtCache_tag
+{
+    bool valid;
+    uint32_t startedAt;                         /// startCtrl.startedAt of the BGx start the settings were applied in
+    tlsVersion_t version;
+    tlsCipher_t cipher;
+    tlsCertExpiration_t certExpCheck;
+    tlsSecurityLevel_t securityLevel;
+    bool sni;
+    bool sessionCache;
+    uint32_t caCertHash;
+    uint32_t clientCertHash;
+    uint32_t clientKeyHash;
+} tlsCntxtCache_t;
+
+static tlsCntxtCache_t S__tlsCache[tls__cntxtCnt];
+
+
+/* Handshake statistics per context, reset at BGx start (sessions are not retained over a restart)
+ */
+typedef struct tlsHandshakeCtrl_tag
+{
+    uint32_t startedAt;                         /// startCtrl.startedAt of the BGx start the statistics apply to
+    uint32_t hostHash;                          /// host of the last successful handshake
+    tlsHandshakeInfo_t info;
+} tlsHandshakeCtrl_t;
+
+static tlsHandshakeCtrl_t S__tlsHandshakes[tls__cntxtCnt];
+
+// private local declarations
+static bool S__isCacheCurrent(uint8_t dataCntxt);
+static uint32_t S__pathHash(const char *path);
+static resultCode_t S__applySetting(const char *cmdTemplate, uint8_t dataCntxt, uint32_t value);
+static resultCode_t S__applyPath(const char *setting, uint8_t dataCntxt, const char *path);
+static cmdParseRslt_t S__qsslcfgParser();
 
 
+/* public functions
+ * --------------------------------------------------------------------------------------------- */
+#pragma region public functions
+
 bool tls_configure(uint8_t dataCntxt, tlsVersion_t version, tlsCipher_t cipherSuite, tlsCertExpiration_t certExpirationCheck, tlsSecurityLevel_t securityLevel)
 {
-    if (atcmd_tryInvoke("AT+QSSLCFG=\"sslversion\",%d,%d", dataCntxt, version))                   // set SSL/TLS version
+    tlsProfile_t profile;
+    tls_initProfile(&profile);
+    if (S__isCacheCurrent(dataCntxt))                                                           // keep settings not set by this call
     {
-        if (atcmd_awaitResult() != resultCode__success)                                         // return on failure, continue on success
-            return false;
+        profile.sni = S__tlsCache[dataCntxt].sni;
+        profile.sessionCache = S__tlsCache[dataCntxt].sessionCache;
     }
+    profile.version = version;
+    profile.cipher = cipherSuite;
+    profile.certExpCheck = certExpirationCheck;
+    profile.securityLevel = securityLevel;
 
+    return tls_applyProfile(dataCntxt, &profile) == resultCode__success;
+}
 
-    if (atcmd_tryInvoke("AT+QSSLCFG=\"ciphersuite\",%d,0X%X", dataCntxt, cipherSuite))            // set cipher suite
-    {
-        if (atcmd_awaitResult() != resultCode__success)                                         // return on failure, continue on success
-            return false;
-    }
 
-    if (atcmd_tryInvoke("AT+QSSLCFG=\"ignorelocaltime\",%d,%d", dataCntxt, certExpirationCheck))  // set certificate expiration check
+void tls_initProfile(tlsProfile_t *profile)
+{
+    memset(profile, 0, sizeof(tlsProfile_t));
+    profile->version = tlsVersion_default;
+    profile->cipher = tlsCipher_default;
+    profile->certExpCheck = tlsCertExpiration_default;
+    profile->securityLevel = tlsSecurityLevel_default;
+}
+
+
+resultCode_t tls_applyProfile(uint8_t dataCntxt, const tlsProfile_t *profile)
+{
+    ASSERT(dataCntxt < tls__cntxtCnt);
+
+    #if LTEMC_ENABLE_TIME
+    if (profile->certExpCheck == tlsCertExpiration_check)
+        TIME_syncModuleClock();                                                                 // expiration is checked against BGx RTC
+    #endif
+
+    tlsCntxtCache_t *cache = &S__tlsCache[dataCntxt];
+    bool isCurrent = S__isCacheCurrent(dataCntxt);
+    if (!isCurrent)
     {
-        if (atcmd_awaitResult() != resultCode__success)                                         // return on failure, continue on success
-            return false;
+        memset(cache, 0, sizeof(tlsCntxtCache_t));                                              // BGx holds defaults or unknown settings
+        cache->startedAt = g_lqLTEM.startCtrl.startedAt;
     }
 
-    if (atcmd_tryInvoke("AT+QSSLCFG=\"seclevel\",%d,%d", dataCntxt, securityLevel))               // set security level, aka what is checked
+    uint32_t caCertHash = S__pathHash(profile->caCertPath);
+    uint32_t clientCertHash = S__pathHash(profile->clientCertPath);
+    uint32_t clientKeyHash = S__pathHash(profile->clientKeyPath);
+
+    bool applyVersion = !isCurrent || cache->version != profile->version;
+    bool applyCipher = !isCurrent || cache->cipher != profile->cipher;
+    bool applyCertExp = !isCurrent || cache->certExpCheck != profile->certExpCheck;
+    bool applySecLevel = !isCurrent || cache->securityLevel != profile->securityLevel;
+    bool applySni = cache->sni != profile->sni;                                                 // cleared cache = BGx default (off)
+    bool sessionCache = profile->sessionCache && QBG_hasFeature(moduleFeature_tlsSessionCache);
+    ASSERT_W(sessionCache == profile->sessionCache, "TLS session cache unsupported");
+    bool applySession = cache->sessionCache != sessionCache;
+    bool applyCaCert = caCertHash != 0 && cache->caCertHash != caCertHash;                      // empty path = leave unchanged
+    bool applyClientCert = clientCertHash != 0 && cache->clientCertHash != clientCertHash;
+    bool applyClientKey = clientKeyHash != 0 && cache->clientKeyHash != clientKeyHash;
+
+    if (!(applyVersion || applyCipher || applyCertExp || applySecLevel || applySni || applySession || applyCaCert || applyClientCert || applyClientKey))
     {
-        if (atcmd_awaitResult() != resultCode__success)                                         // return on failure, continue on success
-            return false;
+        cache->valid = true;
+        return resultCode__success;                                                             // context already holds profile, no AT traffic
     }
 
-    return true;
+    if (!ATCMD_awaitLock(atcmd__defaultTimeout))                                                // apply differences as one command sequence
+        return resultCode__conflict;
+
+    resultCode_t rslt = resultCode__success;
+    cache->valid = true;                                                                        // each setting recorded as it is applied
+
+    if (applyVersion && (rslt = S__applySetting("AT+QSSLCFG=\"sslversion\",%d,%d", dataCntxt, profile->version)) == resultCode__success)
+        cache->version = profile->version;
+    if (rslt == resultCode__success && applyCipher && (rslt = S__applySetting("AT+QSSLCFG=\"ciphersuite\",%d,0X%X", dataCntxt, profile->cipher)) == resultCode__success)
+        cache->cipher = profile->cipher;
+    if (rslt == resultCode__success && applyCertExp && (rslt = S__applySetting("AT+QSSLCFG=\"ignorelocaltime\",%d,%d", dataCntxt, profile->certExpCheck)) == resultCode__success)
+        cache->certExpCheck = profile->certExpCheck;
+    if (rslt == resultCode__success && applySecLevel && (rslt = S__applySetting("AT+QSSLCFG=\"seclevel\",%d,%d", dataCntxt, profile->securityLevel)) == resultCode__success)
+        cache->securityLevel = profile->securityLevel;
+    if (rslt == resultCode__success && applySni && (rslt = S__applySetting("AT+QSSLCFG=\"sni\",%d,%d", dataCntxt, profile->sni)) == resultCode__success)
+        cache->sni = profile->sni;
+    if (rslt == resultCode__success && applySession && (rslt = S__applySetting("AT+QSSLCFG=\"session_cache\",%d,%d", dataCntxt, sessionCache)) == resultCode__success)
+        cache->sessionCache = sessionCache;
+    if (rslt == resultCode__success && applyCaCert && (rslt = S__applyPath("cacert", dataCntxt, profile->caCertPath)) == resultCode__success)
+        cache->caCertHash = caCertHash;
+    if (rslt == resultCode__success && applyClientCert && (rslt = S__applyPath("clientcert", dataCntxt, profile->clientCertPath)) == resultCode__success)
+        cache->clientCertHash = clientCertHash;
+    if (rslt == resultCode__success && applyClientKey && (rslt = S__applyPath("clientkey", dataCntxt, profile->clientKeyPath)) == resultCode__success)
+        cache->clientKeyHash = clientKeyHash;
+
+    atcmd_close();
+    if (rslt != resultCode__success && !isCurrent)
+        cache->valid = false;                                                                   // unapplied defaults unknown, full apply next time
+    return rslt;
 }
 
 
+void tls_invalidateProfile(uint8_t dataCntxt)
+{
+    ASSERT(dataCntxt < tls__cntxtCnt);
+    S__tlsCache[dataCntxt].valid = false;
+}
+
+
+tlsHandshakeInfo_t tls_getHandshakeInfo(uint8_t dataCntxt)
+{
+    ASSERT(dataCntxt < tls__cntxtCnt);
+
+    tlsHandshakeInfo_t info = {0};
+    if (S__tlsHandshakes[dataCntxt].startedAt == g_lqLTEM.startCtrl.startedAt)
+        info = S__tlsHandshakes[dataCntxt].info;
+    return info;
+}
+
 
 tlsOptions_t tlsGetOptions(uint8_t dataCntxt)
 {
     tlsOptions_t result = {0};
+    result.version = tlsVersion_none;
+
+    if (!ATCMD_awaitLock(atcmd__defaultTimeout))
+        return result;
+
+    atcmd_invokeReuseLock("AT+QSSLCFG=\"sslversion\",%d", dataCntxt);                          // +QSSLCFG: "sslversion",<ctx>,<version>
+    if (atcmd_awaitResultWithOptions(atcmd__defaultTimeout, S__qsslcfgParser) == resultCode__success)
+        result.version = (tlsVersion_t)atcmd_getValue();
+
+    atcmd_invokeReuseLock("AT+QSSLCFG=\"ciphersuite\",%d", dataCntxt);                         // +QSSLCFG: "ciphersuite",<ctx>,0X0035
+    if (atcmd_awaitResultWithOptions(atcmd__defaultTimeout, S__qsslcfgParser) == resultCode__success)
+        result.cipher = (tlsCipher_t)atcmd_getValue();
 
-    if (atcmd_tryInvoke("AT+QSSLCFG=\"sslversion\",%d", (uint8_t)dataCntxt))    // get SSL\TLS version
-    {   
-        if (atcmd_awaitResult() == resultCode__success)
+    atcmd_invokeReuseLock("AT+QSSLCFG=\"ignorelocaltime\",%d", dataCntxt);
+    if (atcmd_awaitResultWithOptions(atcmd__defaultTimeout, S__qsslcfgParser) == resultCode__success)
+        result.certExpCheck = (tlsCertExpiration_t)atcmd_getValue();
+
+    atcmd_invokeReuseLock("AT+QSSLCFG=\"seclevel\",%d", dataCntxt);
+    if (atcmd_awaitResultWithOptions(atcmd__defaultTimeout, S__qsslcfgParser) == resultCode__success)
+        result.securityLevel = (tlsSecurityLevel_t)atcmd_getValue();
+
+    atcmd_invokeReuseLock("AT+QSSLCFG=\"cacert\",%d", dataCntxt);                              // +QSSLCFG: "cacert",<ctx>,"<path>"
+    if (atcmd_awaitResultWithOptions(atcmd__defaultTimeout, S__qsslcfgParser) == resultCode__success)
+    {
+        char *pathPtr = strchr(atcmd_getResponse(), '"');                                       // past "cacert" setting name
+        pathPtr = pathPtr ? strchr(pathPtr + 1, '"') : NULL;
+        pathPtr = pathPtr ? strchr(pathPtr + 1, '"') : NULL;                                    // open quote of path, if path set
+        if (pathPtr)
         {
-            PRINTF(0, "%s", atcmd_getLastResponse());
-            // strncpy(result.version, atResult.response);
+            pathPtr++;
+            for (size_t i = 0; i < sizeof(result.trCertPath) - 1 && pathPtr[i] != '"' && pathPtr[i] != '\0'; i++)
+                result.trCertPath[i] = pathPtr[i];
         }
-        atcmd_close();
     }
+    atcmd_close();
+
+    PRINTF(dbgColor__none, "tlsOptions(%d): ver=%d, cipher=%X, expChk=%d, secLvl=%d, ca=%s\r", dataCntxt, result.version, result.cipher, result.certExpCheck, result.securityLevel, result.trCertPath);
     return result;
-}
\ No newline at end of file
+}
+
+#pragma endregion
+
+
+/* LTEmC internal functions
+ * --------------------------------------------------------------------------------------------- */
+#pragma region LTEmC internal functions
+
+/**
+ *	@brief Record a successful TLS open for handshake reporting.
+ */
+void TLS_recordHandshake(uint8_t dataCntxt, const char *host, uint32_t duration)
+{
+    ASSERT(dataCntxt < tls__cntxtCnt);
+
+    tlsHandshakeCtrl_t *handshake = &S__tlsHandshakes[dataCntxt];
+    if (handshake->startedAt != g_lqLTEM.startCtrl.startedAt)                                   // BGx restarted, no sessions to resume
+    {
+        memset(handshake, 0, sizeof(tlsHandshakeCtrl_t));
+        handshake->startedAt = g_lqLTEM.startCtrl.startedAt;
+    }
+
+    uint32_t hostHash = S__pathHash(host);
+    bool resumable = S__isCacheCurrent(dataCntxt) && S__tlsCache[dataCntxt].sessionCache &&
+                     handshake->info.fullCnt > 0 && handshake->hostHash == hostHash;
+
+    if (resumable && duration * 100 < handshake->info.fullDuration * tls__resumedPercent)
+    {
+        handshake->info.lastType = tlsHandshake_resumed;
+        handshake->info.resumedCnt++;
+    }
+    else
+    {
+        handshake->info.lastType = tlsHandshake_full;
+        handshake->info.fullDuration = duration;
+        handshake->info.fullCnt++;
+    }
+    handshake->info.lastDuration = duration;
+    handshake->hostHash = hostHash;
+
+    PRINTF(dbgColor__info, "TLS(%d) %s handshake %lums\r", dataCntxt, handshake->info.lastType == tlsHandshake_resumed ? "resumed" : "full", duration);
+}
+
+#pragma endregion
+
+
+/* private (static) functions
+ * --------------------------------------------------------------------------------------------- */
+#pragma region private functions
+
+/**
+ *	@brief Test if the remembered settings for a context apply to the current BGx start.
+ */
+static bool S__isCacheCurrent(uint8_t dataCntxt)
+{
+    return S__tlsCache[dataCntxt].valid && S__tlsCache[dataCntxt].startedAt == g_lqLTEM.startCtrl.startedAt;
+}
+
+
+/**
+ *	@brief FNV-1a hash of a certificate path (or host name), 0 reserved for empty path.
+ */
+static uint32_t S__pathHash(const char *path)
+{
+    if (path[0] == '\0')
+        return 0;
+
+    uint32_t hash = 2166136261U;
+    for (size_t i = 0; path[i] != '\0'; i++)
+    {
+        hash ^= (uint8_t)path[i];
+        hash *= 16777619U;
+    }
+    return hash ? hash : 1;
+}
+
+
+/**
+ *	@brief Send one numeric QSSLCFG setting within the apply sequence (lock held).
+ */
+static resultCode_t S__applySetting(const char *cmdTemplate, uint8_t dataCntxt, uint32_t value)
+{
+    atcmd_invokeReuseLock(cmdTemplate, dataCntxt, value);
+    return atcmd_awaitResult();
+}
+
+
+/**
+ *	@brief Send one certificate path QSSLCFG setting within the apply sequence (lock held).
+ */
+static resultCode_t S__applyPath(const char *setting, uint8_t dataCntxt, const char *path)
+{
+    atcmd_invokeReuseLock("AT+QSSLCFG=\"%s\",%d,\"%s\"", setting, dataCntxt, path);
+    return atcmd_awaitResult();
+}
+
+
+/**
+ *	@brief Parser for a QSSLCFG setting query: +QSSLCFG: "<setting>",<ctx>,<value>
+ */
+static cmdParseRslt_t S__qsslcfgParser()
+{
+    return atcmd_stdResponseParser("+QSSLCFG: ", true, ",", 3, 3, "OK\r\n", 0);
+}
+
+#pragma endregion
+
+#endif  // LTEMC_ENABLE_TLS
@@ -31,6 +31,56 @@
 #include "ltemc-types.h"
 
 
+enum tls__constants
+{
+    tls__cntxtCnt = 6,                          /// BGx SSL/TLS contexts (0-5), mapped 1-to-1 with data contexts
+    tls__certPathSz = 40,                       /// max chars (with \0) in a certificate file path, ex: "UFS:cacert.pem"
+    tls__resumedPercent = 60,                   /// handshake shorter than this percent of the last full handshake is reported resumed
+};
+
+
+/** 
+ *  @brief Type of the last TLS handshake performed on a context
+ */
+typedef enum tlsHandshake_tag
+{
+    tlsHandshake_none = 0,                      /// no handshake since BGx start
+    tlsHandshake_full = 1,                      /// full handshake, certificate exchange
+    tlsHandshake_resumed = 2                    /// abbreviated handshake, cached session resumed
+} tlsHandshake_t;
+
+
+/** 
+ *  @brief TLS handshake statistics for a context, reset at BGx start
+ */
+typedef struct tlsHandshakeInfo_tag
+{
+    tlsHandshake_t lastType;                    /// type of last successful handshake
+    uint32_t lastDuration;                      /// duration of last open (connect + handshake) in mS
+    uint32_t fullDuration;                      /// duration of last full handshake open in mS
+    uint16_t fullCnt;                           /// count of full handshakes
+    uint16_t resumedCnt;                        /// count of resumed handshakes
+} tlsHandshakeInfo_t;
+
+
+/** 
+ *  @brief TLS profile, the complete set of SSL/TLS settings for a context applied with tls_applyProfile()
+ *  @details Certificate paths left empty are not applied (BGx setting left unchanged). SNI and session cache are off in BGx by default. 
+ */
+typedef struct tlsProfile_tag
+{
+    tlsVersion_t version;                       /// SSL/TLS version
+    tlsCipher_t cipher;                         /// cipher suite
+    tlsCertExpiration_t certExpCheck;           /// certificate expiration check
+    tlsSecurityLevel_t securityLevel;           /// authentication mode
+    bool sni;                                   /// send server name indication (host name) in client hello
+    bool sessionCache;                          /// enable session resumption for the context (moduleFeature_tlsSessionCache)
+    char caCertPath[tls__certPathSz];           /// trusted CA certificate file, required for server authentication
+    char clientCertPath[tls__certPathSz];       /// client certificate file, required for server/client authentication
+    char clientKeyPath[tls__certPathSz];        /// client private key file, required for server/client authentication
+} tlsProfile_t;
+
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -41,17 +91,52 @@ extern "C"
 /** 
  *  @brief Configure the TLS/SSL settings for a context
  *  @details The TLS/SSL context is loosely associated with the protocol context. This package maintains a 1-to-1 map for consistency.
+ *           Settings are applied as a change to the context's current profile, see tls_applyProfile().
  *  @param contxt [in] TLS/SSL context to configure
  *  @param version [in] TLS/SSL version: 0=SSL-3.0, 1=TLS-1.0, 2=TLS-1.1, 3=TLS-1.2, 4=ALL
  *  @param cipherSuite [in] Cipher suite to use for processing of crypto
- *  @param certExpirationCheck [in] Options for how the certificate's expiration information is processed
+ *  @param certExpirationCheck [in] Options for how the certificate's expiration information is processed, check sets the BGx RTC from the time service (once per BGx start)
  *  @param securityLevel [in] Authentication mode: 0=no auth, 1=server auth, 2=server/client auth
  */
 bool tls_configure(uint8_t sckt, tlsVersion_t version, tlsCipher_t cipherSuite, tlsCertExpiration_t certExpirationCheck, tlsSecurityLevel_t securityLevel);
 
 
 /** 
- *  @brief Configure the TLS/SSL settings for a context
+ *  @brief Initialize a TLS profile with the BGx default settings.
+ *  @param profile [out] TLS profile to initialize
+ */
+void tls_initProfile(tlsProfile_t *profile);
+
+
+/** 
+ *  @brief Apply a TLS profile to a context, only settings that differ from those the context currently holds are sent to BGx
+ *  @details Applied settings are remembered per context until BGx is restarted; re-applying an unchanged profile (reconnects) issues no AT commands.
+ *  @param dataCntxt [in] TLS/SSL context to configure
+ *  @param profile [in] TLS profile to apply
+ *  @return resultCode__success if context holds the profile, otherwise the result of the failed setting
+ */
+resultCode_t tls_applyProfile(uint8_t dataCntxt, const tlsProfile_t *profile);
+
+
+/** 
+ *  @brief Forget the settings remembered for a context, the next tls_applyProfile() applies the full profile
+ *  @param dataCntxt [in] TLS/SSL context to invalidate
+ */
+void tls_invalidateProfile(uint8_t dataCntxt);
+
+
+/** 
+ *  @brief Get the TLS handshake statistics for a context, reports if the last handshake was full or resumed and its duration
+ *  @details BGx does not report session reuse, a handshake is reported resumed when session cache is enabled, the host is unchanged
+ *           and the open completes in less than tls__resumedPercent of the last full handshake.
+ *  @param dataCntxt [in] TLS/SSL context
+ *  @return Handshake statistics since BGx start
+ */
+tlsHandshakeInfo_t tls_getHandshakeInfo(uint8_t dataCntxt);
+
+
+/** 
+ *  @brief Read the TLS/SSL settings for a context back from BGx
  *  @details The TLS/SSL context is loosely associated with the protocol context. This package maintains a 1-to-1 map for consistency.
  *  @param contxt [in] TLS/SSL context to configure
  *  @return TLS options structure with the settings currently applied to the specified context
@@ -0,0 +1,261 @@
+/** ****************************************************************************
+  \file 
+  \brief Public API location track batching: point decimation and compact delta/varint encoding for upload
+  \author Greg Terrell, LooUQ Incorporated
+
+  \loouq
+
+--------------------------------------------------------------------------------
+
+    This project is released under the GPL-3.0 License.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ 
+***************************************************************************** */
+
+
+#define _DEBUG 0                                // set to non-zero value for PRINTF debugging output, 
+// debugging output options                     // LTEm1c will satisfy PRINTF references with empty definition if not already resolved
+#if _DEBUG > 0
+    asm(".global _printf_float");               // forces build to link in float support for printf
+    #if _DEBUG == 1
+    #define SERIAL_DBG 1                        // enable serial port output using devl host platform serial, 1=wait for port
+    #elif _DEBUG == 2
+    #include <jlinkRtt.h>                       // output debug PRINTF macros to J-Link RTT channel
+    #define PRINTF(c_,f_,__VA_ARGS__...) do { rtt_printf(c_, (f_), ## __VA_ARGS__); } while(0)
+    #endif
+#else
+#define PRINTF(c_, f_, ...) 
+#endif
+
+#define SRCFILE "TRK"                           // create SRCFILE (3 char) MACRO for lq-diagnostics ASSERT
+#include "ltemc-internal.h"
+#include "ltemc-track.h"
+
+#if LTEMC_ENABLE_TRACK                          // module selection, see ltemc-config.h
+
+#define MIN(x, y) (((x) < (y)) ? (x) : (y))
+
+
+// private local declarations
+static bool S__isKept(trackCtrl_t *track, const trackPoint_t *point);
+static uint8_t S__putVarint(uint8_t *bffr, uint32_t value);
+static uint32_t S__zigzag(int32_t value);
+
+
+/* Batch encoding (version 1)
+ *  version(1 byte) count(varint)
+ *  point[0]: time, zz(lat), zz(lon), zz(alt), speed, course                     (absolute, varints)
+ *  point[n]: zz(dTime), zz(dLat), zz(dLon), zz(dAlt), zz(dSpeed), zz(dCourse)    (deltas from point[n-1], course delta +/-18000)
+ *  zz() = zigzag signed to unsigned, varint = LEB128 (7 bits/byte, MSB continuation)
+ * --------------------------------------------------------------------------------------------- */
+
+
+#pragma region public functions
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ *	@brief Initialize a track buffer.
+ */
+void track_init(trackCtrl_t *track, trackPoint_t *points, uint16_t capacity, const trackDecimation_t *decimation)
+{
+    ASSERT(points != NULL && capacity > 0);
+
+    memset(track, 0, sizeof(trackCtrl_t));
+    track->points = points;
+    track->capacity = capacity;
+    if (decimation != NULL)
+        memcpy(&track->decimation, decimation, sizeof(trackDecimation_t));
+}
+
+
+/**
+ *	@brief Offer a GNSS fix to the track, the fix is kept if it passes decimation rules.
+ */
+bool track_addFix(trackCtrl_t *track, const gnssFix_t *fix)
+{
+    track->fixesIn++;
+    if (!fix->valid || fix->date == 0)
+        return false;
+
+    trackPoint_t point;
+    uint32_t secsOfDay = fix->utcMillis / 1000;
+    point.time = time_toEpoch(2000 + fix->date % 100, (fix->date / 100) % 100, fix->date / 10000,   // date is ddmmyy
+                              secsOfDay / 3600, (secsOfDay / 60) % 60, secsOfDay % 60);
+    point.latitude = fix->latitude;
+    point.longitude = fix->longitude;
+    point.altitude = fix->altitude;
+    point.speed = MIN(fix->speed, UINT16_MAX);
+    point.course = fix->course;
+
+    if (!S__isKept(track, &point))
+        return false;
+
+    if (track->count == track->capacity)                                            // full: overwrite oldest
+        track->pointsDropped++;
+    else
+        track->count++;
+
+    memcpy(&track->points[track->head], &point, sizeof(trackPoint_t));
+    track->head = (track->head + 1) % track->capacity;
+    memcpy(&track->lastKept, &point, sizeof(trackPoint_t));
+    track->hasLastKept = true;
+    track->pointsKept++;
+    return true;
+}
+
+
+/**
+ *	@brief Get number of points waiting in the track ring.
+ */
+uint16_t track_getCount(trackCtrl_t *track)
+{
+    return track->count;
+}
+
+
+/**
+ *	@brief Encode oldest points as a compact delta/varint batch.
+ */
+uint16_t track_encode(trackCtrl_t *track, uint8_t *bffr, uint16_t bffrSz, uint16_t *pointCnt)
+{
+    ASSERT(bffrSz >= track__headerMaxSz + track__pointMaxEncodedSz);
+
+    uint8_t pointBffr[track__pointMaxEncodedSz];
+    uint16_t tail = (track->head + track->capacity - track->count) % track->capacity;
+    uint16_t encodedSz = track__headerMaxSz;                                        // header written last, count is not known yet
+    const trackPoint_t *prev = NULL;
+    uint16_t encodedCnt = 0;
+
+    for (; encodedCnt < track->count; encodedCnt++)
+    {
+        const trackPoint_t *point = &track->points[(tail + encodedCnt) % track->capacity];
+        uint8_t pointSz = 0;
+
+        if (prev == NULL)
+        {
+            pointSz += S__putVarint(pointBffr + pointSz, point->time);
+            pointSz += S__putVarint(pointBffr + pointSz, S__zigzag(point->latitude));
+            pointSz += S__putVarint(pointBffr + pointSz, S__zigzag(point->longitude));
+            pointSz += S__putVarint(pointBffr + pointSz, S__zigzag(point->altitude));
+            pointSz += S__putVarint(pointBffr + pointSz, point->speed);
+            pointSz += S__putVarint(pointBffr + pointSz, point->course);
+        }
+        else
+        {
+            int32_t courseDelta = (int32_t)point->course - prev->course;
+            if (courseDelta > 18000)                                                // shortest turn across north
+                courseDelta -= 36000;
+            else if (courseDelta < -18000)
+                courseDelta += 36000;
+
+            pointSz += S__putVarint(pointBffr + pointSz, S__zigzag(point->time - prev->time));
+            pointSz += S__putVarint(pointBffr + pointSz, S__zigzag(point->latitude - prev->latitude));
+            pointSz += S__putVarint(pointBffr + pointSz, S__zigzag(point->longitude - prev->longitude));
+            pointSz += S__putVarint(pointBffr + pointSz, S__zigzag(point->altitude - prev->altitude));
+            pointSz += S__putVarint(pointBffr + pointSz, S__zigzag((int32_t)point->speed - prev->speed));
+            pointSz += S__putVarint(pointBffr + pointSz, S__zigzag(courseDelta));
+        }
+
+        if (encodedSz + pointSz > bffrSz)
+            break;
+        memcpy(bffr + encodedSz, pointBffr, pointSz);
+        encodedSz += pointSz;
+        prev = point;
+    }
+
+    /* header: version + count, then close gap left by reserving the max header size
+     */
+    uint8_t header[track__headerMaxSz];
+    header[0] = track__encodingVersion;
+    uint8_t headerSz = 1 + S__putVarint(header + 1, encodedCnt);
+    memmove(bffr + headerSz, bffr + track__headerMaxSz, encodedSz - track__headerMaxSz);
+    memcpy(bffr, header, headerSz);
+
+    *pointCnt = encodedCnt;
+    return encodedSz - track__headerMaxSz + headerSz;
+}
+
+
+/**
+ *	@brief Remove oldest points from the ring.
+ */
+void track_consume(trackCtrl_t *track, uint16_t pointCnt)
+{
+    track->count -= MIN(pointCnt, track->count);
+}
+
+#pragma endregion
+
+
+#pragma region Static Function Definitions
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ *	@brief Apply decimation rules to a candidate point.
+ */
+static bool S__isKept(trackCtrl_t *track, const trackPoint_t *point)
+{
+    if (!track->hasLastKept)
+        return true;
+
+    const trackDecimation_t *rules = &track->decimation;
+    const trackPoint_t *last = &track->lastKept;
+    uint32_t elapsed = point->time - last->time;
+
+    if (point->time <= last->time || elapsed < rules->minInterval)
+        return false;
+
+    if (rules->maxInterval == 0 && rules->minDistance == 0 && rules->minHeadingChange == 0)
+        return true;                                                                // no rules: keep all (rate capped by minInterval)
+
+    if (rules->maxInterval > 0 && elapsed >= rules->maxInterval)
+        return true;
+
+    if (rules->minDistance > 0 && GNSS_distance(last->latitude, last->longitude, point->latitude, point->longitude) >= rules->minDistance)
+        return true;
+
+    if (rules->minHeadingChange > 0 && point->speed >= track__stationarySpeed)
+    {
+        int32_t turn = abs((int32_t)point->course - last->course);
+        if (turn > 18000)
+            turn = 36000 - turn;
+        if (turn >= rules->minHeadingChange)
+            return true;
+    }
+    return false;
+}
+
+
+static uint8_t S__putVarint(uint8_t *bffr, uint32_t value)
+{
+    uint8_t sz = 0;
+    while (value >= 0x80)
+    {
+        bffr[sz++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    bffr[sz++] = (uint8_t)value;
+    return sz;
+}
+
+
+static uint32_t S__zigzag(int32_t value)
+{
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+#pragma endregion
+
+#endif  // LTEMC_ENABLE_TRACK
@@ -0,0 +1,136 @@
+/** ****************************************************************************
+  \file 
+  \brief Public API location track batching: point decimation and compact delta/varint encoding for upload
+  \author Greg Terrell, LooUQ Incorporated
+
+  \loouq
+
+--------------------------------------------------------------------------------
+
+    This project is released under the GPL-3.0 License.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ 
+***************************************************************************** */
+
+
+#ifndef __LTEMC_TRACK_H__
+#define __LTEMC_TRACK_H__
+
+#include "ltemc-gnss.h"
+
+
+enum track__constants
+{
+    track__encodingVersion = 1,
+    track__pointMaxEncodedSz = 30,                  ///< worst case encoded point: 6 varints (5 x 5 bytes + course 3 bytes)
+    track__headerMaxSz = 4,                         ///< version + point count varint
+    track__stationarySpeed = 100                    ///< below this speed (cm/s) heading changes are not used for decimation (noise)
+};
+
+
+/** 
+ *  \brief Compact track point, fixed-point.
+*/
+typedef struct trackPoint_tag
+{
+    uint32_t time;                  ///< UTC seconds since 1970
+    int32_t latitude;               ///< microdegrees
+    int32_t longitude;              ///< microdegrees
+    int32_t altitude;               ///< decimetres
+    uint16_t speed;                 ///< cm/s (saturated at 65535)
+    uint16_t course;                ///< centidegrees
+} trackPoint_t;
+
+
+/** 
+ *  \brief Point decimation rules. A fix is kept if minInterval has elapsed AND any of the distance, heading or 
+ *  maxInterval rules is met (a zero value disables that rule).
+*/
+typedef struct trackDecimation_tag
+{
+    uint16_t minInterval;           ///< min seconds between kept points
+    uint16_t maxInterval;           ///< keep a point at least this often (seconds), heartbeat while stationary
+    uint16_t minDistance;           ///< keep if moved at least this distance (metres) from last kept point
+    uint16_t minHeadingChange;      ///< keep if course changed at least this much (centidegrees) while moving
+} trackDecimation_t;
+
+
+/** 
+ *  \brief Track ring buffer, storage is provided by the application.
+*/
+typedef struct trackCtrl_tag
+{
+    trackPoint_t *points;           ///< application provided point storage
+    uint16_t capacity;              ///< number of points in storage
+    uint16_t head;                  ///< next write position
+    uint16_t count;                 ///< points in the ring
+    trackDecimation_t decimation;
+    trackPoint_t lastKept;          ///< last point kept (decimation reference), survives ring consume
+    bool hasLastKept;
+    uint32_t fixesIn;               ///< fixes offered to track_addFix()
+    uint32_t pointsKept;            ///< fixes kept after decimation
+    uint32_t pointsDropped;         ///< oldest points overwritten on ring overflow
+} trackCtrl_t;
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *	@brief Initialize a track buffer.
+ *  @param [in] track Track control, allocated by the application.
+ *  @param [in] points Point storage, allocated by the application.
+ *  @param [in] capacity Number of points in storage.
+ *  @param [in] decimation Decimation rules (copied), NULL keeps every fix.
+ */
+void track_init(trackCtrl_t *track, trackPoint_t *points, uint16_t capacity, const trackDecimation_t *decimation);
+
+/**
+ *	@brief Offer a GNSS fix to the track, the fix is kept if it passes decimation rules.
+ *  @details Can be called from a gnss_startStream() fix callback or after gnss_getLocationFix().
+ *  @param [in] track Track control.
+ *  @param [in] fix GNSS fix, invalid fixes (or fixes without a date) are ignored.
+ *  @return True if the fix was kept.
+ */
+bool track_addFix(trackCtrl_t *track, const gnssFix_t *fix);
+
+/**
+ *	@brief Get number of points waiting in the track ring.
+ */
+uint16_t track_getCount(trackCtrl_t *track);
+
+/**
+ *	@brief Encode oldest points as a batch: version, count, first point absolute, remaining points as zigzag varint deltas.
+ *  @details Points are not removed, call track_consume() with the encoded count after the batch is sent.
+ *  @param [in] track Track control.
+ *  @param [out] bffr Buffer to receive the encoded batch, ready for mqtt_publish()/sckt_send().
+ *  @param [in] bffrSz Size of the buffer, encoding stops at the last point that fits.
+ *  @param [out] pointCnt Number of points encoded.
+ *  @return Number of bytes encoded.
+ */
+uint16_t track_encode(trackCtrl_t *track, uint8_t *bffr, uint16_t bffrSz, uint16_t *pointCnt);
+
+/**
+ *	@brief Remove oldest points from the ring, typically the point count of a successfully sent batch.
+ */
+void track_consume(trackCtrl_t *track, uint16_t pointCnt);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // !__LTEMC_TRACK_H__
@@ -40,18 +40,29 @@
 
 #include <lq-types.h>
 #include <lq-cBuffer.h>
+#include "ltemc-config.h"
 
 enum ltem__constants
 {
-    ltem__bufferSz_rx = 2000,
-    ltem__bufferSz_tx = 1000,
+    ltem__bufferSz_rx = LTEMC_RX_BUFFER_SZ,
+    ltem__bufferSz_tx = LTEMC_TX_BUFFER_SZ,
 
     ltem__swVerSz = 12,
     ltem__errorDetailSz = 18,
     ltem__moduleTypeSz = 8,
 
-    ltem__streamCnt = 4,            /// 6 SSL/TLS capable data contexts + file system allowable, 4 concurrent seams reasonable
-    //ltem__urcHandlersCnt = 4        /// max number of concurrent protocol URC handlers (today only http, mqtt, sockets, filesystem)
+    ltem__streamCnt = LTEMC_STREAM_CNT,             /// 6 SSL/TLS capable data contexts + file system allowable, 4 concurrent seams reasonable
+    ltem__doWorkerCnt = LTEMC_DOWORKER_CNT,         /// max number of optional module background workers serviced by ltem_eventMgr()
+    ltem__urcHandlersCnt = LTEMC_URCHANDLER_CNT,    /// max number of optional module (non-stream) URC handlers serviced by ltem_eventMgr()
+
+    ltem__startPowerTimeout = 6000,         /// max wait for status pin to follow a power/reset action (mS)
+    ltem__startAppRdyTimeout = 15000,       /// max wait for BGx "APP RDY" after power on (mS), typical 700-1450 mS
+    ltem__startProviderWarmup = 2000,       /// brief provider warm-up at start, longer waits are left to the application (mS)
+    ltem__startProviderPoll = 1000,         /// interval between provider checks during warm-up (mS)
+    ltem__startInitCmdTimeout = 2000,       /// result timeout for BGx start script commands, somewhat unknown cmd list, relaxed (mS)
+    ltem__startNtwkInfoTimeout = 20000,     /// result timeout for PDP context query (AT+CGACT?) at start (mS)
+    ltem__startCmdBffrSz = 80,              /// start sequence command build buffer size
+    ltem__appEventStartReady = 1,           /// application notify type for start complete (informational, below appEvent__WARNINGS)
 };
 
 
@@ -64,7 +75,7 @@ enum streams__constants
     streams__maxContextProtocols = 5,
     streams__typeCodeSz = 4,
     streams__urcPrefixesSz = 60,
-    host__urlSz = 100
+    host__urlSz = LTEMC_HOST_URL_SZ
 };
 
 
@@ -92,6 +103,34 @@ typedef enum deviceState_tag
 } deviceState_t;
 
 
+/**
+ *  \brief Enum describing the progress of the (non-blocking) LTEm start sequence, advanced by ltem_eventMgr()
+ */
+typedef enum startState_tag
+{
+    startState_idle = 0,             /// no start sequence underway
+    startState_powerKeyOn,           /// powerkey pulse underway to turn BGx ON
+    startState_awaitPowerOn,         /// waiting for BGx status pin to signal power ON
+    startState_powerKeyOff,          /// powerkey pulse underway to turn BGx OFF (power-cycle reset)
+    startState_awaitPowerOff,        /// waiting for BGx status pin to signal power OFF (sw reset or power-cycle reset)
+    startState_resetPulse,           /// reset pin pulse underway (hw reset)
+    startState_awaitAppReady,        /// SPI-UART bridge started, IRQ attached, watching RX stream for "APP RDY"
+    startState_setOptions,           /// applying BGx operating options (start script)
+    startState_networkConfig,        /// applying RAT options and default PDP context
+    startState_awaitProvider,        /// brief provider/PDP warm-up
+    startState_ready,                /// start complete, device is appReady
+    startState_failed                /// start sequence abandoned
+} startState_t;
+
+
+/**
+ *  \brief Callback function for LTEm start sequence progress. Invoked on each state change, startState_ready signals start complete.
+ *  \param [in] startState The state the start sequence has entered.
+ *  \param [in] elapsedMs Milliseconds since the start sequence began.
+ */
+typedef void (*startProgress_func)(startState_t startState, uint32_t elapsedMs);
+
+
 /** 
  *  @brief Enum of the available dataCntxt indexes for BGx (only SSL/TLS capable contexts are supported).
  */
@@ -267,10 +306,35 @@ enum IOP__Constants
     IOP__uartFIFOFillPeriod = (int)(1 / (double)IOP__uartBaudRate * 10 * IOP__uartFIFOBufferSz * 1000) + 1,
 
     IOP__rxDefaultTimeout = IOP__uartFIFOFillPeriod * 2,
-    IOP__urcDetectBufferSz = 40
+    IOP__urcDetectBufferSz = 40,
+
+    IOP__rxLeaseCnt = LTEMC_RX_LEASE_CNT,                   // concurrent RX leases
+    IOP__rxLeaseHeadroom = IOP__uartFIFOBufferSz * 2        // min RX vacancy (net of leases) to start a solicited read (IRD, QFREAD)
 };
 
 
+/** 
+ *  @brief Application held (leased) region of the RX buffer, zero-copy access to received data beyond the receive callback.
+ *  @details Obtained with iop_leaseRxBlock() from within a stream receive callback, valid until release is invoked.
+ */
+typedef struct iop_rxLease_tag
+{
+    const char *data;                                       /// leased data, in place in the RX buffer
+    uint16_t dataSz;                                        /// leased data length
+    void (*release)(struct iop_rxLease_tag *lease);         /// return region to the RX buffer, lease is cleared (safe to repeat)
+    uint8_t slot;                                           /// IOP lease slot (internal)
+} iop_rxLease_t;
+
+
+typedef struct iopRxLeaseSlot_tag
+{
+    const char * volatile data;
+    volatile uint16_t dataSz;
+    volatile bool active;
+    volatile bool overrun;                                  /// region overwritten by RX before release (unsolicited receive exceeded vacancy)
+} iopRxLeaseSlot_t;
+
+
 /** 
  *  @brief Streams 
  *  @details Structures for stream control/processing
@@ -294,6 +358,7 @@ typedef enum streamType_tag
 typedef resultCode_t (*urcEvntHndlr_func)();        // data comes from rxBuffer, this function parses and forwards to application via appRcvProto_func
 typedef resultCode_t (*dataRxHndlr_func)();         // data comes from rxBuffer, this function parses and forwards to application via appRcvProto_func
 typedef void (*appRcvProto_func)();                 // prototype func() for stream recvData callback
+typedef resultCode_t (*recoverHndlr_func)(void *streamCtrl);   // reopens stream following BGx restart (health monitor recovery)
 
 
 typedef struct streamCtrl_tag
@@ -302,6 +367,7 @@ typedef struct streamCtrl_tag
     dataCntxt_t dataCntxt;                          /// integer representing the source of the stream; fixed for protocols, file handle for FS
     dataRxHndlr_func dataRxHndlr;                   /// function to handle data streaming, initiated by eventMgr() or atcmd module
     urcEvntHndlr_func urcHndlr;                     /// function to handle data streaming, initiated by eventMgr() or atcmd module
+    recoverHndlr_func recoverHndlr;                 /// function to reopen stream following BGx restart, NULL if stream is not reopened
 } streamCtrl_t;
 
 
@@ -325,6 +391,12 @@ typedef struct iop_tag
  
     volatile uint32_t lastTxAt;             /// tick count when TX send started, used for response timeout detection
     volatile uint32_t lastRxAt;             /// tick count when RX buffer fill level was known to have change
+
+    char *rxBffrStart;                      /// RX buffer raw storage, lease positions are relative to it
+    const char * volatile rxHead;           /// next RX write position (ISR maintained), NULL until first receive after reset
+    iopRxLeaseSlot_t rxLeases[IOP__rxLeaseCnt];     /// RX regions held by application beyond the receive callback
+    volatile uint16_t rxLeasedSz;           /// bytes held by leases, 0 lets ISR skip overrun checks
+    uint32_t rxLeaseOverruns;               /// leased regions overwritten by RX before release
 } iop_t;
 
 
@@ -342,13 +414,159 @@ enum atcmd__constants
     atcmd__setLockModeManual = 0,
     atcmd__setLockModeAuto = 1,
 
-    atcmd__cmdBufferSz = 448,                       // prev=120, mqtt(Azure) connect=384, new=512 for universal cmd coverage, data mode to us dynamic TX bffr switching
-    atcmd__respBufferSz = 120,
+    atcmd__cmdBufferSz = LTEMC_CMD_BUFFER_SZ,       // prev=120, mqtt(Azure) connect=384, new=512 for universal cmd coverage, data mode to us dynamic TX bffr switching
+    atcmd__respBufferSz = LTEMC_RESP_BUFFER_SZ,
     atcmd__streamPrefixSz = 12,                     // obsolete with universal data mode switch
-    atcmd__dataModeTriggerSz = 13
+    atcmd__dataModeTriggerSz = 13,
+    atcmd__fmtArgsMax = 6,                          // max typed argument slots in a fixed command format
+    atcmd__lineBufferSz = 128,                      // line mode delivery buffer (stack), longer lines are delivered in segments
+    atcmd__cacheCnt = LTEMC_ATCMD_CACHE_CNT,        // command result cache entries
+    atcmd__cacheCmdSz = 40,                         // cached command string (with \r\0), longer commands are not cached
+    atcmd__lockWaitersMax = LTEMC_ATCMD_LOCK_WAITERS,   // lock arbiter queue slots
+    atcmd__lockHoldBudget = LTEMC_ATCMD_LOCK_BUDGET,    // default lock hold budget (mS)
+    atcmd__lockWaiterStale = 50,                    // waiter not polling for this (mS) is suspended (cooperative nesting), not waited on
+    atcmd__lockHolderSz = 16                        // lock holder name retained for contention metrics
 };
 
 
+/** 
+ *  \brief AT channel lock priority classes. Waiters are granted the lock highest class first, FIFO within a class.
+*/
+typedef enum atcmdPriority_tag
+{
+    atcmdPriority_bulk = 0,                         /// long multi-step or data transfer sequences (HTTP, file)
+    atcmdPriority_normal = 1,                       /// default
+    atcmdPriority_control = 2,                      /// latency sensitive control-plane commands (MQTT)
+    atcmdPriority__cnt
+} atcmdPriority_t;
+
+
+/** 
+ *  \brief AT channel lock contention metrics.
+*/
+typedef struct atcmdLockStats_tag
+{
+    uint32_t acquired[atcmdPriority__cnt];              /// lock grants by priority class
+    uint32_t timeouts[atcmdPriority__cnt];              /// waits that timed out without lock
+    uint32_t waitTotal[atcmdPriority__cnt];             /// sum of wait time (mS) for grants
+    uint32_t waitMax[atcmdPriority__cnt];               /// longest wait (mS) for a grant
+    uint32_t holdMax;                                   /// longest lock hold (mS)
+    char holdMaxHolder[atcmd__lockHolderSz];            /// holder of the longest hold
+    uint32_t budgetOverruns;                            /// holds released after exceeding hold budget
+    uint32_t yields;                                    /// holder released lock at a yield point to waiter(s)
+} atcmdLockStats_t;
+
+
+typedef struct atcmdLockWaiter_tag
+{
+    bool active;
+    uint8_t priority;
+    uint16_t ticket;                                    /// FIFO order within priority class
+    uint32_t polledAt;                                  /// last poll, a waiter not polling is suspended beneath the current caller
+} atcmdLockWaiter_t;
+
+
+/** 
+ *  \brief AT channel lock arbiter, serializes multi-command sequences and single commands between callers.
+*/
+typedef struct atcmdLockArb_tag
+{
+    atcmdLockWaiter_t waiters[atcmd__lockWaitersMax];   /// queued lock requests
+    uint16_t nextTicket;
+    uint8_t holderPriority;                             /// priority class of current holder
+    char holder[atcmd__lockHolderSz];                   /// current (or last) holder name
+    uint32_t heldAt;                                    /// tick count when lock granted
+    uint32_t holdBudget;                                /// hold time (mS) after which holder yields at yield points, 0 = default
+    atcmdLockStats_t stats;
+} atcmdLockArb_t;
+
+
+/** 
+ *  \brief Events invalidating cached command results (atcmd_configCache()), a BGx restart always invalidates all entries.
+*/
+typedef enum atcmdCacheInval_tag
+{
+    atcmdCacheInval_none = 0x00,                    /// TTL expiry (and BGx restart) only
+    atcmdCacheInval_registration = 0x01,            /// network registration change URC (+CREG/+CGREG/+CEREG), when reporting is enabled (time_enableAutoSync() onCellChange enables +CEREG)
+    atcmdCacheInval_pdpDeact = 0x02,                /// PDP context deactivated URC (+QIURC: "pdpdeact")
+    atcmdCacheInval_all = 0xFF
+} atcmdCacheInval_t;
+
+
+/** 
+ *  \brief Fixed (hot path) AT command formats, emitted by typed argument writers without vsnprintf().
+ *  \details Arguments are passed to atcmd_tryInvokeFmt()/atcmd_invokeFmtReuseLock() in slot order: int for numeric, const char* for strings.
+*/
+typedef enum atcmdFmt_tag
+{
+    atcmdFmt_qisend = 0,                            /// AT+QISEND=<cntxt>,<sendSz>
+    atcmdFmt_qird,                                  /// AT+QIRD=<cntxt>,<readSz>
+    atcmdFmt_qsslrecv,                              /// AT+QSSLRECV=<cntxt>,<readSz>
+    atcmdFmt_qmtpub,                                /// AT+QMTPUB=<cntxt>,<msgId>,<qos>,<retain>,"<topic>",<msgSz>
+    atcmdFmt_qfwrite,                               /// AT+QFWRITE=<handle>,<writeSz>
+    atcmdFmt_qfread,                                /// AT+QFREAD=<handle>,<readSz>
+    atcmdFmt_qfreadAll,                             /// AT+QFREAD=<handle>
+    atcmdFmt_qhttpread,                             /// AT+QHTTPREAD=<timeoutSec>
+    atcmdFmt_qhttpreadfile,                         /// AT+QHTTPREADFILE="<filename>",<timeoutSec>
+
+    atcmdFmt__cnt
+} atcmdFmt_t;
+
+
+/** 
+ *  \brief Argument slot types for fixed AT command formats.
+*/
+typedef enum atcmdArg_tag
+{
+    atcmdArg_none = 0,                              /// end of argument list
+    atcmdArg_int,                                   /// signed decimal integer
+    atcmdArg_str,                                   /// string, emitted as-is
+    atcmdArg_qstr                                   /// string, emitted within double quotes
+} atcmdArg_t;
+
+
+/** 
+ *  \brief Response field types for declarative response extraction (atcmd_parseFields()).
+*/
+typedef enum atcmdFieldType_tag
+{
+    atcmdField_skip = 0,                            /// field is present, not captured
+    atcmdField_int,                                 /// signed decimal integer, stored as int8/16/32 per member size
+    atcmdField_str,                                 /// token text to next delimiter, truncated to member size
+    atcmdField_qstr,                                /// double quoted text (quotes removed, delimiters within quotes retained), unquoted text accepted
+    atcmdField_float                                /// decimal number, stored as float or double per member size
+} atcmdFieldType_t;
+
+
+/** 
+ *  \brief Response field descriptor, describes a comma delimited response token and its destination member in a caller struct.
+ *  \details Use ATCMD_FIELD(type, struct, member) to construct descriptors, ATCMD_FIELD_SKIP for unused tokens.
+*/
+typedef struct atcmdField_tag
+{
+    uint8_t type;                                   /// atcmdFieldType_t
+    uint16_t size;                                  /// destination member size
+    uint16_t offset;                                /// destination member offset in caller struct
+} atcmdField_t;
+
+#define ATCMD_FIELD(fieldType, structType, member) { (fieldType), sizeof(((structType *)0)->member), offsetof(structType, member) }
+#define ATCMD_FIELD_SKIP { atcmdField_skip, 0, 0 }
+
+
+/** 
+ *  \brief Response schema, an ordered list of response fields following an (optional) preamble.
+*/
+typedef struct atcmdSchema_tag
+{
+    const char *preamble;                           /// text preceeding first field, "" = fields start at source
+    const atcmdField_t *fields;                     /// field descriptors, in response order
+    uint8_t fieldCnt;                               /// number of field descriptors
+    uint8_t fieldsReqd;                             /// minimum number of fields present for a successful parse
+} atcmdSchema_t;
+
+#define ATCMD_SCHEMA(preamble, fields, fieldsReqd) { (preamble), (fields), sizeof(fields) / sizeof(atcmdField_t), (fieldsReqd) }
+
+
 /** 
  *  \brief AT command response parser result codes.
 */
@@ -377,6 +595,7 @@ typedef struct dataMode_tag
 
 
 typedef cmdParseRslt_t (*cmdResponseParser_func)();                             // AT response parser template
+typedef void (*atcmdLineRecv_func)(void *lineCntxt, const char *line, uint16_t lineSz, bool isComplete);     // line mode response line receiver
 
 
 /** 
@@ -391,6 +610,7 @@ typedef struct atcmd_tag
 
     uint32_t timeout;                                   /// Timout in milliseconds for the command, defaults to 300mS. BGx documentation indicates cmds with longer timeout.
     bool isOpenLocked;                                  /// True if the command is still open, AT commands are single threaded and this blocks a new cmd initiation.
+    atcmdLockArb_t lockArb;                             /// lock arbitration between callers (priority, FIFO, hold budget) and contention metrics
     bool autoLock;                                      /// last invoke was auto and should be closed automatically on complete
     uint32_t invokedAt;                                 /// Tick value at the command invocation, used for timeout detection.
     
@@ -410,6 +630,15 @@ typedef struct atcmd_tag
     // appRcvProto_func applDataCB;
 
     dataMode_t dataMode;                                /// controls for automatic data mode servicing - both TX (out) and RX (in). Std functions or extensions supported.
+
+    atcmdLineRecv_func lineRecvCB;                      /// line mode: response lines delivered to receiver as received, cleared on command completion
+    void *lineRecvCntxt;                                /// line mode: caller context passed to lineRecvCB
+    bool lineContinued;                                 /// line mode: last delivery was a segment of a long line
+
+    uint32_t cacheTtl;                                  /// result cache: max age (ms) of cached result accepted for the command, 0 = not cached
+    uint8_t cacheInvalOn;                               /// result cache: atcmdCacheInval_t events invalidating a result stored by the command
+    uint32_t cacheKey;                                  /// result cache: command string hash
+    bool cacheHit;                                      /// result cache: command result served from cache, no BGx round-trip
 } atcmd_t;
 
 
@@ -70,7 +70,11 @@ int8_t qbg_initCmdsCnt = sizeof(qbg_initCmds)/sizeof(const char* const);
 
 /* Static Function Declarations
 ------------------------------------------------------------------------------------------------ */
-void S__initLTEmDevice(bool ltemReset);
+static void S__startBegin(resetAction_t resetAction);
+static void S__startDoWork();
+static void S__startSetState(startState_t newState);
+static resultCode_t S__startCmdStep(uint32_t timeoutMS, const char *cmdStr);
+static void S__startAwaitProvider(uint32_t stateElapsed);
 
 
 #pragma region Public Functions
@@ -98,8 +102,10 @@ void ltem_create(const ltemPinConfig_t ltem_config, yield_func yieldCallback, ap
     ASSERT(g_lqLTEM.atcmd != NULL);
     atcmd_reset(true);
 
+    #if LTEMC_ENABLE_FILES
     g_lqLTEM.fileCtrl = calloc(1, sizeof(fileCtrl_t));
     ASSERT(g_lqLTEM.fileCtrl != NULL);
+    #endif
 
     ntwk_create();
 
@@ -193,6 +199,21 @@ void ltem_setDefaultNetwork(uint8_t pdpContextId, const char *protoType, const c
  *	@brief Start the modem.
  */
 void ltem_start(resetAction_t resetAction)
+{
+    ltem_startAsync(resetAction);
+
+    while (g_lqLTEM.startCtrl.state != startState_ready && g_lqLTEM.startCtrl.state != startState_failed)
+    {
+        S__startDoWork();                                                   // blocking start is the async start sequence, driven here
+        pYield();                                                           // give application time for non-comm startup activities or watchdog
+    }
+}
+
+
+/**
+ *	@brief Start the modem without blocking, start sequence is advanced by ltem_eventMgr().
+ */
+void ltem_startAsync(resetAction_t resetAction)
 {
   	// on Arduino compatible, ensure pin is in default "logical" state prior to opening
 	platform_writePin(g_lqLTEM.pinConfig.powerkeyPin, gpioValue_low);
@@ -207,69 +228,27 @@ void ltem_start(resetAction_t resetAction)
 	platform_openPin(g_lqLTEM.pinConfig.irqPin, gpioMode_inputPullUp);
 
     spi_start(g_lqLTEM.spi);                                                // start host SPI
+    QBG_attachStatusMonitor();                                              // status pin edges: power state changes, brownout/restart detection
 
-    bool ltemReset = true;
-    if (QBG_isPowerOn())
-    {
-        if (resetAction == resetAction_skipIfOn)
-            ltemReset = false;
-        else
-        {
-            if (resetAction == resetAction_swReset)
-            {
-                if (!SC16IS7xx_isAvailable())
-                    resetAction = resetAction_powerReset;
-                SC16IS7xx_start();                                          // NXP SPI-UART bridge may/may not be baseline operational, initialize base: baud, framing
-            }
-            QBG_reset(resetAction);                                         // do requested reset (sw, hw, pwrCycle)
-        }
-    }
-    else 
-    {
-       QBG_powerOn();                                                       // turn on BGx
-    }
-    S__initLTEmDevice(ltemReset);
+    S__startBegin(resetAction);
 }
 
 
 /**
- *	@brief Static internal BGx initialization logic shared between start and reset
+ *	@brief Get the current state of the LTEm start sequence.
  */
-void S__initLTEmDevice(bool ltemReset)
+startState_t ltem_getStartState()
 {
-    ASSERT(QBG_isPowerOn());
-    ASSERT(SC16IS7xx_isAvailable());
-
-    SC16IS7xx_start();                                      // initialize NXP SPI-UART bridge base functions: FIFO, levels, baud, framing
-
-    if (ltemReset)
-    {
-        if (IOP_awaitAppReady())
-        {
-            PRINTF(dbgColor__info, "AppRdy recv'd\r");
-        }
-        else
-        {
-            if (g_lqLTEM.deviceState == deviceState_powerOn)
-            {
-                PRINTF(dbgColor__warn, "AppRdy timeout\r");
-                g_lqLTEM.deviceState = deviceState_appReady;        // missed it somehow
-            }
+    return g_lqLTEM.startCtrl.state;
+}
 
-        }
-    }
-    else
-    {
-        g_lqLTEM.deviceState = deviceState_appReady;        // assume device state = appReady, APP RDY sent in 1st ~10 seconds of BGx running
-        PRINTF(dbgColor__info, "LTEm ON (AppRdy)\r");
-    }
 
-    IOP_attachIrq();                                        // attach I/O processor ISR to IRQ
-    SC16IS7xx_enableIrqMode();                              // enable IRQ generation on SPI-UART bridge (IRQ mode)
-    QBG_setOptions();                                       // initialize BGx operating settings
-    NTWK_initRatOptions();                                  // initialize BGx Radio Access Technology (RAT) options
-    NTWK_applyDefaulNetwork();                              // configures default PDP context for likely autostart with provider attach
-    ntwk_awaitProvider(2);                                  // attempt to warm-up provider/PDP briefly. If longer duration required, leave that to application
+/**
+ *	@brief Registers the address (void*) of your application start progress callback handler.
+ */
+void ltem_setStartProgressCallback(startProgress_func progressCallback)
+{
+    g_lqLTEM.startCtrl.progressCB = progressCallback;
 }
 
 
@@ -279,7 +258,8 @@ void S__initLTEmDevice(bool ltemReset)
 void ltem_stop()
 {
     spi_stop(g_lqLTEM.spi);
-    IOP_stopIrq();
+    IOP_detachIrq();
+    g_lqLTEM.startCtrl.state = startState_idle;
     g_lqLTEM.deviceState = deviceState_powerOff;
     QBG_powerOff();
 }
@@ -290,8 +270,7 @@ void ltem_stop()
  */
 void ltem_reset(bool hardReset)
 {
-    QBG_reset(hardReset);                                           // reset module, indirectly SPI/UART (CFUNC or reset pin)
-    S__initLTEmDevice(false);
+    LTEM_restart(hardReset ? resetAction_hwReset : resetAction_swReset);      // reset module, indirectly SPI/UART (CFUNC or reset pin)
 }
 
 
@@ -304,6 +283,15 @@ const char *ltem_getSwVersion()
 }
 
 
+/**
+ *	@brief Get the module type of the LTEm device's BGx, identified during start.
+ */
+const char *ltem_getModuleType()
+{
+    return QBG_getModuleType();
+}
+
+
 /**
  *	@brief Performs a HW reset of LTEm1 and optionally executes start sequence.
  */
@@ -323,6 +311,35 @@ deviceState_t ltem_getDeviceState()
  */
 void ltem_eventMgr()
 {
+    if (g_lqLTEM.startCtrl.state != startState_idle && 
+        g_lqLTEM.startCtrl.state != startState_ready && 
+        g_lqLTEM.startCtrl.state != startState_failed)
+    {
+        S__startDoWork();                                                           // async start underway, no streams to service yet
+        return;
+    }
+
+    if (QBG_checkUnexpectedPowerChange())                                           // status pin ISR detected BGx power loss or restart
+    {
+        #if LTEMC_ENABLE_HEALTH
+        if (g_lqLTEM.health.enabled && !g_lqLTEM.health.isBusy)
+            health_recover(recoveryLevel_swReset);                                  // BGx state lost, restart and reopen streams
+        #endif
+        return;
+    }
+    #if LTEMC_ENABLE_HEALTH
+    HEALTH_doWork();                                                                // liveness probe (if enabled and due)
+    #endif
+    #if LTEMC_ENABLE_TIME
+    TIME_doWork();                                                                  // time resync (if enabled and due)
+    #endif
+
+    for (size_t i = 0; i < ltem__doWorkerCnt; i++)                                  // optional module background workers
+    {
+        if (g_lqLTEM.doWorkers[i] != NULL && !ATCMD_isLockActive() && !ATCMD_isLockPending())  // not ahead of a queued requester
+            (g_lqLTEM.doWorkers[i])();
+    }
+
     /* look for a new incoming URC 
      */
     int16_t urcPossible = cbffr_find(g_lqLTEM.iop->rxBffr, "+", 0, 0, false);       // look for prefix char in URC
@@ -330,10 +347,11 @@ void ltem_eventMgr()
     {
         return;
     }
+    ATCMD_observeUrc(urcPossible);                                                  // cache invalidation sees URC before a handler consumes it
 
+    resultCode_t serviceRslt = resultCode__cancelled;
     for (size_t i = 0; i < ltem__streamCnt; i++)                                    // potential URC in rxBffr, see if a data handler will service
     {
-        resultCode_t serviceRslt;
         if (g_lqLTEM.streams[i] != NULL &&  g_lqLTEM.streams[i]->urcHndlr != NULL)  // URC event handler in this stream, offer the data to the handler
         {
             serviceRslt = g_lqLTEM.streams[i]->urcHndlr();
@@ -345,6 +363,12 @@ void ltem_eventMgr()
         break;                                                                      // service attempted (might have errored), so this event is over
     }
 
+    for (size_t i = 0; i < ltem__urcHandlersCnt && serviceRslt == resultCode__cancelled; i++)
+    {
+        if (g_lqLTEM.urcHandlers[i] != NULL)                                        // not a stream URC, offer to registered module handlers
+            serviceRslt = (g_lqLTEM.urcHandlers[i])();
+    }
+
     // S__ltemUrcHandler();                                                            // always invoke system level URC validation/service
 }
 
@@ -368,7 +392,7 @@ void ltem_deleteStream(streamCtrl_t *streamCtrl)
 {
     for (size_t i = 0; i < ltem__streamCnt; i++)
     {
-        if (g_lqLTEM.streams[i]->dataCntxt == streamCtrl->dataCntxt)
+        if (g_lqLTEM.streams[i] != NULL && g_lqLTEM.streams[i]->dataCntxt == streamCtrl->dataCntxt)
         {
             ASSERT(memcmp(g_lqLTEM.streams[i], streamCtrl, sizeof(streamCtrl_t)) == 0);     // compare the common fields
             g_lqLTEM.streams[i] = NULL;
@@ -382,7 +406,7 @@ streamCtrl_t* ltem_getStreamFromCntxt(uint8_t context, streamType_t streamType)
 {
     for (size_t i = 0; i < ltem__streamCnt; i++)
     {
-        if (g_lqLTEM.streams[i]->dataCntxt == context)
+        if (g_lqLTEM.streams[i] != NULL && g_lqLTEM.streams[i]->dataCntxt == context)
         {
             if (streamType == streamType__ANY)
             {
@@ -439,24 +463,85 @@ void ltem_setYieldCallback(platform_yieldCB_func_t yieldCallback)
 #pragma region LTEmC Internal Functions (ltemc-internal.h)
 /*-----------------------------------------------------------------------------------------------*/
 
-// void LTEM_registerUrcHandler(urcHandler_func *urcHandler)
-// {
-//     bool registered = false;
-//     for (size_t i = 0; i < ltem__urcHandlersCnt; i++)
-//     {
-//         if (g_lqLTEM.urcHandlers[i] == NULL)
-//         {
-//             registered = true;
-//             g_lqLTEM.urcHandlers[i] = urcHandler;                               // add to "registered" handlers
-//         }
-//         else
-//         {
-//             if (g_lqLTEM.urcHandlers[i] == urcHandler)                          // previously registered
-//                 registered = true;
-//         }
-//         ASSERT(registered);
-//     }
-// }
+/**
+ *	@brief Restart BGx with the requested reset action and drive the start sequence to completion (blocking).
+ */
+void LTEM_restart(resetAction_t resetAction)
+{
+    S__startBegin(resetAction);
+
+    while (g_lqLTEM.startCtrl.state != startState_ready && g_lqLTEM.startCtrl.state != startState_failed)
+    {
+        S__startDoWork();
+        pYield();
+    }
+}
+
+
+/**
+ *	@brief Register an optional module background worker, invoked from ltem_eventMgr() when no command is underway.
+ */
+void LTEM_registerDoWorker(doWork_func doWorker)
+{
+    for (size_t i = 0; i < ltem__doWorkerCnt; i++)
+    {
+        if (g_lqLTEM.doWorkers[i] == doWorker)                                      // previously registered
+            return;
+    }
+    for (size_t i = 0; i < ltem__doWorkerCnt; i++)
+    {
+        if (g_lqLTEM.doWorkers[i] == NULL)
+        {
+            g_lqLTEM.doWorkers[i] = doWorker;                                       // add to "registered" workers
+            return;
+        }
+    }
+    ASSERT(false);                                                                  // no worker slot available
+}
+
+/**
+ *	@brief Register an optional module URC handler, offered URCs not serviced by a stream.
+ */
+void LTEM_registerUrcHandler(urcEvntHndlr_func urcHandler)
+{
+    for (size_t i = 0; i < ltem__urcHandlersCnt; i++)
+    {
+        if (g_lqLTEM.urcHandlers[i] == urcHandler)                                  // previously registered
+            return;
+    }
+    for (size_t i = 0; i < ltem__urcHandlersCnt; i++)
+    {
+        if (g_lqLTEM.urcHandlers[i] == NULL)
+        {
+            g_lqLTEM.urcHandlers[i] = urcHandler;                                   // add to "registered" handlers
+            return;
+        }
+    }
+    ASSERT(false);                                                                  // no handler slot available
+}
+
+
+/**
+ *	@brief Reopen registered streams via their recover handler (BGx restart, or LTE data resumed after a GNSS window).
+ */
+void LTEM_reestablishStreams()
+{
+    for (size_t i = 0; i < ltem__streamCnt; i++)
+    {
+        streamCtrl_t *streamCtrl = g_lqLTEM.streams[i];
+        if (streamCtrl == NULL || streamCtrl->recoverHndlr == NULL)
+            continue;
+
+        g_lqLTEM.streams[i] = NULL;                                                 // stream open re-adds stream to streams table
+        resultCode_t rslt = (*streamCtrl->recoverHndlr)(streamCtrl);
+        PRINTF(dbgColor__info, "Stream %c:%d reopen=%d\r", streamCtrl->streamType, streamCtrl->dataCntxt, rslt);
+
+        if (ltem_getStreamFromCntxt(streamCtrl->dataCntxt, streamType__ANY) == NULL)
+            g_lqLTEM.streams[i] = streamCtrl;                                       // handler did not re-add (failed or returned early), keep registered
+        if (rslt != resultCode__success)
+            ltem_notifyApp(appEvent_fault_softLogic, "Stream reopen failed");       // application can retry
+    }
+}
 
 // uint8_t LTEM__getStreamIndx(dataCntxt_t dataCntxt)
 // {
@@ -474,6 +559,374 @@ void ltem_setYieldCallback(platform_yieldCB_func_t yieldCallback)
 
 #pragma region Static Function Definitions
 
+/**
+ * @brief Initialize the start sequence controls and select the 1st state based on BGx power state and requested reset action
+ */
+static void S__startBegin(resetAction_t resetAction)
+{
+    g_lqLTEM.startCtrl.resetAction = resetAction;
+    g_lqLTEM.startCtrl.ltemReset = true;
+    g_lqLTEM.startCtrl.isBusy = false;
+    g_lqLTEM.startCtrl.startedAt = pMillis();
+    QBG_expectPowerChange(true);
+
+    if (QBG_isPowerOn())
+    {
+        if (resetAction == resetAction_skipIfOn)
+        {
+            g_lqLTEM.startCtrl.ltemReset = false;
+            S__startSetState(startState_awaitAppReady);
+        }
+        else if (resetAction == resetAction_swReset)
+        {
+            if (SC16IS7xx_isAvailable())
+            {
+                SC16IS7xx_start();                                          // NXP SPI-UART bridge may/may not be baseline operational, initialize base: baud, framing
+                SC16IS7xx_sendBreak();
+
+                char cmdData[] = "AT+CFUN=1,1\r";                           // DMA SPI DMA may not tolerate Flash source
+                IOP_startTx(cmdData, sizeof(cmdData));                      // soft-reset command: performs a module internal HW reset and cold-start
+                S__startSetState(startState_awaitPowerOff);
+            }
+            else
+            {
+                g_lqLTEM.startCtrl.resetAction = resetAction_powerReset;
+                S__startSetState(startState_powerKeyOff);
+            }
+        }
+        else if (resetAction == resetAction_hwReset)
+        {
+            S__startSetState(startState_resetPulse);
+        }
+        else
+        {
+            S__startSetState(startState_powerKeyOff);
+        }
+    }
+    else
+    {
+        g_lqLTEM.deviceState = deviceState_powerOff;
+        S__startSetState(startState_powerKeyOn);
+    }
+}
+
+
+/**
+ * @brief Advance the start sequence, each invoke performs only short (non-waiting) work
+ */
+static void S__startDoWork()
+{
+    if (g_lqLTEM.startCtrl.isBusy)                                          // atcmd result polls call back into eventMgr
+        return;
+    g_lqLTEM.startCtrl.isBusy = true;
+
+    uint32_t stateElapsed = pMillis() - g_lqLTEM.startCtrl.stateAt;
+
+    switch (g_lqLTEM.startCtrl.state)
+    {
+        case startState_powerKeyOn:
+            if (stateElapsed >= QBG_getModuleCaps()->powerOnDelay)
+            {
+                platform_writePin(g_lqLTEM.pinConfig.powerkeyPin, gpioValue_low);
+                S__startSetState(startState_awaitPowerOn);
+            }
+            break;
+
+        case startState_powerKeyOff:
+            if (stateElapsed >= QBG_getModuleCaps()->powerOffDelay)
+            {
+                platform_writePin(g_lqLTEM.pinConfig.powerkeyPin, gpioValue_low);
+                S__startSetState(startState_awaitPowerOff);
+            }
+            break;
+
+        case startState_resetPulse:
+            if (stateElapsed >= QBG_getModuleCaps()->resetPulseDelay)
+            {
+                platform_writePin(g_lqLTEM.pinConfig.resetPin, gpioValue_low);
+                PRINTF(dbgColor__white, "LTEm hwReset\r");
+                S__startSetState(startState_awaitPowerOff);                 // reset drops STATUS, then BGx restarts
+            }
+            break;
+
+        case startState_awaitPowerOff:
+            if (!QBG_isPowerOn() || 
+                (g_lqLTEM.statusMon.isAttached && (int32_t)(g_lqLTEM.statusMon.lastOffAt - g_lqLTEM.startCtrl.stateAt) >= 0))    // OFF edge seen, may already be back ON
+            {
+                if (g_lqLTEM.startCtrl.resetAction == resetAction_swReset || g_lqLTEM.startCtrl.resetAction == resetAction_hwReset)
+                {
+                    S__startSetState(startState_awaitPowerOn);              // CFUN=1,1 and reset pin restart BGx on their own
+                }
+                else
+                {
+                    S__startSetState(startState_powerKeyOn);
+                }
+            }
+            else if (stateElapsed > ltem__startPowerTimeout)
+            {
+                PRINTF(dbgColor__warn, "LTEm reset:OFF timeout\r");
+                if (g_lqLTEM.startCtrl.resetAction == resetAction_swReset || g_lqLTEM.startCtrl.resetAction == resetAction_hwReset)
+                {
+                    g_lqLTEM.startCtrl.resetAction = resetAction_powerReset; // escalate to power-cycle reset
+                    S__startSetState(startState_powerKeyOff);
+                }
+                else
+                {
+                    S__startSetState(startState_failed);
+                }
+            }
+            break;
+
+        case startState_awaitPowerOn:
+            if (QBG_isPowerOn())
+            {
+                S__startSetState(startState_awaitAppReady);
+            }
+            else if (stateElapsed > ltem__startPowerTimeout)
+            {
+                PRINTF(dbgColor__warn, "LTEm power ON timeout\r");
+                S__startSetState(startState_failed);
+            }
+            break;
+
+        case startState_awaitAppReady:
+            if (!g_lqLTEM.startCtrl.ltemReset)
+            {
+                g_lqLTEM.deviceState = deviceState_appReady;                // assume device state = appReady, APP RDY sent in 1st ~10 seconds of BGx running
+                PRINTF(dbgColor__info, "LTEm ON (AppRdy)\r");
+                S__startSetState(startState_setOptions);
+            }
+            else if (CBFFR_FOUND(cbffr_find(g_lqLTEM.iop->rxBffr, "APP RDY", 0, 0, false)))
+            {
+                PRINTF(dbgColor__info, "AppRdy @ %lums\r", stateElapsed);
+                IOP_resetRxBuffer();                                        // discard BGx boot chatter
+                g_lqLTEM.deviceState = deviceState_appReady;
+                S__startSetState(startState_setOptions);
+            }
+            else if (stateElapsed > ltem__startAppRdyTimeout)
+            {
+                PRINTF(dbgColor__warn, "AppRdy timeout\r");
+                g_lqLTEM.deviceState = deviceState_appReady;                // missed it somehow
+                S__startSetState(startState_setOptions);
+            }
+            break;
+
+        case startState_setOptions:                                         // BGx start script then module identify, one command per pass
+        {
+            const char *initCmd = QBG_getInitCmd(g_lqLTEM.startCtrl.step);
+            resultCode_t rslt;
+            if (initCmd != NULL)
+            {
+                rslt = S__startCmdStep(ltem__startInitCmdTimeout, initCmd);  // somewhat unknown cmd list for modem initialization, relax timeout
+                if (rslt == resultCode__success)
+                {
+                    PRINTF(dbgColor__none, " > %s\r", initCmd);
+                    g_lqLTEM.startCtrl.step++;
+                }
+                else if (rslt != resultCode__unknown)
+                {
+                    PRINTF(dbgColor__error, "BGx Init CmdError: %s\r", initCmd);
+                    if (++g_lqLTEM.startCtrl.tries < 2)
+                    {
+                        IOP_forceTx("\x1B", 1);                             // BGx may be sitting in data state (awaiting end-of-transmission), rerun script
+                        g_lqLTEM.startCtrl.step = 0;
+                    }
+                    else
+                    {
+                        S__startSetState(startState_failed);
+                    }
+                }
+            }
+            else
+            {
+                rslt = S__startCmdStep(atcmd__defaultTimeout, "ATI");       // select module timing and capabilities
+                if (rslt != resultCode__unknown)
+                {
+                    QBG_selectModule((rslt == resultCode__success) ? atcmd_getResponse() : NULL);
+                    S__startSetState(startState_networkConfig);
+                }
+            }
+            break;
+        }
+
+        case startState_networkConfig:                                      // RAT options and default PDP context, one command per pass
+        {
+            char cmdBffr[ltem__startCmdBffrSz];
+            if (!NTWK_getStartCmd(g_lqLTEM.startCtrl.step, cmdBffr, sizeof(cmdBffr)))
+            {
+                S__startSetState(startState_awaitProvider);
+            }
+            else if (cmdBffr[0] == '\0')
+            {
+                g_lqLTEM.startCtrl.step++;                                  // setting not configured
+            }
+            else
+            {
+                resultCode_t rslt = S__startCmdStep(atcmd__defaultTimeout, cmdBffr);
+                if (rslt != resultCode__unknown)
+                {
+                    if (rslt != resultCode__success)
+                    {
+                        PRINTF(dbgColor__cyan, "NtwkConfig Failed=%d: %s\r", rslt, cmdBffr);
+                    }
+                    g_lqLTEM.startCtrl.step++;
+                }
+            }
+            break;
+        }
+
+        case startState_awaitProvider:
+            S__startAwaitProvider(stateElapsed);
+            break;
+
+        default:
+            break;
+    }
+    g_lqLTEM.startCtrl.isBusy = false;
+}
+
+
+/**
+ * @brief Transition the start sequence to a new state, performing state entry actions and notifying application of progress
+ */
+static void S__startSetState(startState_t newState)
+{
+    g_lqLTEM.startCtrl.state = newState;
+    g_lqLTEM.startCtrl.stateAt = pMillis();
+    g_lqLTEM.startCtrl.step = 0;
+    g_lqLTEM.startCtrl.cmdPending = false;
+
+    switch (newState)
+    {
+        case startState_powerKeyOn:
+            PRINTF(dbgColor__none, "Powering LTEm On...\r");
+            platform_writePin(g_lqLTEM.pinConfig.powerkeyPin, gpioValue_high);     // toggle powerKey pin to power on/off
+            break;
+
+        case startState_powerKeyOff:
+            PRINTF(dbgColor__none, "Powering LTEm Off...\r");
+            platform_writePin(g_lqLTEM.pinConfig.powerkeyPin, gpioValue_high);
+            break;
+
+        case startState_resetPulse:
+            platform_writePin(g_lqLTEM.pinConfig.resetPin, gpioValue_high);        // hardware reset: reset pin (LTEm inverts)
+            break;
+
+        case startState_awaitAppReady:
+            QBG_expectPowerChange(false);                                           // BGx power state settled, further edges are faults
+            ASSERT(SC16IS7xx_isAvailable());
+            IOP_resetRxBuffer();
+            SC16IS7xx_start();                                                      // initialize NXP SPI-UART bridge base functions: FIFO, levels, baud, framing
+            IOP_attachIrq();                                                        // attach I/O processor ISR to IRQ, APP RDY arrives through RX buffer
+            SC16IS7xx_enableIrqMode();                                              // enable IRQ generation on SPI-UART bridge (IRQ mode)
+            break;
+
+        case startState_setOptions:
+            PRINTF(dbgColor__none, "BGx Init:\r");
+            g_lqLTEM.startCtrl.tries = 0;
+            break;
+
+        case startState_awaitProvider:
+            g_lqLTEM.startCtrl.providerCheckAt = 0;
+            break;
+
+        case startState_ready:
+            g_lqLTEM.deviceState = deviceState_appReady;
+            PRINTF(dbgColor__info, "LTEm start complete @ %lums\r", pMillis() - g_lqLTEM.startCtrl.startedAt);
+            ltem_notifyApp(ltem__appEventStartReady, "LTEm ready");         // explicit ready notice, apps without a progress callback
+            break;
+
+        case startState_failed:
+            QBG_expectPowerChange(false);
+            ltem_notifyApp(appEvent_fault_hardFault, "LTEm start failed");
+            break;
+
+        default:
+            break;
+    }
+
+    if (g_lqLTEM.startCtrl.progressCB != NULL)
+        (g_lqLTEM.startCtrl.progressCB)(newState, pMillis() - g_lqLTEM.startCtrl.startedAt);
+}
+
+
+/**
+ * @brief Advance a start step command without waiting, sent when the lock is available and the result polled on following passes
+ * @return resultCode__unknown while the command is unsent or pending, otherwise the command result
+ */
+static resultCode_t S__startCmdStep(uint32_t timeoutMS, const char *cmdStr)
+{
+    if (!g_lqLTEM.startCtrl.cmdPending)
+    {
+        g_lqLTEM.startCtrl.cmdPending = ATCMD_tryInvokeNoWait(timeoutMS, cmdStr);
+        return resultCode__unknown;
+    }
+
+    resultCode_t rslt = ATCMD_pollResult();
+    if (rslt != resultCode__unknown)
+        g_lqLTEM.startCtrl.cmdPending = false;
+    return rslt;
+}
+
+
+/**
+ * @brief Brief provider warm-up (AT+COPS? polled), if registered collects provider networks and addresses, one command per pass
+ */
+static void S__startAwaitProvider(uint32_t stateElapsed)
+{
+    resultCode_t rslt;
+    if (g_lqLTEM.startCtrl.step == 0)                                       // provider check
+    {
+        if (!g_lqLTEM.startCtrl.cmdPending && pMillis() - g_lqLTEM.startCtrl.providerCheckAt < ltem__startProviderPoll)
+            return;
+
+        rslt = S__startCmdStep(atcmd__defaultTimeout, "AT+COPS?");
+        if (rslt == resultCode__unknown)
+            return;
+
+        g_lqLTEM.startCtrl.providerCheckAt = pMillis();
+        if (rslt == resultCode__success && NTWK_parseProvider(atcmd_getResponse()))   // +COPS: 0,0,"provider",8 when registered
+            g_lqLTEM.startCtrl.step++;
+        else if (stateElapsed >= ltem__startProviderWarmup)                 // if longer duration required, leave that to application
+            S__startSetState(startState_ready);
+    }
+    else if (g_lqLTEM.startCtrl.step == 1)                                  // provider networks (PDP contexts)
+    {
+        rslt = S__startCmdStep(ltem__startNtwkInfoTimeout, "AT+CGACT?");
+        if (rslt == resultCode__unknown)
+            return;
+
+        if (rslt == resultCode__success)
+            NTWK_parseNetworks(atcmd_getResponse());
+        g_lqLTEM.startCtrl.step++;
+    }
+    else                                                                    // network addresses, AT+CGPADDR requires the context ID over serial
+    {
+        uint8_t ntwkIndx = g_lqLTEM.startCtrl.step - 2;
+        if (ntwkIndx >= g_lqLTEM.providerInfo->networkCnt)
+        {
+            S__startSetState(startState_ready);
+            return;
+        }
+        if (!g_lqLTEM.providerInfo->networks[ntwkIndx].isActive)
+        {
+            g_lqLTEM.startCtrl.step++;
+            return;
+        }
+
+        char cmdBffr[ltem__startCmdBffrSz];
+        snprintf(cmdBffr, sizeof(cmdBffr), "AT+CGPADDR=%d", g_lqLTEM.providerInfo->networks[ntwkIndx].pdpContextId);
+        rslt = S__startCmdStep(atcmd__defaultTimeout, cmdBffr);
+        if (rslt == resultCode__unknown)
+            return;
+
+        if (rslt == resultCode__success)
+            NTWK_parseNetworkAddress(ntwkIndx, atcmd_getResponse());
+        g_lqLTEM.startCtrl.step++;
+    }
+}
+
+
 /**
  * @brief Global URC handler
  * @details Services URC events that are not specific to a stream/protocol
@@ -44,12 +44,19 @@
 #include "ltemc-atcmd.h"                        /// command processor interface
 #include "ltemc-mdminfo.h"                      /// modem information
 #include "ltemc-network.h"                      /// cellular provider and packet network 
+#include "ltemc-health.h"                       /// liveness probes and escalating recovery
+#include "ltemc-time.h"                         /// network time service, cached UTC clock
 
 /* Add the following LTEmC feature sets as required for your project
 */
 // #include "ltemc-gnss.h"                         /// GNSS/GPS location services
+// #include "ltemc-gnss-assist.h"                  /// GNSS XTRA assistance (requires http, files)
+// #include "ltemc-gnss-share.h"                   /// GNSS/LTE time-sharing for single radio modules
+// #include "ltemc-track.h"                        /// location track batching and compact encoding
+// #include "ltemc-geofence.h"                     /// host geofence engine (many fences, grid indexed)
 // #include "ltemc-sckt.h"                         /// tcp/udp socket communications
 // #include "ltemc-tls"                            /// SSL/TLS support
+// #include "ltemc-certs.h"                        /// certificate store on BGx UFS (requires tls, files)
 // #include "ltemc-http"                           /// HTTP(S) support: GET/POST requests
 // #include "ltemc-mqtt"                           /// MQTT(S) support
 // #include "ltemc-filesys.h"                      /// use of BGx module file system functionality
@@ -124,6 +131,30 @@ void ltem_setDefaultNetwork(uint8_t pdpContextId, const char *protoType, const c
 void ltem_start(resetAction_t resetAction);
 
 
+/**
+ *	\brief Power on and start the modem without blocking. The start sequence is advanced by ltem_eventMgr(), which must be invoked regularly.
+ *  \details Progress is reported through the start progress callback (see ltem_setStartProgressCallback()), startState_ready signals
+ *  the device is ready for application use. Start complete is also notified through the application notify callback (ltem__appEventStartReady).
+ *  Start commands are sent and their results polled one per pass, ltem_eventMgr() does not wait on BGx responses during start.
+ *  \param resetAction [in] Action to take if the modem is found in a powered on state
+ */
+void ltem_startAsync(resetAction_t resetAction);
+
+
+/**
+ *	\brief Get the current state of the LTEm start sequence.
+ *  \return Start state, startState_ready when start has completed
+ */
+startState_t ltem_getStartState();
+
+
+/**
+ *	\brief Registers the address (void*) of your application start progress callback handler.
+ *  \param progressCallback [in] Callback function in application code to be invoked on each start sequence state change.
+ */
+void ltem_setStartProgressCallback(startProgress_func progressCallback);
+
+
 /**
  *	\brief Powers off the modem without destroying memory objects. Power modem back on with ltem_start()
  */
@@ -149,6 +180,13 @@ void ltem_reset(bool hardReset);
 const char *ltem_getSwVersion();
 
 
+/**
+ *	\brief Get the module type of the LTEm device's BGx, identified during start.
+ *  \return Module type as a c-string (ex: BG96, BG95-M3, BG77), empty if not yet identified.
+ */
+const char *ltem_getModuleType();
+
+
 /**
  *	\brief Reads the hardware status and internal application ready field to return device ready state
  *  \return DeviceState: 0=power off, 1=power on, 2=appl ready
@@ -0,0 +1,142 @@
+/******************************************************************************
+ *  \file atcmd-format-bench.c
+ *  \author Greg Terrell
+ *  \license MIT License
+ *
+ *  Copyright (c) 2020 LooUQ Incorporated.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+ * "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ * LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ******************************************************************************
+ * Host benchmark: AT command formatting, atcmd_tryInvoke() (vsnprintf) vs
+ * atcmd_tryInvokeFmt() (fixed format typed emitters) for the hot data path
+ * commands. IOP transmit is stubbed, so the timing difference is the command
+ * build (reset, format, mirror) cost. Emitted commands are compared for equality.
+ * 
+ * Build (LooUQ-Common headers required):
+ *   cc -O2 -I../../src -I<LooUQ-Common>/src atcmd-format-bench.c -o atcmd-format-bench
+ * 
+ * vsnprintf() cost is library dependent (newlib-nano on most targets), compare
+ * cycle counts on a Cortex-M0+ target for representative results.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <time.h>
+#include "../../src/ltemc-atcmd.c"
+
+ltemDevice_t g_lqLTEM;
+static atcmd_t atcmd;
+static iop_t iop;
+
+/* IOP, buffer and platform stubs, response side of atcmd is not under test
+ */
+void IOP_startTx(const char *sendData, uint16_t sendSz) { }
+uint16_t cbffr_getOccupied(cBuffer_t *cbuf) { return 0; }
+int16_t cbffr_find(cBuffer_t *cbuf, const char *needle, uint16_t searchOffset, uint16_t searchLength, bool moveTail) { return -1; }
+uint16_t cbffr_pop(cBuffer_t *cbuf, char *dest, uint16_t requestSz) { return 0; }
+void cbffr_skipTail(cBuffer_t *cbuf, uint16_t skipSz) { }
+void ltem_eventMgr() { }
+deviceState_t ltem_getDeviceState() { return deviceState_appReady; }
+void ltem_notifyApp(uint8_t notifyType, const char *notifyMsg) { }
+bool SC16IS7xx_isAvailable() { return true; }
+uint32_t pMillis() { return 0; }
+bool pElapsed(uint32_t start, uint32_t timeout) { return false; }
+void pYield() { }
+void pDelay(uint32_t delay) { }
+void lDelay(uint32_t delay) { }
+
+
+#define ITERATIONS 1000000
+
+static double elapsedNs(struct timespec *start)
+{
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) * 1e9 + (end.tv_nsec - start->tv_nsec);
+}
+
+
+static const char *topic = "devices/lq-bench-0001/messages/events/";
+
+/* one pass of the hot commands, each path
+ */
+static void invokeVsnprintf(int i)
+{
+    atcmd_tryInvoke("AT+QISEND=%d,%d", 1, i & 0x3FF);          atcmd_close();
+    atcmd_tryInvoke("AT+QIRD=%d,%d", 1, 1000);                 atcmd_close();
+    atcmd_tryInvoke("AT+QMTPUB=%d,%d,%d,0,\"%s\",%d", 5, i & 0xFFFF, 1, topic, 256);  atcmd_close();
+    atcmd_tryInvoke("AT+QFWRITE=%d,%d", 3, 512);               atcmd_close();
+    atcmd_tryInvoke("AT+QFREAD=%d,%d", 3, 512);                atcmd_close();
+    atcmd_tryInvoke("AT+QHTTPREAD=%d", 60);                    atcmd_close();
+}
+
+static void invokeFmt(int i)
+{
+    atcmd_tryInvokeFmt(atcmdFmt_qisend, 1, i & 0x3FF);         atcmd_close();
+    atcmd_tryInvokeFmt(atcmdFmt_qird, 1, 1000);                atcmd_close();
+    atcmd_tryInvokeFmt(atcmdFmt_qmtpub, 5, i & 0xFFFF, 1, 0, topic, 256);  atcmd_close();
+    atcmd_tryInvokeFmt(atcmdFmt_qfwrite, 3, 512);              atcmd_close();
+    atcmd_tryInvokeFmt(atcmdFmt_qfread, 3, 512);               atcmd_close();
+    atcmd_tryInvokeFmt(atcmdFmt_qhttpread, 60);                atcmd_close();
+}
+
+
+int main()
+{
+    struct timespec start;
+    char expected[atcmd__cmdBufferSz];
+
+    g_lqLTEM.atcmd = &atcmd;
+    g_lqLTEM.iop = &iop;
+
+    /* verify emitters produce the same commands
+     */
+    atcmd_tryInvoke("AT+QMTPUB=%d,%d,%d,0,\"%s\",%d", 5, 65535, 1, topic, 256);
+    strcpy(expected, atcmd.cmdStr);
+    atcmd_close();
+    atcmd_tryInvokeFmt(atcmdFmt_qmtpub, 5, 65535, 1, 0, topic, 256);
+    atcmd_close();
+    if (strcmp(expected, atcmd.cmdStr) != 0)
+    {
+        printf("MISMATCH: %s vs %s\n", expected, atcmd.cmdStr);
+        return 1;
+    }
+    atcmd_tryInvoke("AT+QISEND=%d,%d", 0, -12);
+    strcpy(expected, atcmd.cmdStr);
+    atcmd_close();
+    atcmd_tryInvokeFmt(atcmdFmt_qisend, 0, -12);
+    atcmd_close();
+    if (strcmp(expected, atcmd.cmdStr) != 0)
+    {
+        printf("MISMATCH: %s vs %s\n", expected, atcmd.cmdStr);
+        return 1;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < ITERATIONS; i++)
+        invokeVsnprintf(i);
+    double vsnprintfNs = elapsedNs(&start) / (ITERATIONS * 6.0);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < ITERATIONS; i++)
+        invokeFmt(i);
+    double fmtNs = elapsedNs(&start) / (ITERATIONS * 6.0);
+
+    printf("atcmd_tryInvoke():    %7.1f ns/cmd\n", vsnprintfNs);
+    printf("atcmd_tryInvokeFmt(): %7.1f ns/cmd\n", fmtNs);
+    return 0;
+}
@@ -0,0 +1,117 @@
+/******************************************************************************
+ *  \file gnss-parse-bench.c
+ *  \author Greg Terrell
+ *  \license MIT License
+ *
+ *  Copyright (c) 2020 LooUQ Incorporated.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+ * "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ * LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ******************************************************************************
+ * Host benchmark: gnss_getLocation() (response schema, double) vs 
+ * gnss_getLocationFix() (single-pass integer tokenizer). The IOP layer is 
+ * stubbed to receive a canned +QGPSLOC response through the AT command layer,
+ * so the timing difference is the parse path.
+ * 
+ * Build (LooUQ-Common headers required):
+ *   cc -O2 -I../../src -I<LooUQ-Common>/src gnss-parse-bench.c -o gnss-parse-bench
+ * 
+ * Soft-float cost is not visible on a host with an FPU, compare cycle counts on
+ * a Cortex-M0+ target for representative results. On an x86 host the two paths
+ * are within run-to-run noise (e.g. 505 vs 442 ns/call, ~1.1x), time is spent
+ * mostly in the AT command layer shared by both.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <time.h>
+#include "../../src/ltemc-atcmd.c"
+#include "../../src/ltemc-gnss.c"
+
+ltemDevice_t g_lqLTEM;
+static atcmd_t atcmd;
+static iop_t iop;
+
+static const char qgpslocResponse[] = "\r\n+QGPSLOC: 113355.0,44.74770,-85.56527,1.2,192.0,2,277.11,0.0,0.0,250420,10\r\n\r\nOK\r\n";
+static uint16_t rxTail = sizeof(qgpslocResponse) - 1;
+
+/* IOP, buffer and platform stubs: each command transmit "receives" the canned +QGPSLOC response
+ */
+void IOP_startTx(const char *sendData, uint16_t sendSz) { rxTail = 0; }
+uint16_t cbffr_getOccupied(cBuffer_t *cbuf) { return sizeof(qgpslocResponse) - 1 - rxTail; }
+uint16_t cbffr_pop(cBuffer_t *cbuf, char *dest, uint16_t requestSz)
+{
+    uint16_t popSz = MIN(requestSz, cbffr_getOccupied(cbuf));
+    memcpy(dest, qgpslocResponse + rxTail, popSz);
+    rxTail += popSz;
+    return popSz;
+}
+int16_t cbffr_find(cBuffer_t *cbuf, const char *needle, uint16_t searchOffset, uint16_t searchLength, bool moveTail) { return -1; }
+void cbffr_skipTail(cBuffer_t *cbuf, uint16_t skipSz) { }
+void ltem_eventMgr() { }
+deviceState_t ltem_getDeviceState() { return deviceState_appReady; }
+void ltem_notifyApp(uint8_t notifyType, const char *notifyMsg) { }
+bool SC16IS7xx_isAvailable() { return true; }
+void LTEM_registerDoWorker(doWork_func doWorker) { }
+uint32_t pMillis() { return 0; }
+bool pElapsed(uint32_t start, uint32_t timeout) { return false; }
+void pYield() { }
+void pDelay(uint32_t delay) { }
+void lDelay(uint32_t delay) { }
+
+
+#define ITERATIONS 1000000
+
+static double elapsedNs(struct timespec *start)
+{
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) * 1e9 + (end.tv_nsec - start->tv_nsec);
+}
+
+
+int main()
+{
+    struct timespec start;
+    volatile int32_t sink = 0;
+
+    g_lqLTEM.atcmd = &atcmd;
+    g_lqLTEM.iop = &iop;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+        gnssLocation_t location = gnss_getLocation();
+        sink += (int32_t)location.lat.val;
+    }
+    double floatNs = elapsedNs(&start) / ITERATIONS;
+
+    gnssFix_t fix;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+        gnss_getLocationFix(&fix);
+        sink += fix.latitude;
+    }
+    double fixedNs = elapsedNs(&start) / ITERATIONS;
+
+    gnssLocation_t location = gnss_getLocation();
+    printf("gnss_getLocation():    %7.1f ns/call  sizeof=%zu  lat=%f lon=%f utc=%s date=%s nsat=%d\n", 
+           floatNs, sizeof(gnssLocation_t), location.lat.val, location.lon.val, location.utc, location.date, location.nsat);
+    printf("gnss_getLocationFix(): %7.1f ns/call  sizeof=%zu  lat=%ld lon=%ld utc=%lu date=%lu nsat=%d\n", 
+           fixedNs, sizeof(gnssFix_t), (long)fix.latitude, (long)fix.longitude, (unsigned long)fix.utcMillis, (unsigned long)fix.date, fix.nsat);
+    return 0;
+}
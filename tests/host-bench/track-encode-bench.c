@@ -0,0 +1,186 @@
+/******************************************************************************
+ *  \file track-encode-bench.c
+ *  \author Greg Terrell
+ *  \license MIT License
+ *
+ *  Copyright (c) 2020 LooUQ Incorporated.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software. THE SOFTWARE IS PROVIDED
+ * "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ * LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ******************************************************************************
+ * Host benchmark: location track batching. A synthetic 1 hour, 1 Hz drive is fed
+ * through track_addFix() (decimation) and encoded with track_encode(). Reports
+ * bytes per fix for per-fix text publishes vs the delta/varint batch encoding,
+ * and encode time. The batch is decoded and checked against the ring contents.
+ * 
+ * Build (LooUQ-Common headers required), ltemc-gnss.c provides GNSS_distance(), its AT 
+ * command dependencies are unreferenced and dropped by --gc-sections:
+ *   cc -O2 -ffunction-sections -Wl,--gc-sections -I../../src -I<LooUQ-Common>/src track-encode-bench.c -lm -o track-encode-bench
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include "../../src/ltemc-track.c"
+#include "../../src/ltemc-gnss.c"
+
+/* date arithmetic (ltemc-time.c) is not under test
+ */
+uint32_t time_toEpoch(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second)
+{
+    return 1672531200 + ((uint32_t)day * 24 + hour) * 3600 + minute * 60 + second;
+}
+
+
+#define FIX_CNT 3600
+#define BATCH_SZ 1024
+
+static trackPoint_t points[FIX_CNT];
+static gnssFix_t fixes[FIX_CNT];
+
+
+static uint32_t getVarint(const uint8_t **src)
+{
+    uint32_t value = 0;
+    uint8_t shift = 0;
+    do
+    {
+        value |= (uint32_t)(**src & 0x7F) << shift;
+        shift += 7;
+    } while (*(*src)++ & 0x80);
+    return value;
+}
+
+static int32_t unzigzag(uint32_t value)
+{
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+
+/* decode batch and compare to ring points, returns points verified
+ */
+static uint16_t verifyBatch(trackCtrl_t *track, const uint8_t *bffr)
+{
+    const uint8_t *src = bffr + 1;
+    uint16_t cnt = getVarint(&src);
+    uint16_t tail = (track->head + track->capacity - track->count) % track->capacity;
+    trackPoint_t pt;
+
+    for (uint16_t i = 0; i < cnt; i++)
+    {
+        if (i == 0)
+        {
+            pt.time = getVarint(&src);
+            pt.latitude = unzigzag(getVarint(&src));
+            pt.longitude = unzigzag(getVarint(&src));
+            pt.altitude = unzigzag(getVarint(&src));
+            pt.speed = getVarint(&src);
+            pt.course = getVarint(&src);
+        }
+        else
+        {
+            pt.time += unzigzag(getVarint(&src));
+            pt.latitude += unzigzag(getVarint(&src));
+            pt.longitude += unzigzag(getVarint(&src));
+            pt.altitude += unzigzag(getVarint(&src));
+            pt.speed += unzigzag(getVarint(&src));
+            pt.course = (pt.course + unzigzag(getVarint(&src)) + 36000) % 36000;
+        }
+        if (memcmp(&pt, &track->points[(tail + i) % track->capacity], sizeof(trackPoint_t)) != 0)
+            return i;
+    }
+    return cnt;
+}
+
+
+int main()
+{
+    /* synthetic drive: 1 Hz, speed varies 0-25 m/s, gentle turns and a few sharp ones, stops
+     */
+    double lat = 44.747700, lon = -85.565270, heading = 45.0;
+    for (int i = 0; i < FIX_CNT; i++)
+    {
+        double speed = (i % 600 < 60) ? 0.0 : 12.5 + 12.5 * sin(i / 90.0);         // 1 minute stop every 10 minutes
+        heading += (i % 300 == 150) ? 90.0 : 0.5 * sin(i / 40.0);
+        heading = fmod(heading + 360.0, 360.0);
+        lat += speed * cos(heading * M_PI / 180.0) / 111320.0;
+        lon += speed * sin(heading * M_PI / 180.0) / (111320.0 * cos(lat * M_PI / 180.0));
+
+        fixes[i].utcMillis = (i % 86400) * 1000;
+        fixes[i].date = 10123;                                                      // 01/01/23
+        fixes[i].latitude = (int32_t)lrint(lat * 1e6);
+        fixes[i].longitude = (int32_t)lrint(lon * 1e6);
+        fixes[i].altitude = 1920 + (int32_t)(50 * sin(i / 300.0));
+        fixes[i].speed = (uint32_t)(speed * 100);
+        fixes[i].course = (uint16_t)(heading * 100);
+        fixes[i].valid = true;
+    }
+
+    /* baseline: one text publish per fix
+     */
+    uint32_t textBytes = 0;
+    char text[128];
+    for (int i = 0; i < FIX_CNT; i++)
+    {
+        textBytes += snprintf(text, sizeof(text), "{\"t\":%lu,\"lat\":%.6f,\"lon\":%.6f,\"alt\":%.1f,\"spd\":%.2f,\"crs\":%.2f}", 
+                              (unsigned long)(1672531200 + i), fixes[i].latitude / 1e6, fixes[i].longitude / 1e6, 
+                              fixes[i].altitude / 10.0, fixes[i].speed / 100.0, fixes[i].course / 100.0);
+    }
+    printf("text per fix:        %6lu bytes  %6.1f bytes/fix\n", (unsigned long)textBytes, (double)textBytes / FIX_CNT);
+
+    trackDecimation_t decimations[] = 
+    {
+        { 0, 0, 0, 0 },                                                             // every fix
+        { 1, 60, 25, 1500 },                                                        // 25m / 15 degree turn / 1 minute heartbeat
+        { 5, 120, 100, 3000 }
+    };
+
+    for (int d = 0; d < sizeof(decimations) / sizeof(trackDecimation_t); d++)
+    {
+        trackCtrl_t track;
+        uint8_t batch[BATCH_SZ];
+        uint32_t batchBytes = 0, batchCnt = 0, verified = 0;
+        double encodeNs = 0;
+
+        track_init(&track, points, FIX_CNT, &decimations[d]);
+        for (int i = 0; i < FIX_CNT; i++)
+        {
+            track_addFix(&track, &fixes[i]);
+        }
+        uint16_t kept = track_getCount(&track);
+
+        while (track_getCount(&track) > 0)
+        {
+            uint16_t pointCnt;
+            struct timespec start, end;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            uint16_t batchSz = track_encode(&track, batch, sizeof(batch), &pointCnt);
+            clock_gettime(CLOCK_MONOTONIC, &end);
+            encodeNs += (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+
+            verified += verifyBatch(&track, batch);
+            track_consume(&track, pointCnt);
+            batchBytes += batchSz;
+            batchCnt++;
+        }
+        printf("decimation %d,%d,%d,%d: kept %4u/%u  %5lu bytes in %lu batches  %5.2f bytes/fix  %5.2f bytes/point  %s  encode %.1f ns/point\n", 
+               decimations[d].minInterval, decimations[d].maxInterval, decimations[d].minDistance, decimations[d].minHeadingChange,
+               kept, FIX_CNT, (unsigned long)batchBytes, (unsigned long)batchCnt, (double)batchBytes / FIX_CNT, (double)batchBytes / kept, 
+               verified == kept ? "verified" : "MISMATCH", encodeNs / kept);
+    }
+    return 0;
+}